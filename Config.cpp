@@ -0,0 +1,369 @@
+#include <Config.h>
+
+// Schema builders
+constexpr ConfigKey ConfigBool(std::string_view name, std::string_view label, bool Config::* field) {
+    ConfigKey key{name, label, CONFIG_TYPE::BOOL};
+    key.boolField = field;
+    return key;
+}
+constexpr ConfigKey ConfigInt(std::string_view name, std::string_view label, int Config::* field, double min = -CONFIG_NO_LIMIT, double max = CONFIG_NO_LIMIT, bool minExclusive = false) {
+    ConfigKey key{name, label, CONFIG_TYPE::INT};
+    key.intField = field;
+    key.min = min;
+    key.max = max;
+    key.minExclusive = minExclusive;
+    return key;
+}
+constexpr ConfigKey ConfigFloat(std::string_view name, std::string_view label, float Config::* field, double min = -CONFIG_NO_LIMIT, double max = CONFIG_NO_LIMIT, bool minExclusive = false) {
+    ConfigKey key{name, label, CONFIG_TYPE::FLOAT};
+    key.floatField = field;
+    key.min = min;
+    key.max = max;
+    key.minExclusive = minExclusive;
+    return key;
+}
+constexpr ConfigKey ConfigFormID(std::string_view name, std::string_view label, std::uint32_t Config::* field) {
+    ConfigKey key{name, label, CONFIG_TYPE::FORMID};
+    key.formIDField = field;
+    return key;
+}
+constexpr ConfigKey ConfigFormIDList(std::string_view name, std::string_view label, std::vector<std::uint32_t> Config::* field) {
+    ConfigKey key{name, label, CONFIG_TYPE::FORMID_LIST};
+    key.listField = field;
+    return key;
+}
+// Sort the schema by name at compile time so lookups are a binary search
+template <std::size_t N>
+constexpr std::array<ConfigKey, N> SortConfigSchema(std::array<ConfigKey, N> keys) {
+    std::sort(keys.begin(), keys.end(), [](const ConfigKey& a, const ConfigKey& b) { return a.name < b.name; });
+    return keys;
+}
+
+// All INI keys, names are matched exactly (aliases keep older key names working)
+constexpr auto CONFIG_SCHEMA = SortConfigSchema(std::array{
+    // General
+    ConfigBool("debugging", "Debugging", &Config::DEBUGGING),
+    ConfigFloat("update_interval", "Update Interval", &Config::UPDATE_INTERVAL, 0.0, CONFIG_NO_LIMIT, true),
+    ConfigInt("ini_reload_interval", "INI Reload Interval", &Config::INI_RELOAD_INTERVAL, 0.0),
+    ConfigFloat("actor_search_radius", "Actor Search Radius", &Config::ACTOR_SEARCH_RADIUS, 0.0, CONFIG_NO_LIMIT, true),
+    ConfigFloat("frame_budget_ms", "Frame Budget", &Config::FRAME_BUDGET_MS, 0.0, CONFIG_NO_LIMIT, true),
+    // AI behavior
+    ConfigFloat("ai_health_threshold", "AI Health Threshold", &Config::AI_HEALTH_THRESHOLD, 0.0, 100.0),
+    ConfigBool("ai_use_stimpak", "AI Use Stimpak", &Config::AI_USE_STIMPAK),
+    ConfigBool("ai_use_stimpak_unlimited", "AI Use Stimpak Unlimited", &Config::AI_USE_STIMPAK_UNLIMITED),
+    ConfigBool("ai_auto_revive", "AI Auto Revive", &Config::AI_AUTO_REVIVE),
+    ConfigBool("ai_flee_combat", "AI Flee Combat", &Config::AI_FLEE_COMBAT),
+    ConfigFloat("ai_flee_distance", "AI Flee Distance", &Config::AI_FLEE_DISTANCE, 0.0, CONFIG_NO_LIMIT, true),
+    ConfigBool("ai_equip_items", "AI Equip Items", &Config::AI_EQUIP_ITEMS),
+    ConfigBool("ai_equip_gear", "AI Equip Gear", &Config::AI_EQUIP_GEAR),
+    ConfigBool("ai_equip_ammo_refill", "AI Equip Ammo Refill", &Config::AI_EQUIP_AMMO_REFILL),
+    ConfigInt("ai_equip_ammo_amount", "AI Equip Ammo Amount", &Config::AI_EQUIP_AMMO_AMOUNT, 0.0, CONFIG_NO_LIMIT, true),
+    ConfigInt("ai_equip_ammo_amount_automatic", "AI Equip Ammo Amount Automatic", &Config::AI_EQUIP_AMMO_AMOUNT_AUTOMATIC, 0.0, CONFIG_NO_LIMIT, true),
+    ConfigInt("ai_equip_score", "AI Equip Score", &Config::AI_EQUIP_SCORE, 0.0, 2.0),
+    // Movement
+    ConfigBool("ai_stuck_check", "AI Stuck Check", &Config::AI_STUCK_CHECK),
+    ConfigInt("ai_stuck_threshold", "AI Stuck Threshold", &Config::AI_STUCK_THRESHOLD, 0.0),
+    ConfigInt("ai_stuck_collisions", "AI Stuck Collisions", &Config::AI_STUCK_COLLISIONS, 0.0),
+    ConfigFloat("ai_stuck_speed", "AI Stuck Speed", &Config::AI_STUCK_SPEED, 0.0),
+    ConfigFloat("ai_stuck_distance", "AI Stuck Distance", &Config::AI_STUCK_DISTANCE, 0.0, CONFIG_NO_LIMIT, true),
+    // Aggression (the INI has always used AI_AGGRESSION_ENABLE)
+    ConfigBool("ai_aggression_enable", "AI Aggression Enabled", &Config::AI_AGGRESSION_ENABLED),
+    ConfigBool("ai_aggression_enabled", "AI Aggression Enabled", &Config::AI_AGGRESSION_ENABLED),
+    ConfigBool("ai_aggression_all", "AI Aggression All", &Config::AI_AGGRESSION_ALL),
+    ConfigBool("ai_aggression_sneak", "AI Aggression Sneak", &Config::AI_AGGRESSION_SNEAK),
+    ConfigFloat("ai_aggression_radius0", "AI Aggression Radius0", &Config::AI_AGGRESSION_RADIUS0, 0.0, CONFIG_NO_LIMIT, true),
+    ConfigFloat("ai_aggression_radius1", "AI Aggression Radius1", &Config::AI_AGGRESSION_RADIUS1, 0.0, CONFIG_NO_LIMIT, true),
+    ConfigFloat("ai_aggression_radius2", "AI Aggression Radius2", &Config::AI_AGGRESSION_RADIUS2, 0.0, CONFIG_NO_LIMIT, true),
+    // Chatter
+    ConfigBool("chatter_enabled", "Chatter Enabled", &Config::CHATTER_ENABLED),
+    ConfigFloat("chatter_multiplier", "Chatter Multiplier", &Config::CHATTER_MULTIPLIER, 0.0, CONFIG_NO_LIMIT, true),
+    ConfigFloat("chatter_multiplier_sneak", "Chatter Multiplier Sneak", &Config::CHATTER_MULTIPLIER_SNEAK, 0.0, CONFIG_NO_LIMIT, true),
+    // Combat AI
+    ConfigBool("combat_enabled", "Combat Enabled", &Config::COMBAT_ENABLED),
+    ConfigInt("combat_target", "Combat Target", &Config::COMBAT_TARGET, 0.0, 2.0),
+    ConfigFloat("combat_offensive", "Combat Offensive", &Config::COMBAT_OFFENSIVE, 0.0, 1.0),
+    ConfigFloat("combat_defensive", "Combat Defensive", &Config::COMBAT_DEFENSIVE, 0.0, 1.0),
+    ConfigFloat("combat_ranged", "Combat Ranged", &Config::COMBAT_RANGED, 0.0, 1.0),
+    ConfigFloat("combat_melee", "Combat Melee", &Config::COMBAT_MELEE, 0.0, 1.0),
+    ConfigFloat("combat_ranged_adjustment", "Combat Ranged Adjustment", &Config::COMBAT_RANGED_ADJUSTMENT),
+    ConfigFloat("combat_ranged_crouching", "Combat Ranged Crouching", &Config::COMBAT_RANGED_CROUCHING),
+    ConfigFloat("combat_ranged_strafe", "Combat Ranged Strafe", &Config::COMBAT_RANGED_STRAFE),
+    ConfigFloat("combat_ranged_waiting", "Combat Ranged Waiting", &Config::COMBAT_RANGED_WAITING),
+    ConfigFloat("combat_ranged_accuracy", "Combat Ranged Accuracy", &Config::COMBAT_RANGED_ACCURACY),
+    ConfigFloat("combat_close_fallback", "Combat Close Fallback", &Config::COMBAT_CLOSE_FALLBACK),
+    ConfigFloat("combat_close_circle", "Combat Close Circle", &Config::COMBAT_CLOSE_CIRCLE),
+    ConfigFloat("combat_close_disengage", "Combat Close Disengage", &Config::COMBAT_CLOSE_DISENGAGE),
+    ConfigFloat("combat_close_flank", "Combat Close Flank", &Config::COMBAT_CLOSE_FLANK),
+    ConfigInt("combat_close_throw_grenade", "Combat Close Throw Grenade", &Config::COMBAT_CLOSE_THROW_GRENADE),
+    ConfigFloat("combat_cover_distance", "Combat Cover Distance", &Config::COMBAT_COVER_DISTANCE),
+    // Loot
+    ConfigBool("loot_enabled", "Loot Enabled", &Config::LOOT_ENABLED),
+    ConfigBool("loot_combat", "Loot Combat", &Config::LOOT_COMBAT),
+    ConfigFloat("loot_radius", "Loot Radius", &Config::LOOT_RADIUS),
+    ConfigBool("loot_junk", "Loot Junk", &Config::LOOT_JUNK),
+    ConfigBool("loot_ammo", "Loot Ammo", &Config::LOOT_AMMO),
+    ConfigBool("loot_aid", "Loot Aid", &Config::LOOT_AID),
+    ConfigInt("loot_min_value", "Loot Min Value", &Config::LOOT_MIN_VALUE),
+    ConfigInt("loot_max_value", "Loot Max Value", &Config::LOOT_MAX_VALUE),
+    ConfigBool("loot_steal", "Loot Steal", &Config::LOOT_STEAL),
+    ConfigBool("loot_weight_limit", "Loot Weight Limit", &Config::LOOT_WEIGHT_LIMIT),
+    ConfigFormIDList("loot_keyword_allow", "Loot Keyword Allow ID", &Config::LOOT_KEYWORD_ALLOW),
+    ConfigFormIDList("loot_keyword_deny", "Loot Keyword Deny ID", &Config::LOOT_KEYWORD_DENY),
+    // XP
+    ConfigBool("xp_enabled", "XP Enabled", &Config::XP_ENABLED),
+    ConfigFloat("xp_ratio", "XP Ratio", &Config::XP_RATIO),
+    ConfigFloat("xp_killer_tolerance", "XP Killer Tolerance", &Config::XP_KILLER_TOLERANCE),
+    // Buffs
+    ConfigBool("buff_enabled", "Buff Enabled", &Config::BUFF_ENABLED),
+    ConfigFloat("buff_heal_rate", "Buff Heal Rate", &Config::BUFF_HEAL_RATE),
+    ConfigFloat("buff_combat_heal_rate", "Buff Combat Heal Rate", &Config::BUFF_COMBAT_HEAL_RATE),
+    ConfigFloat("buff_damage_resist", "Buff Damage Resist", &Config::BUFF_DAMAGE_RESIST),
+    ConfigFloat("buff_fire_resist", "Buff Fire Resist", &Config::BUFF_FIRE_RESIST),
+    ConfigFloat("buff_electrical_resist", "Buff Electrical Resist", &Config::BUFF_ELECTRICAL_RESIST),
+    ConfigFloat("buff_frost_resist", "Buff Frost Resist", &Config::BUFF_FROST_RESIST),
+    ConfigFloat("buff_energy_resist", "Buff Energy Resist", &Config::BUFF_ENERGY_RESIST),
+    ConfigFloat("buff_poison_resist", "Buff Poison Resist", &Config::BUFF_POISON_RESIST),
+    ConfigFloat("buff_radiation_resist", "Buff Radiation Resist", &Config::BUFF_RADIATION_RESIST),
+    ConfigFloat("buff_agility", "Buff Agility", &Config::BUFF_AGILITY),
+    ConfigFloat("buff_endurance", "Buff Endurance", &Config::BUFF_ENDURANCE),
+    ConfigFloat("buff_intelligence", "Buff Intelligence", &Config::BUFF_INTELLIGENCE),
+    ConfigFloat("buff_lockpick", "Buff Lockpick", &Config::BUFF_LOCKPICK),
+    ConfigFloat("buff_luck", "Buff Luck", &Config::BUFF_LUCK),
+    ConfigFloat("buff_perception", "Buff Perception", &Config::BUFF_PERCEPTION),
+    ConfigFloat("buff_sneak", "Buff Sneak", &Config::BUFF_SNEAK),
+    ConfigFloat("buff_strength", "Buff Strength", &Config::BUFF_STRENGTH),
+    ConfigFloat("buff_carryweight", "Buff Carry Weight", &Config::BUFF_CARRYWEIGHT),
+    // Power armor
+    ConfigBool("pa_enabled", "Power Armor Enabled", &Config::PA_ENABLED),
+    ConfigFloat("pa_repair_amount", "Power Armor Repair Amount", &Config::PA_REPAIR_AMOUNT),
+    // Perks, keywords and exclusions (repeatable keys)
+    ConfigBool("perk_enabled", "Perk Enabled", &Config::PERK_ENABLED),
+    ConfigFormIDList("perk_to_apply", "Perk ID", &Config::PERK_ID_LIST),
+    ConfigBool("keyword_enabled", "Keyword Enabled", &Config::KEYWORD_ENABLED),
+    ConfigFormIDList("keyword_to_apply", "Keyword ID", &Config::KEYWORD_ID_LIST),
+    ConfigFormIDList("exclude_actor_id_list", "Actor ID", &Config::EXCLUDE_ACTOR_ID_LIST),
+    // Threat score weights
+    ConfigFloat("threat_weapon_bonus", "Threat Weapon Bonus", &Config::THREAT_WEAPON_BONUS),
+    ConfigFloat("threat_legendary_bonus", "Threat Legendary Bonus", &Config::THREAT_LEGENDARY_BONUS),
+    ConfigFloat("threat_unique_bonus", "Threat Unique Bonus", &Config::THREAT_UNIQUE_BONUS),
+    ConfigFloat("threat_health_bonus", "Threat Health Bonus", &Config::THREAT_HEALTH_BONUS),
+    ConfigFloat("threat_alert_bonus", "Threat Alert Bonus", &Config::THREAT_ALERT_BONUS),
+    // Data (the INI names and the older short names)
+    ConfigFormID("current_companion_faction_id", "Companion Faction ID", &Config::CURRENT_COMPANION_FACTION_ID),
+    ConfigFormID("companion_faction_id", "Companion Faction ID", &Config::CURRENT_COMPANION_FACTION_ID),
+    ConfigFormID("actorvalue_hc_downed_id", "ActorValue HC Downed ID", &Config::ACTORVALUE_HC_DOWNED_ID),
+    ConfigFormID("item_stimpak_id", "Stimpak Item ID", &Config::ITEM_STIMPAK_ID),
+    ConfigFormID("item_stimpak", "Stimpak Item ID", &Config::ITEM_STIMPAK_ID),
+    ConfigFormID("item_repairkit_id", "Repair Kit Item ID", &Config::ITEM_REPAIRKIT_ID),
+    ConfigFormID("item_repairkit", "Repair Kit Item ID", &Config::ITEM_REPAIRKIT_ID),
+    ConfigFormIDList("race_stimpak_id", "Stimpak Race ID", &Config::RACE_STIMPAK_ID),
+    ConfigFormID("race_synth3c_id", "Synth3 Component ID", &Config::RACE_SYNTH3C_ID),
+    ConfigFormID("idle_stimpak_id", "Stimpak Animation ID", &Config::IDLE_STIMPAK_ID),
+    ConfigFormID("anim_stimpak", "Stimpak Animation ID", &Config::IDLE_STIMPAK_ID),
+    ConfigFormID("kywd_armortypepower_id", "PowerArmorType Keyword ID", &Config::KYWD_ARMORTYPEPOWER_ID),
+    ConfigFormID("kywd_ispowerarmorframe_id", "IsPowerArmorFrame Keyword ID", &Config::KYWD_ISPOWERARMORFRAME_ID),
+    ConfigFormID("pack_followerscompanion_id", "FollowersCompanion Package ID", &Config::PACK_FOLLOWERSCOMPANION_ID),
+});
+
+// Compile time check that no key is listed twice
+constexpr bool IsConfigSchemaUnique() {
+    for (std::size_t i = 1; i < CONFIG_SCHEMA.size(); ++i) {
+        if (CONFIG_SCHEMA[i - 1].name == CONFIG_SCHEMA[i].name)
+            return false;
+    }
+    return true;
+}
+static_assert(IsConfigSchemaUnique(), "Duplicate key in CONFIG_SCHEMA");
+
+
+// All INI keys sorted by name
+std::span<const ConfigKey> GetConfigSchema() {
+    return CONFIG_SCHEMA;
+}
+
+// Find a key in the schema (nullptr if unknown), name must be lower case
+const ConfigKey* FindConfigKey(std::string_view name) {
+    auto it = std::lower_bound(CONFIG_SCHEMA.begin(), CONFIG_SCHEMA.end(), name, [](const ConfigKey& key, std::string_view n) { return key.name < n; });
+    return (it != CONFIG_SCHEMA.end() && it->name == name) ? &*it : nullptr;
+}
+
+// Parse a hex FormID with an optional 0x prefix
+bool ParseConfigFormID(std::string_view value, std::uint32_t& out) {
+    if (value.size() > 2 && value[0] == '0' && (value[1] == 'x' || value[1] == 'X'))
+        value.remove_prefix(2);
+    auto [ptr, ec] = std::from_chars(value.data(), value.data() + value.size(), out, 16);
+    return ec == std::errc() && ptr == value.data() + value.size();
+}
+
+// Trim spaces, tabs and line endings from both sides
+constexpr std::string_view TrimConfigView(std::string_view text) {
+    constexpr std::string_view whitespace = " \t\r\n";
+    auto first = text.find_first_not_of(whitespace);
+    if (first == std::string_view::npos)
+        return {};
+    auto last = text.find_last_not_of(whitespace);
+    return text.substr(first, last - first + 1);
+}
+
+// Case-insensitive compare against a lower case literal
+bool EqualsConfigLower(std::string_view text, std::string_view lower) {
+    return text.size() == lower.size() && std::equal(text.begin(), text.end(), lower.begin(), [](char a, char b) { return std::tolower(static_cast<unsigned char>(a)) == b; });
+}
+
+// Shortest text of a number for the warning log
+std::string FormatConfigNumber(double number) {
+    std::array<char, 32> buffer{};
+    auto [ptr, ec] = std::to_chars(buffer.data(), buffer.data() + buffer.size(), number);
+    return std::string(buffer.data(), ec == std::errc() ? ptr : buffer.data());
+}
+
+// Describe a key's valid range for the warning log
+std::string DescribeConfigRange(const ConfigKey& key) {
+    if (key.max == CONFIG_NO_LIMIT)
+        return key.minExclusive ? "Must be positive." : "Must be non-negative.";
+    return "Must be between " + FormatConfigNumber(key.min) + " and " + FormatConfigNumber(key.max) + ".";
+}
+
+// Check a number against a key's range
+bool IsInConfigRange(const ConfigKey& key, double number) {
+    if (key.minExclusive ? number <= key.min : number < key.min)
+        return false;
+    return number <= key.max;
+}
+
+// Parse one value and store it in the key's field of the config, invalid values add a warning and keep the field
+void ApplyConfigValue(Config& config, const ConfigKey& key, std::string_view value, std::vector<std::string>& warnings) {
+    const char* first = value.data();
+    const char* last = value.data() + value.size();
+    switch (key.type) {
+    case CONFIG_TYPE::BOOL:
+        config.*key.boolField = EqualsConfigLower(value, "true") || value == "1";
+        return;
+    case CONFIG_TYPE::INT: {
+        int number = 0;
+        auto [ptr, ec] = std::from_chars(first, last, number);
+        if (ec != std::errc() || ptr != last) {
+            warnings.push_back("Error parsing " + std::string(key.label) + " value: " + std::string(value) + ".");
+        } else if (!IsInConfigRange(key, number)) {
+            warnings.push_back("Invalid " + std::string(key.label) + " value: " + std::string(value) + ". " + DescribeConfigRange(key));
+        } else {
+            config.*key.intField = number;
+        }
+        return;
+    }
+    case CONFIG_TYPE::FLOAT: {
+        float number = 0.0f;
+        auto [ptr, ec] = std::from_chars(first, last, number);
+        if (ec != std::errc() || ptr != last) {
+            warnings.push_back("Error parsing " + std::string(key.label) + " value: " + std::string(value) + ".");
+        } else if (!IsInConfigRange(key, number)) {
+            warnings.push_back("Invalid " + std::string(key.label) + " value: " + std::string(value) + ". " + DescribeConfigRange(key));
+        } else {
+            config.*key.floatField = number;
+        }
+        return;
+    }
+    case CONFIG_TYPE::FORMID:
+    case CONFIG_TYPE::FORMID_LIST: {
+        std::uint32_t formID = 0;
+        if (!ParseConfigFormID(value, formID)) {
+            warnings.push_back("Error parsing " + std::string(key.label) + ": " + std::string(value) + ".");
+        } else if (key.type == CONFIG_TYPE::FORMID) {
+            config.*key.formIDField = formID;
+        } else {
+            (config.*key.listField).push_back(formID);
+        }
+        return;
+    }
+    }
+}
+
+// Single pass over the whole INI text into a config, no per line allocation
+std::vector<std::string> ParseConfigText(std::string_view text, Config& config) {
+    std::vector<std::string> warnings;
+    while (!text.empty()) {
+        auto lineEnd = text.find('\n');
+        auto line = TrimConfigView(text.substr(0, lineEnd));
+        text.remove_prefix(lineEnd == std::string_view::npos ? text.size() : lineEnd + 1);
+        // Skip comments, sections and empty lines
+        if (line.empty() || line[0] == ';' || line[0] == '[')
+            continue;
+        auto eqPos = line.find('=');
+        if (eqPos == std::string_view::npos)
+            continue;
+        auto name = TrimConfigView(line.substr(0, eqPos));
+        auto value = line.substr(eqPos + 1);
+        // Remove comments after the value
+        value = TrimConfigView(value.substr(0, value.find(';')));
+        // Lower case key in a stack buffer for the case-insensitive lookup
+        std::array<char, 64> lowerName{};
+        if (name.empty() || name.size() > lowerName.size()) {
+            warnings.push_back("Unknown key: " + std::string(name));
+            continue;
+        }
+        std::transform(name.begin(), name.end(), lowerName.begin(), [](char c) { return static_cast<char>(std::tolower(static_cast<unsigned char>(c))); });
+        const auto* key = FindConfigKey(std::string_view(lowerName.data(), name.size()));
+        if (!key) {
+            warnings.push_back("Unknown key: " + std::string(name));
+            continue;
+        }
+        ApplyConfigValue(config, *key, value, warnings);
+    }
+    return warnings;
+}
+
+// Clear the keys that can be repeated
+void ClearConfigLists(Config& config) {
+    config.PERK_ID_LIST.clear();
+    config.KEYWORD_ID_LIST.clear();
+    config.EXCLUDE_ACTOR_ID_LIST.clear();
+    config.RACE_STIMPAK_ID.clear();
+    config.LOOT_KEYWORD_ALLOW.clear();
+    config.LOOT_KEYWORD_DENY.clear();
+}
+
+// FNV-1a hash of the INI text
+std::uint64_t HashConfigText(std::string_view text) {
+    std::uint64_t hash = 14695981039346656037ull;
+    for (char c : text) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+// Read a whole file at once
+bool ReadConfigText(const std::string& configPath, std::string& text) {
+    std::ifstream file(configPath, std::ios::binary);
+    if (!file.is_open())
+        return false;
+    text.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    return true;
+}
+
+// Get the size and time of the INI, false if it can't be read
+bool StatConfigFile(const std::string& configPath, ConfigFileStamp& stamp) {
+    std::error_code error;
+    stamp.writeTime = std::filesystem::last_write_time(configPath, error);
+    if (error)
+        return false;
+    stamp.size = std::filesystem::file_size(configPath, error);
+    return !error;
+}
+
+// Read the INI into text if its size, time or content changed since the stamp
+bool ReadConfigFileIfChanged(const std::string& configPath, ConfigFileStamp& stamp, std::string& text) {
+    ConfigFileStamp current;
+    if (!StatConfigFile(configPath, current))
+        return false;
+    // Cheap check first, the file is only read when the metadata changed
+    if (current.writeTime == stamp.writeTime && current.size == stamp.size)
+        return false;
+    if (!ReadConfigText(configPath, text))
+        return false;
+    current.hash = HashConfigText(text);
+    // Touched but not edited, keep the current generation
+    bool changed = current.hash != stamp.hash;
+    stamp = current;
+    return changed;
+}
@@ -0,0 +1,203 @@
+#pragma once
+#include <PCH.h>
+
+// Engine free INI settings: the config struct, its schema and the single pass parser
+// Reading the plugin directory, logging and publishing stay in main.cpp
+
+// --- STRUCTS ---
+
+// All INI settings, a published config is never modified (a reload publishes a new one)
+struct Config
+{
+    // Bumped on every publish
+    std::uint64_t generation = 0;
+    // Global debug flag
+    bool DEBUGGING = false;
+    // Global update interval (in seconds)
+    float UPDATE_INTERVAL = 3.0f;
+    // Read the ini every x updates (0 = only on game start)
+    int INI_RELOAD_INTERVAL = 10;
+    // Actor search radius around the player in game units
+    float ACTOR_SEARCH_RADIUS = 4000.0f;
+    // Main thread time budget per frame in milliseconds
+    float FRAME_BUDGET_MS = 0.5f;
+    // AI settings
+    float AI_HEALTH_THRESHOLD = 40.0f;
+    bool AI_USE_STIMPAK = true;
+    bool AI_USE_STIMPAK_UNLIMITED = false;
+    bool AI_AUTO_REVIVE = true;
+    bool AI_FLEE_COMBAT = true;
+    float AI_FLEE_DISTANCE = 500.0f;
+    bool AI_EQUIP_ITEMS = true;
+    bool AI_EQUIP_GEAR = false;
+    bool AI_EQUIP_AMMO_REFILL = true;
+    int AI_EQUIP_AMMO_AMOUNT = 50;
+    int AI_EQUIP_AMMO_AMOUNT_AUTOMATIC = 150;
+    int AI_EQUIP_SCORE = 0;
+    // Movement settings
+    bool AI_STUCK_CHECK = true;
+    int AI_STUCK_THRESHOLD = 20;
+    int AI_STUCK_COLLISIONS = 2;
+    float AI_STUCK_SPEED = 10.0f;
+    float AI_STUCK_DISTANCE = 1500.0f;
+    // Aggression settings
+    bool AI_AGGRESSION_ENABLED = true;
+    bool AI_AGGRESSION_ALL = true;
+    bool AI_AGGRESSION_SNEAK = false;
+    float AI_AGGRESSION_RADIUS0 = 3000.0f;
+    float AI_AGGRESSION_RADIUS1 = 2000.0f;
+    float AI_AGGRESSION_RADIUS2 = 1000.0f;
+    // Chatter settings
+    bool CHATTER_ENABLED = false;
+    float CHATTER_MULTIPLIER = 1.0f;
+    float CHATTER_MULTIPLIER_SNEAK = 5.0f;
+    // Combat AI settings
+    bool COMBAT_ENABLED = true;
+    int COMBAT_TARGET = 0;
+    float COMBAT_OFFENSIVE = 0.5f;
+    float COMBAT_DEFENSIVE = 0.5f;
+    float COMBAT_RANGED = 1.0f;
+    float COMBAT_MELEE = 0.2f;
+    // Ranged
+    float COMBAT_RANGED_ADJUSTMENT = 1.0f;
+    float COMBAT_RANGED_CROUCHING = 1.0f;
+    float COMBAT_RANGED_STRAFE = 0.5f;
+    float COMBAT_RANGED_WAITING = 0.5f;
+    float COMBAT_RANGED_ACCURACY = 0.5f;
+    // Close-Quarters
+    float COMBAT_CLOSE_FALLBACK = 0.5f;
+    float COMBAT_CLOSE_CIRCLE = 0.5f;
+    float COMBAT_CLOSE_DISENGAGE = 0.5f;
+    float COMBAT_CLOSE_FLANK = 0.5f;
+    int COMBAT_CLOSE_THROW_GRENADE = 0;
+    // Cover
+    float COMBAT_COVER_DISTANCE = 0.5f;
+    // Loot item filter flag
+    bool LOOT_ENABLED = true;
+    bool LOOT_COMBAT = false;
+    float LOOT_RADIUS = 1000.0f;
+    bool LOOT_JUNK = true;
+    bool LOOT_AMMO = true;
+    bool LOOT_AID = true;
+    int LOOT_MIN_VALUE = 0;
+    int LOOT_MAX_VALUE = 800;
+    bool LOOT_STEAL = false;
+    bool LOOT_WEIGHT_LIMIT = true;
+    std::vector<std::uint32_t> LOOT_KEYWORD_ALLOW;
+    std::vector<std::uint32_t> LOOT_KEYWORD_DENY;
+    // XP gain settings
+    bool XP_ENABLED = true;
+    float XP_RATIO = 0.5f;
+    float XP_KILLER_TOLERANCE = 3000.0f;
+    // Buff settings
+    bool BUFF_ENABLED = true;
+    float BUFF_HEAL_RATE = 5.0f;
+    float BUFF_COMBAT_HEAL_RATE = 5.0f;
+    float BUFF_DAMAGE_RESIST = 200.0f;
+    float BUFF_FIRE_RESIST = 50.0f;
+    float BUFF_ELECTRICAL_RESIST = 50.0f;
+    float BUFF_FROST_RESIST = 50.0f;
+    float BUFF_ENERGY_RESIST = 50.0f;
+    float BUFF_POISON_RESIST = 50.0f;
+    float BUFF_RADIATION_RESIST = 50.0f;
+    float BUFF_AGILITY = 5.0f;
+    float BUFF_ENDURANCE = 5.0f;
+    float BUFF_INTELLIGENCE = 5.0f;
+    float BUFF_LUCK = 5.0f;
+    float BUFF_PERCEPTION = 5.0f;
+    float BUFF_SNEAK = 5.0f;
+    float BUFF_STRENGTH = 5.0f;
+    float BUFF_LOCKPICK = 5.0f;
+    float BUFF_CARRYWEIGHT = 1000.0f;
+    // --- Power Armor Settings ---
+    bool PA_ENABLED = true;
+    float PA_REPAIR_AMOUNT = 0.01f;
+    // Perk settings
+    bool PERK_ENABLED = true;
+    std::vector<std::uint32_t> PERK_ID_LIST;
+    // --- Keyword settings ---
+    bool KEYWORD_ENABLED = true;
+    std::vector<std::uint32_t> KEYWORD_ID_LIST;
+    // -- Actor exclusion list --
+    std::vector<std::uint32_t> EXCLUDE_ACTOR_ID_LIST;
+    // Threat score weights
+    float THREAT_WEAPON_BONUS = 1.0f;
+    float THREAT_LEGENDARY_BONUS = 1.0f;
+    float THREAT_UNIQUE_BONUS = 1.0f;
+    float THREAT_HEALTH_BONUS = 1.0f;
+    float THREAT_ALERT_BONUS = 1.0f;
+    // --- DATA ---
+    // Current companion faction ID
+    std::uint32_t CURRENT_COMPANION_FACTION_ID = 0x00023C01;
+    // ActorValue for HC downed state
+    std::uint32_t ACTORVALUE_HC_DOWNED_ID = 0x00249F6D; // 00249F6D HC_IsCompanionInNeedOfHealing
+    // Item forms
+    std::uint32_t ITEM_STIMPAK_ID = 0x00023736; // 00023736 Stimpak
+    std::uint32_t ITEM_REPAIRKIT_ID = 0x00004F12; // 00004F12 Repair Kit
+    // Race forms for stimpak users
+    std::vector<std::uint32_t> RACE_STIMPAK_ID = {0x00013746, 0x000EAFB6}; // 00013746 Human, 000EAFB6 Ghoul
+    // Synth 3 component
+    std::uint32_t RACE_SYNTH3C_ID = 0x000CFF74; // 000CFF74 Synth3 component
+    // IDLE animations
+    std::uint32_t IDLE_STIMPAK_ID = 0x000B1CF9; // 000B1CF9 3rdPUseStimpakOnSelf
+    // Keywords
+    std::uint32_t KYWD_ARMORTYPEPOWER_ID = 0x0004D8A1;    // 0004D8A1 ArmorTypePower
+    std::uint32_t KYWD_ISPOWERARMORFRAME_ID = 0x0015503F; // 0015503F isPowerArmorFrame
+    // Packages
+    std::uint32_t PACK_FOLLOWERSCOMPANION_ID = 0x0002A101; // 0002A101 FollowersCompanion
+};
+
+// --- Config schema ---
+// Value type of an INI key
+enum class CONFIG_TYPE : std::uint8_t {
+    BOOL,
+    INT,
+    FLOAT,
+    FORMID,
+    FORMID_LIST
+};
+
+constexpr double CONFIG_NO_LIMIT = std::numeric_limits<double>::infinity();
+
+// One INI key: lower case name, target Config field and valid range (INT/FLOAT only)
+struct ConfigKey {
+    std::string_view name;
+    std::string_view label;
+    CONFIG_TYPE type;
+    bool Config::* boolField = nullptr;
+    int Config::* intField = nullptr;
+    float Config::* floatField = nullptr;
+    std::uint32_t Config::* formIDField = nullptr;
+    std::vector<std::uint32_t> Config::* listField = nullptr;
+    double min = -CONFIG_NO_LIMIT;
+    double max = CONFIG_NO_LIMIT;
+    bool minExclusive = false;
+};
+
+// State of an INI file, a reload only reads the file when size or time changed
+struct ConfigFileStamp {
+    std::filesystem::file_time_type writeTime{};
+    std::uintmax_t size = 0;
+    std::uint64_t hash = 0;
+};
+
+// --- FUNCTIONS ---
+
+// All INI keys sorted by name
+std::span<const ConfigKey> GetConfigSchema();
+// Find a key in the schema (nullptr if unknown), name must be lower case
+const ConfigKey* FindConfigKey(std::string_view name);
+// Parse a hex FormID with an optional 0x prefix
+bool ParseConfigFormID(std::string_view value, std::uint32_t& out);
+// Clear the keys that can be repeated, a reload rebuilds them from scratch
+void ClearConfigLists(Config& config);
+// Single pass over the whole INI text into a config, returns the warnings for the log
+std::vector<std::string> ParseConfigText(std::string_view text, Config& config);
+// FNV-1a hash of the INI text
+std::uint64_t HashConfigText(std::string_view text);
+// Read a whole file, false if it can't be opened
+bool ReadConfigText(const std::string& configPath, std::string& text);
+// Get the size and time of the INI, false if it can't be read
+bool StatConfigFile(const std::string& configPath, ConfigFileStamp& stamp);
+// Read the INI into text if its size, time or content changed since the stamp, the stamp is updated
+bool ReadConfigFileIfChanged(const std::string& configPath, ConfigFileStamp& stamp, std::string& text);
@@ -0,0 +1,773 @@
+#include <Core.h>
+
+// --- VARIABLES ---
+// Actor Tracking variables
+namespace ActorTracking {
+std::atomic<SnapshotPtr> g_snapshot{std::make_shared<const Snapshot>()};
+std::atomic<SnapshotPtr> g_snapshotPrev{std::make_shared<const Snapshot>()};
+} // namespace ActorTracking
+
+// --- HOOKS ---
+
+// Start the scheduler worker thread
+void CCB_Scheduler::Start() {
+    std::unique_lock<std::mutex> lock(mutex);
+    if (running.load())
+        return;
+    // A loop stopped by one of its own jobs is still returning, it has to exit before a new one starts
+    if (worker.joinable()) {
+        // Called from that job, the loop can't wait for itself
+        if (worker.get_id() == std::this_thread::get_id())
+            return;
+        auto previous = std::move(worker);
+        lock.unlock();
+        previous.join();
+        lock.lock();
+        if (running.load() || worker.joinable())
+            return;
+    }
+    running = true;
+    worker = std::thread([this]() { Run(); });
+}
+
+// Stop the scheduler worker thread and drop all jobs
+void CCB_Scheduler::Stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        running = false;
+        jobs.clear();
+    }
+    wakeUp.notify_all();
+    // A job stopping its own scheduler can't join itself, the loop exits on return and the next Start or Stop joins it
+    if (worker.joinable() && worker.get_id() != std::this_thread::get_id())
+        worker.join();
+}
+
+// Add a periodic job
+CCB_Scheduler::JobId CCB_Scheduler::AddJob(const char* name, Clock::duration interval, std::function<void()> callback) {
+    if (interval <= Clock::duration::zero() || !callback)
+        return INVALID_JOB;
+    JobId id;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        id = nextJobId++;
+        auto job = std::make_shared<Job>();
+        job->id = id;
+        job->name = name;
+        job->interval = interval;
+        job->deadline = Clock::now() + interval;
+        job->callback = std::move(callback);
+        jobs.push_back(std::move(job));
+    }
+    wakeUp.notify_all();
+    return id;
+}
+
+// Run a callback once on the worker thread
+CCB_Scheduler::JobId CCB_Scheduler::Post(const char* name, std::function<void()> callback) {
+    if (!callback)
+        return INVALID_JOB;
+    JobId id;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!running)
+            return INVALID_JOB;
+        id = nextJobId++;
+        auto job = std::make_shared<Job>();
+        job->id = id;
+        job->name = name;
+        job->interval = Clock::duration::zero();
+        job->deadline = Clock::now();
+        job->callback = std::move(callback);
+        job->oneShot = true;
+        jobs.push_back(std::move(job));
+    }
+    wakeUp.notify_all();
+    return id;
+}
+
+// Remove a job
+void CCB_Scheduler::RemoveJob(JobId id) {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::erase_if(jobs, [id](const std::shared_ptr<Job>& job) { return job->id == id; });
+}
+
+// Change the interval of a job
+void CCB_Scheduler::SetInterval(JobId id, Clock::duration interval) {
+    if (interval <= Clock::duration::zero())
+        return;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (auto& job : jobs) {
+            if (job->id == id) {
+                job->interval = interval;
+                job->deadline = Clock::now() + interval;
+                break;
+            }
+        }
+    }
+    wakeUp.notify_all();
+}
+
+// Get a copy of the timing statistics of a job
+std::optional<CCB_Scheduler::JobStats> CCB_Scheduler::GetStats(JobId id) {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto& job : jobs) {
+        if (job->id == id)
+            return job->stats;
+    }
+    return std::nullopt;
+}
+
+// Worker loop, sleeps until the earliest deadline and runs all due jobs
+void CCB_Scheduler::Run() {
+    std::vector<std::shared_ptr<Job>> dueJobs;
+    std::unique_lock<std::mutex> lock(mutex);
+    while (running) {
+        if (jobs.empty()) {
+            wakeUp.wait(lock);
+            continue;
+        }
+        // Sleep until the earliest deadline, any job change wakes us up to recalculate
+        auto earliest = Clock::time_point::max();
+        for (auto& job : jobs)
+            earliest = (std::min)(earliest, job->deadline);
+        auto now = Clock::now();
+        if (earliest > now) {
+            wakeUp.wait_until(lock, earliest);
+            continue;
+        }
+        // Collect due jobs and advance their absolute deadlines
+        dueJobs.clear();
+        for (auto& job : jobs) {
+            if (job->deadline > now)
+                continue;
+            auto lateness = now - job->deadline;
+            job->stats.maxLateness = (std::max)(job->stats.maxLateness, lateness);
+            job->stats.totalLateness += lateness;
+            dueJobs.push_back(job);
+            // One-shot jobs leave the list once collected
+            if (job->oneShot)
+                continue;
+            job->deadline += job->interval;
+            // Fell behind by more than one interval, skip the missed ticks instead of bursting
+            if (job->deadline <= now) {
+                auto missed = (now - job->deadline) / job->interval + 1;
+                job->stats.skipped += missed;
+                job->deadline += job->interval * missed;
+            }
+        }
+        std::erase_if(jobs, [now](const std::shared_ptr<Job>& job) { return job->oneShot && job->deadline <= now; });
+        // Run the callbacks without holding the lock
+        lock.unlock();
+        for (auto& job : dueJobs) {
+            // Stopped by an earlier callback, the rest of the batch belongs to the dropped jobs
+            if (!running)
+                break;
+            auto start = Clock::now();
+            job->callback();
+            auto runTime = Clock::now() - start;
+            std::lock_guard<std::mutex> statsLock(mutex);
+            job->stats.ticks++;
+            job->stats.maxRunTime = (std::max)(job->stats.maxRunTime, runTime);
+            job->stats.totalRunTime += runTime;
+        }
+        dueJobs.clear();
+        lock.lock();
+    }
+}
+
+// Directory change notifications of the platform
+#if defined(_WIN32)
+class Win32FileWatchBackend final : public CCB_FileWatchBackend {
+public:
+    ~Win32FileWatchBackend() override {
+        if (change != INVALID_HANDLE_VALUE)
+            FindCloseChangeNotification(change);
+        if (stopEvent)
+            CloseHandle(stopEvent);
+    }
+    bool Open(const std::string& directory) override {
+        stopEvent = CreateEventA(nullptr, TRUE, FALSE, nullptr);
+        if (!stopEvent)
+            return false;
+        change = FindFirstChangeNotificationA(directory.c_str(), FALSE, FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_SIZE | FILE_NOTIFY_CHANGE_LAST_WRITE);
+        return change != INVALID_HANDLE_VALUE;
+    }
+    WAIT Wait(std::chrono::milliseconds timeout) override {
+        // Rearm after the previous notification
+        if (rearm && !FindNextChangeNotification(change))
+            return WAIT::FAILED;
+        rearm = false;
+        HANDLE handles[2] = {stopEvent, change};
+        DWORD result = WaitForMultipleObjects(2, handles, FALSE, timeout == FOREVER ? INFINITE : static_cast<DWORD>(timeout.count()));
+        if (result == WAIT_OBJECT_0 + 1) {
+            rearm = true;
+            return WAIT::CHANGE;
+        }
+        if (result == WAIT_TIMEOUT)
+            return WAIT::TIMEOUT;
+        return result == WAIT_OBJECT_0 ? WAIT::STOPPED : WAIT::FAILED;
+    }
+    void Interrupt() override {
+        if (stopEvent)
+            SetEvent(stopEvent);
+    }
+private:
+    HANDLE change = INVALID_HANDLE_VALUE;
+    HANDLE stopEvent = nullptr;
+    bool rearm = false;
+};
+
+std::unique_ptr<CCB_FileWatchBackend> MakeFileWatchBackend() {
+    return std::make_unique<Win32FileWatchBackend>();
+}
+#elif defined(__linux__)
+class InotifyFileWatchBackend final : public CCB_FileWatchBackend {
+public:
+    ~InotifyFileWatchBackend() override {
+        if (notifyFd >= 0)
+            close(notifyFd);
+        if (stopFd >= 0)
+            close(stopFd);
+    }
+    bool Open(const std::string& directory) override {
+        stopFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        notifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (stopFd < 0 || notifyFd < 0)
+            return false;
+        // Same events as the Windows filter: names, sizes and writes
+        return inotify_add_watch(notifyFd, directory.c_str(), IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_MODIFY | IN_CLOSE_WRITE) >= 0;
+    }
+    WAIT Wait(std::chrono::milliseconds timeout) override {
+        pollfd fds[2] = {{stopFd, POLLIN, 0}, {notifyFd, POLLIN, 0}};
+        int result;
+        do {
+            result = poll(fds, 2, timeout == FOREVER ? -1 : static_cast<int>(timeout.count()));
+        } while (result < 0 && errno == EINTR);
+        if (result < 0)
+            return WAIT::FAILED;
+        if (result == 0)
+            return WAIT::TIMEOUT;
+        if (fds[0].revents & POLLIN)
+            return WAIT::STOPPED;
+        if (!(fds[1].revents & POLLIN))
+            return WAIT::FAILED;
+        // Consume the queued events, the watcher only needs to know that something changed
+        alignas(inotify_event) char buffer[4096];
+        while (read(notifyFd, buffer, sizeof(buffer)) > 0) {
+        }
+        return WAIT::CHANGE;
+    }
+    void Interrupt() override {
+        std::uint64_t one = 1;
+        // Only fails on a full counter, which wakes up the watcher as well
+        while (stopFd >= 0 && write(stopFd, &one, sizeof(one)) < 0 && errno == EINTR) {
+        }
+    }
+private:
+    int notifyFd = -1;
+    int stopFd = -1;
+};
+
+std::unique_ptr<CCB_FileWatchBackend> MakeFileWatchBackend() {
+    return std::make_unique<InotifyFileWatchBackend>();
+}
+#else
+std::unique_ptr<CCB_FileWatchBackend> MakeFileWatchBackend() {
+    return nullptr;
+}
+#endif
+
+// Start watching a directory for file writes, renames and size changes
+bool CCB_FileWatcher::Start(const std::string& directory, std::chrono::milliseconds debounce, Callback onChange) {
+    return Start(MakeFileWatchBackend(), directory, debounce, std::move(onChange));
+}
+
+// Start watching a directory with the given backend
+bool CCB_FileWatcher::Start(std::unique_ptr<CCB_FileWatchBackend> watchBackend, const std::string& directory, std::chrono::milliseconds debounce, Callback onChange) {
+    if (running.load() || !onChange || !watchBackend)
+        return false;
+    // Clean up a watcher that exited on an error
+    Stop();
+    if (!watchBackend->Open(directory))
+        return false;
+    backend = std::move(watchBackend);
+    callback = std::move(onChange);
+    running = true;
+    worker = std::thread([this, debounce]() { Run(debounce); });
+    return true;
+}
+
+// Stop the watcher thread
+void CCB_FileWatcher::Stop() {
+    if (backend)
+        backend->Interrupt();
+    if (worker.joinable())
+        worker.join();
+    backend.reset();
+    running = false;
+}
+
+// Watcher loop, waits for a notification and then until no new one arrives for the debounce time
+void CCB_FileWatcher::Run(std::chrono::milliseconds debounce) {
+    using WAIT = CCB_FileWatchBackend::WAIT;
+    while (backend->Wait(CCB_FileWatchBackend::FOREVER) == WAIT::CHANGE) {
+        // Keep waiting while the burst goes on
+        WAIT result;
+        do {
+            result = backend->Wait(debounce);
+        } while (result == WAIT::CHANGE);
+        if (result != WAIT::TIMEOUT)
+            break;
+        callback();
+    }
+    running = false;
+}
+
+// Analysis side of the actor pipeline
+namespace ActorPipeline {
+bool IsExcluded(const GatherRecord& record, const AnalyzeParams& params) {
+    if (!record.hasNPC)
+        return false;
+    // Check any of the relevant form IDs
+    const auto& excluded = params.compiled->excludedActors;
+    return !excluded.Empty() && (excluded.Contains(record.formID) || excluded.Contains(record.baseFormID) || excluded.Contains(record.objectFormID));
+}
+
+EnemyAnalysis DescribeEnemy(const GatherRecord& record, float enemyMaxHealth) {
+    EnemyAnalysis analysis{};
+    analysis.tier = ENEMY_TIER::LOW; // Default
+    if (!record.hasNPC)
+        return analysis;
+    // Calculate health percentage relative to strongest enemy
+    analysis.healthPercentOfMax = (record.maxHealth > 0.0f && enemyMaxHealth > 0.0f) ? (record.health / enemyMaxHealth) : 0.0f;
+    // Check unique/legendary status, "Legendary" name prefix is more reliable than the template check
+    analysis.isUnique = record.isUnique;
+    analysis.isLegendary = record.hasLegendTemplate || record.hasLegendChance || record.hasLegendaryName;
+    // Check if alerted/in combat
+    analysis.isAlerted = record.isInCombat;
+    // Equipped weapons determine the combat type
+    for (std::uint32_t i = 0; i < record.weaponCount; ++i) {
+        switch (record.weapons[i].weaponClass) {
+        case WEAPON_CLASS::MELEE:
+            analysis.isMelee = true;
+            break;
+        case WEAPON_CLASS::EXPLOSIVE:
+            analysis.hasGrenades = true;
+            analysis.isRanged = true;
+            break;
+        case WEAPON_CLASS::RANGED:
+            analysis.isRanged = true;
+            break;
+        default:
+            break;
+        }
+    }
+    return analysis;
+}
+
+EnemyAnalysis ScoreEnemy(const GatherRecord& record, float enemyMaxHealth, const AnalyzeParams& params) {
+    auto analysis = DescribeEnemy(record, enemyMaxHealth);
+    // Single lane, the scalar kernel is the reference for the SIMD one
+    static thread_local ThreatFeatures features;
+    features.Reset(1);
+    auto lane = features.Add(record, enemyMaxHealth);
+    analysis.tier = ScoreThreatLane(features, lane, params);
+    return analysis;
+}
+
+void ThreatFeatures::Reset(std::size_t maxLanes) {
+    count = 0;
+    // Whole blocks of lanes, padding lanes score as LOW without a HAS_NPC flag
+    std::size_t size = (maxLanes + THREAT_LANES - 1) / THREAT_LANES * THREAT_LANES;
+    healthPercent.assign(size, 0.0f);
+    for (std::size_t w = 0; w < MAX_GATHER_WEAPONS; ++w) {
+        weaponValue[w].assign(size, 0.0f);
+        weaponDamage[w].assign(size, 0.0f);
+        weaponClassThreat[w].assign(size, 0.0f);
+    }
+    flags.assign(size, 0);
+    tiers.assign(size, ENEMY_TIER::LOW);
+}
+
+std::size_t ThreatFeatures::Add(const GatherRecord& record, float enemyMaxHealth) {
+    std::size_t lane = count++;
+    healthPercent[lane] = (record.maxHealth > 0.0f && enemyMaxHealth > 0.0f) ? (record.health / enemyMaxHealth) : 0.0f;
+    for (std::uint32_t w = 0; w < record.weaponCount; ++w) {
+        const auto& weapon = record.weapons[w];
+        weaponValue[w][lane] = static_cast<float>(weapon.value);
+        weaponDamage[w][lane] = weapon.damage;
+        weaponClassThreat[w][lane] = WEAPON_CLASS_THREAT[static_cast<std::size_t>(weapon.weaponClass)];
+    }
+    std::uint32_t laneFlags = 0;
+    if (record.hasNPC)
+        laneFlags |= THREAT_FLAG::HAS_NPC;
+    if (record.hasLegendaryName)
+        laneFlags |= THREAT_FLAG::LEGENDARY_NAME;
+    if (record.isUnique)
+        laneFlags |= THREAT_FLAG::UNIQUE;
+    if (record.isInCombat)
+        laneFlags |= THREAT_FLAG::ALERTED;
+    flags[lane] = laneFlags;
+    return lane;
+}
+
+ENEMY_TIER ScoreThreatLane(const ThreatFeatures& features, std::size_t lane, const AnalyzeParams& params) {
+    std::uint32_t flags = features.flags[lane];
+    if (!(flags & THREAT_FLAG::HAS_NPC))
+        return ENEMY_TIER::LOW;
+    // Weapon threat: value tier of the last valuable weapon, plus damage and class points of all weapons
+    float weaponThreatBonus = 0.0f;
+    for (std::size_t w = 0; w < MAX_GATHER_WEAPONS; ++w) {
+        float value = features.weaponValue[w][lane];
+        if (value >= 1000.0f)
+            weaponThreatBonus = 3.0f; // Legendary/Unique weapons
+        else if (value >= 500.0f)
+            weaponThreatBonus = 2.0f; // Heavily modified/enchanted
+        else if (value >= 250.0f)
+            weaponThreatBonus = 1.0f; // Standard modified weapon
+        if (features.weaponDamage[w][lane] > 100.0f)
+            weaponThreatBonus += 1.0f; // High-damage weapon
+        weaponThreatBonus += features.weaponClassThreat[w][lane]; // Melee/explosives 2, ranged 1
+    }
+    // Whole points after every factor, as an integer score
+    float threatScore = 0.0f;
+    auto add = [&threatScore](float points) { threatScore = std::trunc(threatScore + points); };
+    add(weaponThreatBonus * params.weaponBonus);
+    // Legendary enemies are always high threat
+    if (flags & THREAT_FLAG::LEGENDARY_NAME)
+        add(3.0f * params.legendaryBonus);
+    // Health factor (0-3 points)
+    float health = features.healthPercent[lane];
+    add((health > 0.8f ? 3.0f : health > 0.5f ? 2.0f : health > 0.3f ? 1.0f : 0.0f) * params.healthBonus);
+    // Special status (0-2 points)
+    if (flags & THREAT_FLAG::UNIQUE)
+        add(2.0f * params.uniqueBonus);
+    // Alert status (0-1 point)
+    if (flags & THREAT_FLAG::ALERTED)
+        add(1.0f * params.alertBonus);
+    // Assign tier based on total score
+    if (threatScore >= 7.0f)
+        return ENEMY_TIER::HIGH;
+    if (threatScore >= 4.0f)
+        return ENEMY_TIER::MEDIUM;
+    return ENEMY_TIER::LOW;
+}
+
+#if CCB_SSE2
+// Four lanes of ScoreThreatLane, same operations in the same order so results match exactly
+static void ScoreThreatsSSE2(ThreatFeatures& features, const AnalyzeParams& params) {
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 zero = _mm_setzero_ps();
+    // Branchless select: mask ? a : b
+    auto select = [](__m128 mask, __m128 a, __m128 b) { return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b)); };
+    auto truncate = [](__m128 x) { return _mm_cvtepi32_ps(_mm_cvttps_epi32(x)); };
+    auto flagMask = [](__m128i flags, std::uint32_t bit) {
+        __m128i bits = _mm_set1_epi32(static_cast<int>(bit));
+        return _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(flags, bits), bits));
+    };
+    const __m128 weaponBonus = _mm_set1_ps(params.weaponBonus);
+    const __m128 legendaryPoints = _mm_set1_ps(3.0f * params.legendaryBonus);
+    const __m128 healthBonus = _mm_set1_ps(params.healthBonus);
+    const __m128 uniquePoints = _mm_set1_ps(2.0f * params.uniqueBonus);
+    const __m128 alertPoints = _mm_set1_ps(1.0f * params.alertBonus);
+    for (std::size_t lane = 0; lane < features.count; lane += THREAT_LANES) {
+        __m128 weaponThreatBonus = zero;
+        for (std::size_t w = 0; w < MAX_GATHER_WEAPONS; ++w) {
+            __m128 value = _mm_loadu_ps(&features.weaponValue[w][lane]);
+            __m128 tier = select(_mm_cmpge_ps(value, _mm_set1_ps(1000.0f)), _mm_set1_ps(3.0f), select(_mm_cmpge_ps(value, _mm_set1_ps(500.0f)), _mm_set1_ps(2.0f), one));
+            weaponThreatBonus = select(_mm_cmpge_ps(value, _mm_set1_ps(250.0f)), tier, weaponThreatBonus);
+            weaponThreatBonus = _mm_add_ps(weaponThreatBonus, _mm_and_ps(_mm_cmpgt_ps(_mm_loadu_ps(&features.weaponDamage[w][lane]), _mm_set1_ps(100.0f)), one));
+            weaponThreatBonus = _mm_add_ps(weaponThreatBonus, _mm_loadu_ps(&features.weaponClassThreat[w][lane]));
+        }
+        __m128i flags = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&features.flags[lane]));
+        __m128 threatScore = truncate(_mm_mul_ps(weaponThreatBonus, weaponBonus));
+        threatScore = select(flagMask(flags, THREAT_FLAG::LEGENDARY_NAME), truncate(_mm_add_ps(threatScore, legendaryPoints)), threatScore);
+        __m128 health = _mm_loadu_ps(&features.healthPercent[lane]);
+        __m128 healthPoints = select(_mm_cmpgt_ps(health, _mm_set1_ps(0.8f)), _mm_set1_ps(3.0f), select(_mm_cmpgt_ps(health, _mm_set1_ps(0.5f)), _mm_set1_ps(2.0f), _mm_and_ps(_mm_cmpgt_ps(health, _mm_set1_ps(0.3f)), one)));
+        threatScore = truncate(_mm_add_ps(threatScore, _mm_mul_ps(healthPoints, healthBonus)));
+        threatScore = select(flagMask(flags, THREAT_FLAG::UNIQUE), truncate(_mm_add_ps(threatScore, uniquePoints)), threatScore);
+        threatScore = select(flagMask(flags, THREAT_FLAG::ALERTED), truncate(_mm_add_ps(threatScore, alertPoints)), threatScore);
+        // Tier = (score >= 4) + (score >= 7), LOW without an NPC base
+        __m128i tier = _mm_sub_epi32(_mm_setzero_si128(), _mm_add_epi32(_mm_castps_si128(_mm_cmpge_ps(threatScore, _mm_set1_ps(4.0f))), _mm_castps_si128(_mm_cmpge_ps(threatScore, _mm_set1_ps(7.0f)))));
+        tier = _mm_and_si128(tier, _mm_castps_si128(flagMask(flags, THREAT_FLAG::HAS_NPC)));
+        alignas(16) std::int32_t tiers[THREAT_LANES];
+        _mm_store_si128(reinterpret_cast<__m128i*>(tiers), tier);
+        for (std::size_t i = 0; i < THREAT_LANES; ++i)
+            features.tiers[lane + i] = static_cast<ENEMY_TIER>(tiers[i]);
+    }
+}
+#endif
+
+void ScoreThreats(ThreatFeatures& features, const AnalyzeParams& params) {
+#if CCB_SSE2
+    ScoreThreatsSSE2(features, params);
+#else
+    for (std::size_t lane = 0; lane < features.count; ++lane)
+        features.tiers[lane] = ScoreThreatLane(features, lane, params);
+#endif
+}
+
+TrackedActorData MakeTrackedData(const GatherRecord& record, ENEMY_TIER tier, std::chrono::steady_clock::time_point time) {
+    TrackedActorData data{};
+    data.actor = record.actor;
+    data.formID = record.formID;
+    data.tier = tier;
+    data.aiUpdated = false;
+    data.lastUpdate = time;
+    data.distanceToPlayer = record.distanceToPlayer;
+    data.position = record.position;
+    data.lifeState = record.states.lifeState;
+    data.weaponState = record.states.weaponState;
+    data.gunState = record.states.gunState;
+    data.interactingState = record.states.interactingState;
+    data.maxHealth = record.maxHealth;
+    data.healthPercent = (record.maxHealth > 0) ? (record.health / record.maxHealth) : 0.0f;
+    data.isAlerted = record.isInCombat;
+    data.isUnique = record.isUnique;
+    data.isLegendary = record.hasLegendTemplate || record.hasLegendChance;
+    return data;
+}
+
+AnalyzeResult Analyze(const GatherBuffer& buffer, const ActorTracking::Snapshot& prev, const AnalyzeParams& params) {
+    AnalyzeResult result;
+    // Max enemy health for relative comparison, and an upper bound of the enemy count
+    std::size_t hostileCount = 0;
+    for (const auto& record : buffer.records) {
+        if (record.isDead || !record.isHostile)
+            continue;
+        hostileCount++;
+        if (record.maxHealth > result.enemyMaxHealth)
+            result.enemyMaxHealth = record.maxHealth;
+    }
+    float enemyMaxHealth = (result.enemyMaxHealth > 0.0f) ? result.enemyMaxHealth : params.fallbackEnemyMaxHealth;
+    // Enemy threat features, scored together once all enemies are known (reused between analyses)
+    static thread_local ThreatFeatures features;
+    features.Reset(hostileCount);
+    // Categorize and store
+    for (const auto& record : buffer.records) {
+        if (!record.actor || record.isDead || record.isPlayer)
+            continue;
+        // Skip excluded actors
+        if (IsExcluded(record, params))
+            continue;
+        if (record.isCompanion) {
+            // Companions are not enemies, tier is irrelevant
+            auto data = MakeTrackedData(record, ENEMY_TIER::LOW, buffer.time);
+            // Compare with previous state for changes
+            if (const auto* prevData = prev.FindCompanion(record.formID, record.actor)) {
+                data.aiUpdated = prevData->aiUpdated;
+                data.usesStimpak = record.stimpakKnown ? record.usesStimpak : prevData->usesStimpak;
+                if (params.updateInterval > 0.0f)
+                    data.velocity = record.position.GetDistance(prevData->position) / params.updateInterval;
+                data.stuckCounter = record.stuckCounter;
+                data.lost = record.lost;
+            }
+            result.companions.push_back(data);
+        } else if (record.isHostile) {
+            auto analysis = DescribeEnemy(record, enemyMaxHealth);
+            auto data = MakeTrackedData(record, ENEMY_TIER::LOW, buffer.time);
+            data.isRanged = analysis.isRanged;
+            data.isMelee = analysis.isMelee;
+            data.hasGrenades = analysis.hasGrenades;
+            features.Add(record, enemyMaxHealth);
+            result.enemies.push_back(data);
+        } else {
+            result.neutralNPCs.push_back(MakeTrackedData(record, ENEMY_TIER::LOW, buffer.time));
+        }
+    }
+    // Threat tiers of all enemies in one pass, lanes follow result.enemies
+    ScoreThreats(features, params);
+    for (std::size_t i = 0; i < result.enemies.size(); ++i)
+        result.enemies[i].tier = features.tiers[i];
+    return result;
+}
+}
+
+// Loot planner
+namespace LootPlanner {
+void Build(const Input& input, const Params& params, Plan& plan) {
+    plan.transfers.clear();
+    plan.ruledOut.clear();
+    plan.committed.assign(input.looters.size(), 0.0f);
+    if (input.looters.empty() || params.radius <= 0.0f)
+        return;
+    // Few looters are scanned directly, more are indexed once with one cell per loot radius so a query visits at most 3x3 cells
+    // The grid keeps its storage across passes, rebuilt only when the radius changed
+    bool useGrid = input.looters.size() >= GRID_MIN_LOOTERS;
+    if (plan.grid.CellSize() == params.radius)
+        plan.grid.Clear();
+    else
+        plan.grid = SpatialGrid<std::uint32_t>(params.radius);
+    if (useGrid) {
+        plan.grid.Reserve(input.looters.size());
+        for (std::uint32_t i = 0; i < input.looters.size(); ++i)
+            plan.grid.Insert(input.looters[i].position, i);
+        plan.grid.Build();
+    }
+    float radiusSq = params.radius * params.radius;
+    for (std::uint32_t t = 0; t < input.targets.size(); ++t) {
+        const auto& target = input.targets[t];
+        std::uint32_t closest = NO_LOOTER;
+        float closestDistanceSq = radiusSq;
+        auto consider = [&](std::uint32_t l, float distanceSq) {
+            // Strictly inside the radius
+            if (distanceSq >= radiusSq)
+                return;
+            // Companions in combat or out of carry weight can't evaluate it, it stays pending for a later pass
+            // Weight already assigned in this pass counts against the capacity
+            if (!IsEligible(input.looters[l], plan.committed[l], target, params))
+                return;
+            // Closest wins, the first companion in the snapshot wins ties
+            if (distanceSq < closestDistanceSq || (distanceSq == closestDistanceSq && l < closest)) {
+                closestDistanceSq = distanceSq;
+                closest = l;
+            }
+        };
+        if (useGrid) {
+            plan.grid.ForEachInRadius(target.position, params.radius, consider);
+        } else {
+            for (std::uint32_t l = 0; l < input.looters.size(); ++l)
+                consider(l, DistanceSquared(input.looters[l].position, target.position));
+        }
+        if (closest == NO_LOOTER)
+            continue;
+        // Already ruled out by an earlier verdict, nothing to transfer
+        if (!target.lootable) {
+            plan.ruledOut.push_back(t);
+            continue;
+        }
+        plan.committed[closest] += target.weight;
+        plan.transfers.push_back({t, closest});
+    }
+}
+}
+
+// Loot filter
+namespace LootFilter {
+void VerdictCache::Sync(const CompiledConfig& compiled) {
+    if (compiled.generation == generation && compiled.formsResolved == resolved)
+        return;
+    verdicts.Clear();
+    generation = compiled.generation;
+    resolved = compiled.formsResolved;
+}
+
+const bool* VerdictCache::Find(std::uint32_t formID, const void* form) const {
+    const auto* verdict = verdicts.Find(formID);
+    return verdict && verdict->form == form ? &verdict->loot : nullptr;
+}
+
+void VerdictCache::Insert(std::uint32_t formID, const void* form, bool loot) {
+    verdicts.Insert(formID, Verdict{form, loot});
+}
+}
+
+// Buff engine
+namespace BuffEngine {
+std::uint64_t Signature(std::uint32_t generation, std::uint16_t level, float equippedWeight) {
+    std::uint64_t signature = static_cast<std::uint64_t>(generation) << 48;
+    signature ^= static_cast<std::uint64_t>(level) << 32;
+    signature ^= std::bit_cast<std::uint32_t>(equippedWeight);
+    return signature;
+}
+
+bool SameEntries(const std::vector<BuffEntry>& a, const std::vector<BuffEntry>& b) {
+    return std::equal(a.begin(), a.end(), b.begin(), b.end(), [](const BuffEntry& x, const BuffEntry& y) {
+        return x.actorValue == y.actorValue && x.floor == y.floor && x.modifier == y.modifier;
+    });
+}
+}
+
+// Inventory index
+namespace InventoryCache {
+// Score of a gear entry by the configured ranking
+float ScoreGear(const Entry& entry, GEAR_SCORE scoring) {
+    switch (scoring) {
+    case GEAR_SCORE::RATING:
+        return entry.rating;
+    case GEAR_SCORE::RATING_PER_WEIGHT:
+        return entry.weight > 0.0f ? entry.rating / entry.weight : entry.rating;
+    default:
+        return entry.value;
+    }
+}
+
+// Counts, best gear per slot and power armor pieces in one sweep over the entries
+void BuildIndex(const std::vector<Entry>& entries, Index& index, GEAR_SCORE scoring) {
+    index.counts.Clear();
+    index.counts.Reserve(entries.size());
+    index.bestArmor.fill(-1);
+    index.bestWeapon = -1;
+    index.powerArmorPieces.clear();
+    index.armorEntries.clear();
+    index.scoring = scoring;
+    std::array<float, ARMOR_SLOT_ORDER.size()> bestArmorScore{};
+    float bestWeaponScore = 0.0f;
+    for (std::uint32_t i = 0; i < entries.size(); ++i) {
+        const auto& entry = entries[i];
+        if (!entry.formID)
+            continue;
+        if (auto* itemCount = index.counts.Find(entry.formID))
+            itemCount->count += entry.count;
+        else
+            index.counts.Insert(entry.formID, ItemCount{entry.count, i});
+        // Only a strictly better item replaces the best one, the first wins ties
+        if (entry.kind == ITEM_KIND::ARMOR) {
+            float score = ScoreGear(entry, scoring);
+            // Visit only the slots this item covers
+            for (std::uint32_t bits = entry.slotMask & ARMOR_SLOT_MASK; bits != 0; bits &= bits - 1) {
+                auto slot = ARMOR_SLOT_OF_BIT[std::countr_zero(bits)];
+                if (score > bestArmorScore[slot]) {
+                    bestArmorScore[slot] = score;
+                    index.bestArmor[slot] = static_cast<std::int32_t>(i);
+                }
+            }
+            index.armorEntries.push_back(i);
+            if (entry.powerArmor)
+                index.powerArmorPieces.push_back(i);
+        } else if (entry.kind == ITEM_KIND::WEAPON) {
+            float score = ScoreGear(entry, scoring);
+            if (score > bestWeaponScore) {
+                bestWeaponScore = score;
+                index.bestWeapon = static_cast<std::int32_t>(i);
+            }
+        }
+    }
+    // Resolve multi-slot items in slot order, a slot already covered by a chosen item stays empty
+    std::uint32_t taken = 0;
+    for (std::size_t slot = 0; slot < ARMOR_SLOT_ORDER.size(); ++slot) {
+        std::uint32_t slotMask = 1u << (ARMOR_SLOT_ORDER[slot] - 30);
+        auto& best = index.bestArmor[slot];
+        if (best < 0 || (taken & slotMask) != 0) {
+            best = -1;
+            continue;
+        }
+        // The best item overlaps an earlier choice, take the best one that doesn't
+        if ((entries[best].slotMask & taken) != 0) {
+            best = -1;
+            float bestScore = 0.0f;
+            for (auto entryIndex : index.armorEntries) {
+                const auto& entry = entries[entryIndex];
+                if ((entry.slotMask & slotMask) == 0 || (entry.slotMask & taken) != 0)
+                    continue;
+                float score = ScoreGear(entry, scoring);
+                if (score > bestScore) {
+                    bestScore = score;
+                    best = static_cast<std::int32_t>(entryIndex);
+                }
+            }
+            if (best < 0)
+                continue;
+        }
+        taken |= entries[best].slotMask;
+    }
+}
+
+// Count of a form over all its stacks
+std::int32_t GetCount(const Index& index, std::uint32_t formID) {
+    const auto* itemCount = index.counts.Find(formID);
+    return itemCount ? itemCount->count : 0;
+}
+}
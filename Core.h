@@ -0,0 +1,770 @@
+#pragma once
+#include <PCH.h>
+
+// Engine free parts of the plugin, no CommonLibF4 calls so they also build on the host for the tests and benchmarks
+// Types taken from the engine (RE::NiPoint3, RE::Actor* handles) are only stored and compared, never dereferenced
+
+// --- STRUCTS ---
+
+// Structure to hold all actor states
+struct ActorStateData
+{
+    std::uint32_t lifeState;       // LIFE_STATE (0-8)
+    std::uint32_t weaponState;     // WEAPON_STATE (0-5)
+    std::uint32_t gunState;        // GUN_STATE (0-8)
+    std::uint32_t interactingState; // INTERACTING_STATE (0-3)
+};
+
+// Enemy Tier Classification System
+enum class ENEMY_TIER : std::uint8_t
+{
+    LOW = 0,      // Basic enemies (low health, simple behavior)
+    MEDIUM = 1,   // Standard enemies (moderate threat)
+    HIGH = 2      // Dangerous enemies (bosses, legendaries, high health)
+};
+
+// Enemy combat style flags
+struct EnemyAnalysis
+{
+    ENEMY_TIER tier;
+    float healthPercentOfMax;  // Relative to highest enemy in cell
+    bool isRanged;
+    bool isMelee;
+    bool hasGrenades;
+    bool isUnique;
+    bool isAlerted;
+    bool isLegendary;
+};
+
+// Actor tracking data structure
+struct TrackedActorData
+{
+    RE::Actor* actor;                    // Pointer to the actor
+    std::uint32_t formID;                // Reference FormID of the actor (index key)
+    ENEMY_TIER tier;                     // Threat level (for enemies)
+    bool aiUpdated;                      // Whether AI was updated
+    float distanceToPlayer;              // Distance in units
+    RE::NiPoint3 position;               // Current position
+    std::uint32_t lifeState;             // Current LIFE_STATE
+    std::uint32_t weaponState;           // Current WEAPON_STATE
+    std::uint32_t gunState;              // Current GUN_STATE
+    std::uint32_t interactingState;      // Current INTERACTING_STATE
+    float healthPercent;                 // Current health / max health
+    float maxHealth;                     // Maximum health pool
+    bool isAlerted;                      // In combat/alert state
+    bool isRanged;                       // Uses ranged weapons
+    bool isMelee;                        // Uses melee weapons
+    bool hasGrenades;                    // Can throw grenades
+    bool isUnique;                       // Unique NPC flag
+    bool isLegendary;                    // Legendary enemy flag
+    bool usesStimpak;                    // true = stimpak, false = repair kit
+    std::chrono::steady_clock::time_point lastUpdate;     // Last scan time
+    float velocity;                      // Current velocity
+    int stuckCounter;                    // Consecutive stuck updates
+    bool lost;                           // Whether actor is lost
+};
+
+// Flat open-addressing hash map keyed by FormID (0 is reserved as the empty key)
+// Built once and read many times, lookups are O(1) and allocation free
+template <class T>
+class FormIDMap
+{
+public:
+    // Prepare for count entries without rehashing
+    void Reserve(std::size_t count) {
+        std::size_t capacity = 8;
+        while (capacity < count * 2)
+            capacity <<= 1;
+        if (capacity > keys.size())
+            Rehash(capacity);
+    }
+    // Insert or overwrite a value, returns false for the reserved key 0
+    bool Insert(std::uint32_t key, T value) {
+        if (key == 0)
+            return false;
+        if ((size + 1) * 2 > keys.size())
+            Rehash(keys.empty() ? 8 : keys.size() * 2);
+        std::size_t slot = Probe(key);
+        if (keys[slot] == 0) {
+            keys[slot] = key;
+            size++;
+        }
+        values[slot] = std::move(value);
+        return true;
+    }
+    // Find a value (nullptr if not present)
+    const T* Find(std::uint32_t key) const {
+        if (key == 0 || keys.empty())
+            return nullptr;
+        std::size_t slot = Probe(key);
+        return keys[slot] == key ? &values[slot] : nullptr;
+    }
+    T* Find(std::uint32_t key) {
+        return const_cast<T*>(std::as_const(*this).Find(key));
+    }
+    bool Contains(std::uint32_t key) const { return Find(key) != nullptr; }
+    std::size_t Size() const { return size; }
+    bool Empty() const { return size == 0; }
+    void Clear() {
+        std::fill(keys.begin(), keys.end(), 0u);
+        std::fill(values.begin(), values.end(), T{});
+        size = 0;
+    }
+private:
+    // Fibonacci hashing spreads sequential FormIDs over the table
+    std::size_t Probe(std::uint32_t key) const {
+        std::size_t mask = keys.size() - 1;
+        std::size_t slot = (key * 0x9E3779B1u) & mask;
+        while (keys[slot] != 0 && keys[slot] != key)
+            slot = (slot + 1) & mask;
+        return slot;
+    }
+    void Rehash(std::size_t capacity) {
+        auto oldKeys = std::move(keys);
+        auto oldValues = std::move(values);
+        keys.assign(capacity, 0u);
+        values.assign(capacity, T{});
+        size = 0;
+        for (std::size_t i = 0; i < oldKeys.size(); ++i) {
+            if (oldKeys[i] != 0)
+                Insert(oldKeys[i], std::move(oldValues[i]));
+        }
+    }
+    std::vector<std::uint32_t> keys;
+    std::vector<T> values;
+    std::size_t size = 0;
+};
+
+// Set of FormIDs (FormIDMap<bool> would store a std::vector<bool>, whose elements Find cannot point to)
+using FormIDSet = FormIDMap<std::uint8_t>;
+
+// Loot decision for one form type
+enum class LOOT_RULE : std::uint8_t
+{
+    NEVER = 0,
+    ALWAYS = 1,
+    VALUE = 2      // Value within LOOT_MIN_VALUE and LOOT_MAX_VALUE
+};
+
+// Lookup sets derived from one config generation, built once and shared read-only
+// Membership tests on the hot path are O(1) and allocation free
+struct CompiledConfig
+{
+    std::uint64_t generation = 0;             // Config generation it was built from
+    bool formsResolved = false;               // Built with game data ready, otherwise rebuilt next update
+    FormIDSet excludedActors;                 // EXCLUDE_ACTOR_ID_LIST
+    FormIDSet stimpakRaces;                   // Resolved RACE_STIMPAK_ID races
+    std::vector<RE::BGSPerk*> perks;          // Resolved PERK_ID_LIST
+    std::vector<RE::BGSKeyword*> keywords;    // Resolved KEYWORD_ID_LIST
+    bool lootEnabled = false;                 // LOOT_ENABLED
+    std::array<LOOT_RULE, 256> lootRules{};   // Loot decision per form type (all NEVER without LOOT_ENABLED)
+    std::int32_t lootMinValue = 0;            // LOOT_MIN_VALUE
+    std::int32_t lootMaxValue = 0;            // LOOT_MAX_VALUE
+    FormIDSet lootKeywordAllow;               // Resolved LOOT_KEYWORD_ALLOW keywords
+    FormIDSet lootKeywordDeny;                // Resolved LOOT_KEYWORD_DENY keywords
+};
+
+// One row of the buff table: raise an actor value to a floor
+struct BuffEntry
+{
+    RE::ActorValueInfo* actorValue;      // Actor value to buff
+    float floor;                         // Minimum value the companion should have
+    RE::ACTOR_VALUE_MODIFIER modifier;   // Modifier the missing amount is added to
+    const char* name;                    // Name for the debug log
+};
+
+// Buff table built from the settings, replaced as a whole when the settings change
+struct BuffTable
+{
+    std::uint32_t generation = 0;        // Bumped on every rebuild, part of the companion buff signature
+    std::vector<BuffEntry> entries;
+};
+
+// Squared distance between two points (compare against radius * radius, no sqrt)
+inline float DistanceSquared(const RE::NiPoint3& a, const RE::NiPoint3& b) {
+    float dx = a.x - b.x;
+    float dy = a.y - b.y;
+    float dz = a.z - b.z;
+    return dx * dx + dy * dy + dz * dz;
+}
+
+// Uniform grid over the XY plane for radius queries, built once and read many times
+// Entries are sorted by cell so a query only visits the cells overlapping the radius
+template <class T>
+class SpatialGrid
+{
+public:
+    explicit SpatialGrid(float cellSize = 512.0f) : cellSize(cellSize), invCellSize(1.0f / cellSize) {}
+    // Drop all entries
+    void Clear() {
+        entries.clear();
+        built = true;
+    }
+    void Reserve(std::size_t count) { entries.reserve(count); }
+    float CellSize() const { return cellSize; }
+    // Add an entry, call Build before querying
+    void Insert(const RE::NiPoint3& position, T value) {
+        entries.push_back({CellKey(CellCoord(position.x), CellCoord(position.y)), position, std::move(value)});
+        built = false;
+    }
+    // Sort the entries by cell
+    void Build() {
+        std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.key < b.key; });
+        built = true;
+    }
+    // Call fn(value, distanceSquared) for every entry within radius of center
+    template <class F>
+    void ForEachInRadius(const RE::NiPoint3& center, float radius, F&& fn) const {
+        if (!built || entries.empty() || radius < 0.0f)
+            return;
+        float radiusSq = radius * radius;
+        std::int32_t minX = CellCoord(center.x - radius);
+        std::int32_t maxX = CellCoord(center.x + radius);
+        std::int32_t minY = CellCoord(center.y - radius);
+        std::int32_t maxY = CellCoord(center.y + radius);
+        // The cells of one column are contiguous, one search per column and later columns search from there
+        auto it = entries.begin();
+        for (std::int32_t cx = minX; cx <= maxX; ++cx) {
+            std::uint64_t lastKey = CellKey(cx, maxY);
+            it = std::lower_bound(it, entries.end(), CellKey(cx, minY), [](const Entry& e, std::uint64_t k) { return e.key < k; });
+            for (; it != entries.end() && it->key <= lastKey; ++it) {
+                float distanceSq = DistanceSquared(it->position, center);
+                if (distanceSq <= radiusSq)
+                    fn(it->value, distanceSq);
+            }
+        }
+    }
+    // Check if any entry is within radius of center
+    bool AnyInRadius(const RE::NiPoint3& center, float radius) const {
+        bool found = false;
+        ForEachInRadius(center, radius, [&found](const T&, float) { found = true; });
+        return found;
+    }
+    std::size_t Size() const { return entries.size(); }
+    bool Empty() const { return entries.empty(); }
+private:
+    struct Entry {
+        std::uint64_t key;
+        RE::NiPoint3 position;
+        T value;
+    };
+    std::int32_t CellCoord(float v) const { return static_cast<std::int32_t>(std::floor(v * invCellSize)); }
+    // Sign bits flipped so keys sort like the signed cell coordinates (column, then row)
+    static std::uint64_t CellKey(std::int32_t cx, std::int32_t cy) {
+        return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(cx) ^ 0x80000000u) << 32) | (static_cast<std::uint32_t>(cy) ^ 0x80000000u);
+    }
+    float cellSize;
+    float invCellSize;
+    std::vector<Entry> entries;
+    bool built = true;
+};
+
+// Epochs of the tracked actors, published by the update job
+namespace ActorTracking
+{
+    // Immutable snapshot of all tracked actors for one update (epoch)
+    // Published atomically RCU style, readers keep the epoch alive for as long as they hold the pointer
+    struct Snapshot {
+        std::uint64_t epoch = 0;
+        std::vector<TrackedActorData> companions;
+        std::vector<TrackedActorData> enemies;
+        std::vector<TrackedActorData> neutralNPCs;
+        // Dense per-epoch index: FormID -> position in the list
+        FormIDMap<std::uint32_t> companionIndex;
+        FormIDMap<std::uint32_t> enemyIndex;
+        FormIDMap<std::uint32_t> neutralNPCIndex;
+        // Enemies per ENEMY_TIER, counted once per epoch
+        std::array<std::uint32_t, 3> enemyTierCounts{};
+        // Build the indexes once after the lists are filled
+        void BuildIndex() {
+            auto build = [](const std::vector<TrackedActorData>& list, FormIDMap<std::uint32_t>& index) {
+                index.Reserve(list.size());
+                for (std::uint32_t i = 0; i < list.size(); ++i)
+                    index.Insert(list[i].formID, i);
+            };
+            build(companions, companionIndex);
+            build(enemies, enemyIndex);
+            build(neutralNPCs, neutralNPCIndex);
+            for (const auto& enemy : enemies)
+                enemyTierCounts[static_cast<std::size_t>(enemy.tier)]++;
+        }
+        // Find a companion in this epoch (nullptr if not tracked)
+        const TrackedActorData* FindCompanion(RE::Actor* actor) const { return Find(companions, companionIndex, actor); }
+        // Find a companion by FormID without dereferencing the actor (nullptr if not tracked)
+        const TrackedActorData* FindCompanion(std::uint32_t formID, RE::Actor* actor) const { return Find(companions, companionIndex, formID, actor); }
+        // Find an enemy in this epoch (nullptr if not tracked)
+        const TrackedActorData* FindEnemy(RE::Actor* actor) const { return Find(enemies, enemyIndex, actor); }
+        // Find a neutral NPC in this epoch (nullptr if not tracked)
+        const TrackedActorData* FindNeutralNPC(RE::Actor* actor) const { return Find(neutralNPCs, neutralNPCIndex, actor); }
+    private:
+        static const TrackedActorData* Find(const std::vector<TrackedActorData>& list, const FormIDMap<std::uint32_t>& index, RE::Actor* actor) {
+            return actor ? Find(list, index, actor->GetFormID(), actor) : nullptr;
+        }
+        static const TrackedActorData* Find(const std::vector<TrackedActorData>& list, const FormIDMap<std::uint32_t>& index, std::uint32_t formID, RE::Actor* actor) {
+            if (!actor)
+                return nullptr;
+            const auto* i = index.Find(formID);
+            // Guard against a FormID reused by a different actor object
+            return (i && list[*i].actor == actor) ? &list[*i] : nullptr;
+        }
+    };
+    using SnapshotPtr = std::shared_ptr<const Snapshot>;
+    // Current and previous epoch (never null)
+    extern std::atomic<SnapshotPtr> g_snapshot;
+    extern std::atomic<SnapshotPtr> g_snapshotPrev;
+    // Get the current epoch (zero-copy, thread-safe)
+    inline SnapshotPtr GetSnapshot() {
+        return g_snapshot.load(std::memory_order_acquire);
+    }
+    // Get the previous epoch for frame to frame comparison
+    inline SnapshotPtr GetPreviousSnapshot() {
+        return g_snapshotPrev.load(std::memory_order_acquire);
+    }
+    // Publish a new epoch, the current one becomes the previous epoch (single writer only)
+    inline void PublishSnapshot(std::vector<TrackedActorData> companions, std::vector<TrackedActorData> enemies, std::vector<TrackedActorData> neutralNPCs) {
+        auto current = GetSnapshot();
+        auto next = std::make_shared<Snapshot>();
+        next->epoch = current->epoch + 1;
+        next->companions = std::move(companions);
+        next->enemies = std::move(enemies);
+        next->neutralNPCs = std::move(neutralNPCs);
+        next->BuildIndex();
+        g_snapshotPrev.store(std::move(current), std::memory_order_release);
+        g_snapshot.store(std::move(next), std::memory_order_release);
+    }
+    // Helper to clear stale data
+    inline void ClearAll() {
+        auto empty = std::make_shared<const Snapshot>();
+        g_snapshotPrev.store(empty, std::memory_order_release);
+        g_snapshot.store(empty, std::memory_order_release);
+    }
+}
+
+// Two phase actor scan: a short main thread gather of plain values, then an engine free analysis on the scheduler worker
+namespace ActorPipeline
+{
+    // Weapon classes used for threat scoring
+    enum class WEAPON_CLASS : std::uint8_t
+    {
+        OTHER = 0,
+        MELEE = 1,
+        EXPLOSIVE = 2,
+        RANGED = 3
+    };
+    // Plain copy of one equipped weapon
+    struct GatherWeapon {
+        std::uint32_t formID;
+        std::uint32_t value;
+        float damage;
+        WEAPON_CLASS weaponClass;
+    };
+    inline constexpr std::size_t MAX_GATHER_WEAPONS = 4;
+    // Plain copy of one actor, filled on the main thread
+    struct GatherRecord {
+        RE::Actor* actor;                    // Opaque handle, never dereferenced by the analysis
+        std::uint32_t formID;                // Reference FormID
+        std::uint32_t baseFormID;            // TESNPC FormID
+        std::uint32_t objectFormID;          // Base object FormID
+        RE::NiPoint3 position;               // Current position
+        float distanceToPlayer;              // Distance in units
+        float health;                        // Current health
+        float maxHealth;                     // Permanent health
+        ActorStateData states;               // Life/weapon/gun/interacting states
+        bool hasNPC;                         // Has a TESNPC base
+        bool isDead;                         // IsDead(true)
+        bool isPlayer;                       // Player reference
+        bool isCompanion;                    // In the companion faction
+        bool isHostile;                      // Hostile to the player
+        bool isInCombat;                     // In combat/alert state
+        bool isUnique;                       // Unique NPC flag
+        bool hasLegendTemplate;              // NPC has a legendary template
+        bool hasLegendChance;                // NPC has a legendary chance
+        bool hasLegendaryName;               // Display name contains "Legendary"
+        bool stimpakKnown;                   // usesStimpak below is valid (companions only)
+        bool usesStimpak;                    // true = stimpak, false = repair kit
+        int stuckCounter;                    // Movement loop stuck counter
+        bool lost;                           // Movement loop lost flag
+        std::uint32_t weaponCount;           // Valid entries in weapons
+        std::array<GatherWeapon, MAX_GATHER_WEAPONS> weapons;
+    };
+    // Output of the gather phase
+    struct GatherBuffer {
+        std::vector<GatherRecord> records;
+        std::chrono::steady_clock::time_point time;
+        bool isInSettlement = false;
+    };
+    // Threat points of each WEAPON_CLASS
+    inline constexpr std::array<float, 4> WEAPON_CLASS_THREAT{0.0f, 2.0f, 2.0f, 1.0f};
+    // Per enemy bits of ThreatFeatures::flags
+    namespace THREAT_FLAG
+    {
+        constexpr std::uint32_t HAS_NPC = 1u << 0;
+        constexpr std::uint32_t LEGENDARY_NAME = 1u << 1;
+        constexpr std::uint32_t UNIQUE = 1u << 2;
+        constexpr std::uint32_t ALERTED = 1u << 3;
+    }
+    // Lanes scored together by the SIMD kernel, buffers are padded to a multiple of it
+    inline constexpr std::size_t THREAT_LANES = 4;
+    // Threat scoring inputs in structure of arrays form, one lane per enemy
+    struct ThreatFeatures {
+        std::size_t count = 0;
+        std::vector<float> healthPercent;                                          // Health relative to the strongest enemy
+        std::array<std::vector<float>, MAX_GATHER_WEAPONS> weaponValue;           // 0 for empty weapon slots
+        std::array<std::vector<float>, MAX_GATHER_WEAPONS> weaponDamage;
+        std::array<std::vector<float>, MAX_GATHER_WEAPONS> weaponClassThreat;     // WEAPON_CLASS_THREAT of the weapon
+        std::vector<std::uint32_t> flags;                                          // THREAT_FLAG bits
+        std::vector<ENEMY_TIER> tiers;                                             // Output of ScoreThreats
+        // Drop all lanes and zero room for up to maxLanes enemies, keeps the capacity
+        void Reset(std::size_t maxLanes);
+        // Append one enemy (at most maxLanes since Reset), returns its lane
+        std::size_t Add(const GatherRecord& record, float enemyMaxHealth);
+    };
+    // Settings used by the analysis, copied so the worker reads no globals
+    struct AnalyzeParams {
+        float updateInterval;
+        float fallbackEnemyMaxHealth;        // Used when no enemy has health this update
+        float weaponBonus;
+        float legendaryBonus;
+        float uniqueBonus;
+        float healthBonus;
+        float alertBonus;
+        std::shared_ptr<const CompiledConfig> compiled;
+    };
+    // Output of the analysis phase
+    struct AnalyzeResult {
+        std::vector<TrackedActorData> companions;
+        std::vector<TrackedActorData> enemies;
+        std::vector<TrackedActorData> neutralNPCs;
+        float enemyMaxHealth = 0.0f;
+    };
+    // Pure: check a record against the exclusion list
+    bool IsExcluded(const GatherRecord& record, const AnalyzeParams& params);
+    // Pure: combat style flags of one record (tier left at LOW)
+    EnemyAnalysis DescribeEnemy(const GatherRecord& record, float enemyMaxHealth);
+    // Pure: threat analysis of one enemy record
+    EnemyAnalysis ScoreEnemy(const GatherRecord& record, float enemyMaxHealth, const AnalyzeParams& params);
+    // Pure: threat tier of one lane
+    ENEMY_TIER ScoreThreatLane(const ThreatFeatures& features, std::size_t lane, const AnalyzeParams& params);
+    // Pure: threat tiers of all lanes into features.tiers (SSE2 when available, scalar otherwise)
+    void ScoreThreats(ThreatFeatures& features, const AnalyzeParams& params);
+    // Pure: tracked data of one record
+    TrackedActorData MakeTrackedData(const GatherRecord& record, ENEMY_TIER tier, std::chrono::steady_clock::time_point time);
+    // Pure: classify all records and compute threat tiers against the previous epoch
+    AnalyzeResult Analyze(const GatherBuffer& buffer, const ActorTracking::Snapshot& prev, const AnalyzeParams& params);
+}
+
+// Loot planning: a main thread copy of companions and references, then a pure pass assigning each reference to a companion
+namespace LootPlanner
+{
+    inline constexpr std::uint32_t NO_LOOTER = 0xFFFFFFFF;
+    // Looter count from which Build indexes the looters in Plan::grid, fewer are cheaper to scan
+    inline constexpr std::size_t GRID_MIN_LOOTERS = 32;
+    // Plain copy of one companion
+    struct Looter {
+        RE::Actor* actor;                    // Opaque handle, never dereferenced by the planner
+        RE::NiPoint3 position;
+        float capacity;                      // Carry weight left at the start of the pass
+        bool active;                         // Alive and allowed to loot (not in combat unless LOOT_COMBAT)
+    };
+    // Plain copy of one loot reference
+    struct Target {
+        RE::ObjectRefHandle handle;
+        std::uint32_t formID;
+        RE::NiPoint3 position;
+        float weight;                        // Weight of the reference or its items (0 without LOOT_WEIGHT_LIMIT)
+        bool lootable;                       // False for references that may only be marked visited (owned, LOOT_STEAL off)
+    };
+    // Output of the gather phase
+    struct Input {
+        std::vector<Looter> looters;
+        std::vector<Target> targets;
+    };
+    // Settings used by the planner
+    struct Params {
+        float radius;
+        bool weightLimit;
+    };
+    // One reference to transfer to one companion
+    struct Transfer {
+        std::uint32_t target;                // Index in Input::targets
+        std::uint32_t looter;                // Index in Input::looters
+    };
+    // One item of a reference to move, removals are issued after the inventory walk
+    struct ItemTransfer {
+        RE::TESBoundObject* object;
+        std::int32_t count;
+    };
+    // Batched transfer plan, executed on the main thread
+    struct Plan {
+        std::vector<Transfer> transfers;     // In target (loot) order
+        std::vector<std::uint32_t> ruledOut; // Unlootable targets in radius of an eligible looter, marked visited after the pass
+        std::vector<float> committed;        // Weight assigned per looter
+        SpatialGrid<std::uint32_t> grid;     // Looter indexes (GRID_MIN_LOOTERS or more), storage reused between passes
+    };
+    // Pure: check if a looter may evaluate a target: active and able to carry it on top of this pass
+    inline bool IsEligible(const Looter& looter, float committed, const Target& target, const Params& params) {
+        return looter.active && (!params.weightLimit || committed + target.weight <= looter.capacity);
+    }
+    // Pure: assign every lootable target to the closest eligible looter in radius
+    // Targets without an eligible looter in radius are left out and stay pending
+    void Build(const Input& input, const Params& params, Plan& plan);
+}
+
+// Loot filter: the decision of one base form from the compiled config, cached per form until the config changes
+namespace LootFilter
+{
+    // Pure: loot decision for one base form, keyword lists first, then the form type table
+    // value is only read for LOOT_RULE::VALUE, keyword(i) returns the FormID of keyword i (0 for none)
+    template <class Keyword>
+    bool Evaluate(std::uint8_t formType, std::int32_t value, std::uint32_t keywordCount, Keyword&& keyword, const CompiledConfig& compiled) {
+        if (!compiled.lootEnabled)
+            return false;
+        // Denied keywords win over allowed ones
+        if (keywordCount && !(compiled.lootKeywordAllow.Empty() && compiled.lootKeywordDeny.Empty())) {
+            bool allowed = false;
+            for (std::uint32_t i = 0; i < keywordCount; ++i) {
+                std::uint32_t keywordID = keyword(i);
+                if (!keywordID)
+                    continue;
+                if (compiled.lootKeywordDeny.Contains(keywordID))
+                    return false;
+                allowed = allowed || compiled.lootKeywordAllow.Contains(keywordID);
+            }
+            if (allowed)
+                return true;
+        }
+        switch (compiled.lootRules[formType]) {
+        case LOOT_RULE::ALWAYS:
+            return true;
+        case LOOT_RULE::VALUE:
+            // Weapons and armor, items without a value are never looted
+            return value && value >= compiled.lootMinValue && value <= compiled.lootMaxValue;
+        default:
+            return false;
+        }
+    }
+    // Verdicts of one compiled config, dropped on a new generation or once the forms resolve
+    class VerdictCache
+    {
+    public:
+        // Drop the verdicts if they were made with another config
+        void Sync(const CompiledConfig& compiled);
+        // Cached verdict of a base form, nullptr if unknown or the FormID now names another form
+        const bool* Find(std::uint32_t formID, const void* form) const;
+        void Insert(std::uint32_t formID, const void* form, bool loot);
+        std::size_t Size() const { return verdicts.Size(); }
+
+    private:
+        struct Verdict {
+            const void* form;                // Guards against a reused FormID
+            bool loot;
+        };
+        FormIDMap<Verdict> verdicts;
+        std::uint64_t generation = 0;
+        bool resolved = false;
+    };
+}
+
+// Buff engine: the table is built from the settings on the main thread, applied per companion with engine reads and writes
+namespace BuffEngine
+{
+    // Pure: signature of what the buffs depend on: table generation, level and equipped gear
+    std::uint64_t Signature(std::uint32_t generation, std::uint16_t level, float equippedWeight);
+    // Pure: check if two tables buff the same values to the same floors
+    bool SameEntries(const std::vector<BuffEntry>& a, const std::vector<BuffEntry>& b);
+    // Raise every value of the table to its floor unless the stored signature matches (nothing changed since the last pass)
+    // Read(const ActorValueInfo&) returns the current value, Modify(modifier, const ActorValueInfo&, delta) adds to it
+    // Returns false if the actor was skipped without reading any value
+    template <class Read, class Modify>
+    bool Apply(const BuffTable& table, std::uint64_t signature, std::atomic<std::uint64_t>* stored, Read&& read, Modify&& modify) {
+        if (stored && stored->load(std::memory_order_relaxed) == signature)
+            return false;
+        for (const auto& buff : table.entries) {
+            float current = read(*buff.actorValue);
+            // Add exactly the missing amount to hit the floor
+            if (current < buff.floor)
+                modify(buff.modifier, *buff.actorValue, buff.floor - current);
+        }
+        if (stored)
+            stored->store(signature, std::memory_order_relaxed);
+        return true;
+    }
+}
+
+// Per-actor index of the inventory: counts, best gear per slot and power armor pieces built in one sweep
+namespace InventoryCache
+{
+    // Armor slots in equip order (body first)
+    inline constexpr std::array<int, 7> ARMOR_SLOT_ORDER = {33, 30, 41, 42, 43, 44, 45};
+    // Position in ARMOR_SLOT_ORDER for each biped bit (-1 if not equipped by us)
+    inline constexpr std::array<std::int8_t, 32> ARMOR_SLOT_OF_BIT = []() {
+        std::array<std::int8_t, 32> slots{};
+        slots.fill(-1);
+        for (std::size_t i = 0; i < ARMOR_SLOT_ORDER.size(); ++i)
+            slots[ARMOR_SLOT_ORDER[i] - 30] = static_cast<std::int8_t>(i);
+        return slots;
+    }();
+    // All biped bits of ARMOR_SLOT_ORDER
+    inline constexpr std::uint32_t ARMOR_SLOT_MASK = []() {
+        std::uint32_t mask = 0;
+        for (int slot : ARMOR_SLOT_ORDER)
+            mask |= 1u << (slot - 30);
+        return mask;
+    }();
+    enum class ITEM_KIND : std::uint8_t
+    {
+        OTHER = 0,
+        ARMOR,
+        WEAPON
+    };
+    // How gear is ranked (AI_EQUIP_SCORE)
+    enum class GEAR_SCORE : std::uint8_t
+    {
+        VALUE = 0,              // Gold value
+        RATING,                 // Armor rating or weapon damage
+        RATING_PER_WEIGHT       // Rating per weight unit
+    };
+    // One inventory entry as seen by the index (plain data, no engine access)
+    struct Entry {
+        std::uint32_t formID = 0;
+        ITEM_KIND kind = ITEM_KIND::OTHER;
+        std::uint32_t slotMask = 0;          // Armor biped slots
+        float value = 0.0f;                  // Gold value
+        float rating = 0.0f;                 // Armor rating or weapon damage
+        float weight = 0.0f;
+        std::int32_t count = 0;
+        bool powerArmor = false;             // Power armor piece (not the frame)
+    };
+    // Count of a form and the first entry holding it
+    struct ItemCount {
+        std::int32_t count = 0;
+        std::uint32_t entry = 0;
+    };
+    // Everything the companion systems look up in an inventory
+    struct Index {
+        FormIDMap<ItemCount> counts;                        // By FormID, includes ammo
+        std::array<std::int32_t, ARMOR_SLOT_ORDER.size()> bestArmor{};  // Entry per slot, -1 if none
+        std::int32_t bestWeapon = -1;                       // Entry, -1 if none
+        std::vector<std::uint32_t> powerArmorPieces;        // Entries of power armor pieces
+        std::vector<std::uint32_t> armorEntries;            // Entries of all armor, for slot conflicts
+        // Inventory state the index was built from
+        GEAR_SCORE scoring = GEAR_SCORE::VALUE;
+        bool valid = false;
+        const void* data = nullptr;
+        std::uint32_t size = 0;
+    };
+    // Pure: score of a gear entry, higher is better
+    float ScoreGear(const Entry& entry, GEAR_SCORE scoring);
+    // Pure: build the index from the inventory entries in one sweep
+    // Multi-slot armor claims all its slots, later slots only pick items that don't overlap
+    void BuildIndex(const std::vector<Entry>& entries, Index& index, GEAR_SCORE scoring);
+    // Pure: count of a form (0 if not present)
+    std::int32_t GetCount(const Index& index, std::uint32_t formID);
+}
+
+// --- HOOKS ---
+
+// Shared scheduler to run all periodic jobs on a single worker thread
+// Jobs tick on absolute deadlines (deadline += interval) so they do not drift
+class CCB_Scheduler {
+public:
+    using Clock = std::chrono::steady_clock;
+    using JobId = std::uint32_t;
+    static constexpr JobId INVALID_JOB = 0;
+    // Per job timing statistics
+    struct JobStats {
+        std::uint64_t ticks = 0;              // Number of callbacks run
+        std::uint64_t skipped = 0;            // Deadlines skipped because the job fell behind
+        Clock::duration maxLateness{};        // Worst wake-up delay after the deadline (jitter)
+        Clock::duration totalLateness{};      // Sum of wake-up delays
+        Clock::duration maxRunTime{};         // Worst callback duration
+        Clock::duration totalRunTime{};       // Sum of callback durations (CPU cost)
+    };
+    CCB_Scheduler() = default;
+    ~CCB_Scheduler() { Stop(); }
+    CCB_Scheduler(const CCB_Scheduler&) = delete;
+    CCB_Scheduler& operator=(const CCB_Scheduler&) = delete;
+    // Start the worker thread (no-op if already running or called from a job of a loop that is stopping)
+    void Start();
+    // Stop the worker thread, wait for it to exit and drop all jobs (called from a job, the loop exits once it returns)
+    void Stop();
+    bool IsRunning() const { return running.load(); }
+    // Add a periodic job, the first tick is one interval from now
+    JobId AddJob(const char* name, Clock::duration interval, std::function<void()> callback);
+    // Run a callback once on the worker thread as soon as possible
+    JobId Post(const char* name, std::function<void()> callback);
+    // Remove a job, a callback already running will still finish
+    void RemoveJob(JobId id);
+    // Change the interval of a job, the next deadline is rebased on now
+    void SetInterval(JobId id, Clock::duration interval);
+    // Get a copy of the timing statistics of a job
+    std::optional<JobStats> GetStats(JobId id);
+private:
+    struct Job {
+        JobId id;
+        const char* name;
+        Clock::duration interval;
+        Clock::time_point deadline;
+        std::function<void()> callback;
+        JobStats stats;
+        bool oneShot = false;
+    };
+    void Run();
+    std::mutex mutex;
+    std::condition_variable wakeUp;
+    std::vector<std::shared_ptr<Job>> jobs;
+    std::thread worker;
+    std::atomic<bool> running{false};
+    JobId nextJobId = 1;
+};
+
+// Convert a float seconds setting to a scheduler duration
+inline CCB_Scheduler::Clock::duration SecondsToDuration(float seconds) {
+    return std::chrono::duration_cast<CCB_Scheduler::Clock::duration>(std::chrono::duration<float>(seconds));
+}
+
+// Change notifications of one directory, the platform part of CCB_FileWatcher
+class CCB_FileWatchBackend {
+public:
+    enum class WAIT : std::uint8_t {
+        CHANGE,     // Something in the directory changed (notification consumed)
+        TIMEOUT,
+        STOPPED,    // Interrupt was called
+        FAILED
+    };
+    static constexpr std::chrono::milliseconds FOREVER{-1};
+    virtual ~CCB_FileWatchBackend() = default;
+    // Start receiving notifications for a directory
+    virtual bool Open(const std::string& directory) = 0;
+    // Wait for the next notification, only called from the watcher thread
+    virtual WAIT Wait(std::chrono::milliseconds timeout) = 0;
+    // Any thread: wake up the watcher thread, every later Wait returns STOPPED
+    virtual void Interrupt() = 0;
+};
+
+// Backend of the platform: change notifications on Windows, inotify on Linux (nullptr elsewhere)
+std::unique_ptr<CCB_FileWatchBackend> MakeFileWatchBackend();
+
+// Watches a directory for change notifications and calls back once a burst of changes has settled
+// Editors often write a temp file and rename it, the debounce turns that into a single callback
+class CCB_FileWatcher {
+public:
+    using Callback = std::function<void()>;
+    CCB_FileWatcher() = default;
+    ~CCB_FileWatcher() { Stop(); }
+    CCB_FileWatcher(const CCB_FileWatcher&) = delete;
+    CCB_FileWatcher& operator=(const CCB_FileWatcher&) = delete;
+    // Start watching a directory, returns false if notifications are not available
+    bool Start(const std::string& directory, std::chrono::milliseconds debounce, Callback callback);
+    // Start watching with a given backend
+    bool Start(std::unique_ptr<CCB_FileWatchBackend> watchBackend, const std::string& directory, std::chrono::milliseconds debounce, Callback callback);
+    // Stop the watcher thread and wait for it to exit
+    void Stop();
+    bool IsRunning() const { return running.load(); }
+private:
+    void Run(std::chrono::milliseconds debounce);
+    std::thread worker;
+    std::unique_ptr<CCB_FileWatchBackend> backend;
+    std::atomic<bool> running{false};
+    Callback callback;
+};
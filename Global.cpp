@@ -16,6 +16,9 @@ UPDATE_INTERVAL=3.0
 INI_RELOAD_INTERVAL=0
 ; Actor search radius around the player in game units.
 ACTOR_SEARCH_RADIUS=4000.0
+; Main thread time budget per frame in milliseconds.
+; Companion work is split into small slices and spread over several frames to avoid stutter.
+FRAME_BUDGET_MS=0.5
 
 ; --- AI Settings ---
 ; Configure AI settings
@@ -30,6 +33,8 @@ AI_EQUIP_ITEMS=true                ; Enable armor, weapon and ammo equipping for
 AI_EQUIP_GEAR=false                ; Allow companions to equip the best armor and weapons from inventory (be careful in conjunction with looting)
 AI_EQUIP_AMMO_REFILL=true          ; Supply ammunition to the companion for the equipped weapon
 AI_EQUIP_AMMO_AMOUNT=50            ; Minimum Amount of ammunition companions always have for their equipped weapon
+AI_EQUIP_AMMO_AMOUNT_AUTOMATIC=150 ; Minimum Amount for automatic weapons (never less than one full magazine)
+AI_EQUIP_SCORE=0                   ; How the best gear is picked: 0 = gold value, 1 = armor rating / weapon damage, 2 = rating per weight
 ; Movement
 ; A fast update loop runs at 10hz to monitor companion movement.
 AI_STUCK_CHECK=true                ; Enable stuck check for companions
@@ -93,6 +98,10 @@ LOOT_MIN_VALUE=0                   ; Loot armor/weapons above this value
 LOOT_MAX_VALUE=9999                ; Loot armor/weapons under this value
 LOOT_STEAL=false                   ; Commit a crime when looting items
 LOOT_WEIGHT_LIMIT=true             ; Companions stop looting when they reach their carry weight limit
+; Keyword lists for weapons, armor, junk, ammunition and aid items (repeatable, one keyword FormID per line)
+; Items with a denied keyword are never looted, items with an allowed keyword are looted regardless of the type and value settings
+;LOOT_KEYWORD_ALLOW=00000000        ; Always loot items with this keyword
+;LOOT_KEYWORD_DENY=00000000         ; Never loot items with this keyword
 
 ; --- Companion XP Settings ---
 ; Enable XP gain for companion kills
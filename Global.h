@@ -1,6 +1,8 @@
 #pragma once
 #include <PCH.h>
 
+#include <Config.h>
+#include <Core.h>
 #include <Plugin.h>
 
 // Helper function to convert string to lowercase
@@ -28,156 +30,92 @@ extern const F4SE::TaskInterface *g_taskInterface;
 // --- Global Variables ---
 // Expose config load function
 void LoadConfig();
-// Timers
-extern CCB_RepeatingTimer g_updateTimer;
-extern CCB_RepeatingTimer g_movementTimer;
+// Scheduler running the periodic update jobs
+extern CCB_Scheduler g_scheduler;
+// Written by StartScheduler, read by the config publisher and the update job on other threads
+extern std::atomic<CCB_Scheduler::JobId> g_updateJob;
+extern std::atomic<CCB_Scheduler::JobId> g_movementJob;
+// Coalescing queue for main thread work
+extern CCB_MainThreadQueue g_mainThreadQueue;
+// Fast movement loop interval (10hz)
+inline constexpr auto MOVEMENT_INTERVAL = std::chrono::milliseconds(100);
+// Watcher for INI edits in the plugin directory
+extern CCB_FileWatcher g_configWatcher;
+// Quiet time after the last change notification before the INI is checked
+inline constexpr auto CONFIG_WATCH_DEBOUNCE = std::chrono::milliseconds(250);
+// How long a locked container is skipped by the loot pass (there is no lock change event to clear it)
+inline constexpr auto LOOT_SKIP_LOCKED_TTL = std::chrono::seconds(30);
+// How long a cached teleport ground sample is trusted (doors and moving platforms change the ground)
+inline constexpr auto PROBE_GROUND_TTL = std::chrono::seconds(10);
 // --- User Settings ---
 // Default ini file
 extern const char *defaultIni;
-// Global debug flag
-extern bool DEBUGGING;
+// Shared ownership of one config generation, freed when the last job holding it is done
+using ConfigPtr = std::shared_ptr<const Config>;
+// Latest published config
+extern std::atomic<ConfigPtr> g_config;
+// Generation of the latest published config, lets unpinned readers skip the shared_ptr load
+extern std::atomic<std::uint64_t> g_configGeneration;
+// Config pinned on this thread, a job reads one generation from start to end
+extern thread_local ConfigPtr g_pinnedConfig;
+// Latest config seen by this thread outside of a pin, kept alive until the thread sees a newer generation
+extern thread_local ConfigPtr g_threadConfig;
+// Current settings: the pinned config, otherwise the latest one
+// Unpinned references are only valid until the next Cfg() call after a reload, hold a ConfigScope to keep them longer
+inline const Config &Cfg()
+{
+    if (const Config *pinned = g_pinnedConfig.get())
+        return *pinned;
+    if (!g_threadConfig || g_threadConfig->generation != g_configGeneration.load(std::memory_order_acquire))
+        g_threadConfig = g_config.load(std::memory_order_acquire);
+    return *g_threadConfig;
+}
+// Current settings captured by work that runs later, the generation stays alive as long as the work holds it
+inline ConfigPtr GetConfig()
+{
+    return g_pinnedConfig ? g_pinnedConfig : g_config.load(std::memory_order_acquire);
+}
+// Pin a config on this thread for the scope, nullptr pins the latest one
+class ConfigScope
+{
+public:
+    explicit ConfigScope(ConfigPtr config = nullptr) : previous(std::move(g_pinnedConfig))
+    {
+        g_pinnedConfig = config ? std::move(config) : g_config.load(std::memory_order_acquire);
+    }
+    ~ConfigScope()
+    {
+        g_pinnedConfig = std::move(previous);
+    }
+    ConfigScope(const ConfigScope &) = delete;
+    ConfigScope &operator=(const ConfigScope &) = delete;
+private:
+    ConfigPtr previous;
+};
+// Publish a new config generation and apply its side effects
+ConfigPtr PublishConfig(Config next);
+// Reload the INI if its size, time or content changed, returns true if a new config was published
+bool ReloadConfigIfChanged();
+// Global debug flag (mirrors Cfg().DEBUGGING for the logging checks)
+extern std::atomic<bool> DEBUGGING;
 // Current game time
 extern float CURRENT_GAME_TIME;
-// Global update interval (in seconds)
-extern float UPDATE_INTERVAL;
-// Read the ini every x updates (0 = only on game start)
-extern int INI_RELOAD_INTERVAL;
-// Actor search radius around the player in game units
-extern float ACTOR_SEARCH_RADIUS;
-// AI behavior settings
-extern float AI_HEALTH_THRESHOLD;
-extern bool AI_USE_STIMPAK;
-extern bool AI_USE_STIMPAK_UNLIMITED;
-extern bool AI_AUTO_REVIVE;
-extern bool AI_FLEE_COMBAT;
-extern float AI_FLEE_DISTANCE;
-extern bool AI_EQUIP_ITEMS;
-extern bool AI_EQUIP_GEAR;
-extern bool AI_EQUIP_AMMO_REFILL;
-extern int AI_EQUIP_AMMO_AMOUNT;
-// Movement settings
-extern bool AI_STUCK_CHECK;
-extern int AI_STUCK_THRESHOLD;
-extern int AI_STUCK_COLLISIONS;
-extern float AI_STUCK_SPEED;
-extern float AI_STUCK_DISTANCE;
-// Aggression settings
-extern bool AI_AGGRESSION_ENABLED;
-extern bool AI_AGGRESSION_ALL;
-extern bool AI_AGGRESSION_SNEAK;
-extern float AI_AGGRESSION_RADIUS0;
-extern float AI_AGGRESSION_RADIUS1;
-extern float AI_AGGRESSION_RADIUS2;
-// Chatter settings
-extern bool CHATTER_ENABLED;
-extern float CHATTER_MULTIPLIER;
-extern float CHATTER_MULTIPLIER_SNEAK;
-// Combat AI settings
-extern bool COMBAT_ENABLED;
-extern int COMBAT_TARGET;
-extern float COMBAT_OFFENSIVE;
-extern float COMBAT_DEFENSIVE;
-extern float COMBAT_RANGED;
-extern float COMBAT_MELEE;
-// Ranged
-extern float COMBAT_RANGED_ADJUSTMENT;
-extern float COMBAT_RANGED_CROUCHING;
-extern float COMBAT_RANGED_STRAFE;
-extern float COMBAT_RANGED_WAITING;
-extern float COMBAT_RANGED_ACCURACY;
-// Close-Quarters
-extern float COMBAT_CLOSE_FALLBACK;
-extern float COMBAT_CLOSE_CIRCLE;
-extern float COMBAT_CLOSE_DISENGAGE;
-extern float COMBAT_CLOSE_FLANK;
-extern int COMBAT_CLOSE_THROW_GRENADE;
-// Cover
-extern float COMBAT_COVER_DISTANCE;
-// Loot item filter flag
-extern bool LOOT_ENABLED;
-extern bool LOOT_COMBAT;
-extern float LOOT_RADIUS;
-extern bool LOOT_JUNK;
-extern bool LOOT_AMMO;
-extern bool LOOT_AID;
-extern int LOOT_MIN_VALUE;
-extern int LOOT_MAX_VALUE;
-extern bool LOOT_STEAL;
-extern bool LOOT_WEIGHT_LIMIT;
-// XP gain settings
-extern bool XP_ENABLED;
-extern float XP_RATIO;
-extern float XP_KILLER_TOLERANCE;
-// Buff settings
-extern bool BUFF_ENABLED;
-extern float BUFF_HEAL_RATE;
-extern float BUFF_COMBAT_HEAL_RATE;
-extern float BUFF_DAMAGE_RESIST;
-extern float BUFF_FIRE_RESIST;
-extern float BUFF_ELECTRICAL_RESIST;
-extern float BUFF_FROST_RESIST;
-extern float BUFF_ENERGY_RESIST;
-extern float BUFF_POISON_RESIST;
-extern float BUFF_RADIATION_RESIST;
-// Buff attribute settings
-extern float BUFF_AGILITY;
-extern float BUFF_ENDURANCE;
-extern float BUFF_INTELLIGENCE;
-extern float BUFF_LOCKPICK;
-extern float BUFF_LUCK;
-extern float BUFF_PERCEPTION;
-extern float BUFF_SNEAK;
-extern float BUFF_STRENGTH;
-extern float BUFF_CARRYWEIGHT;
-// Power Armor Settings
-extern bool PA_ENABLED;
-extern float PA_REPAIR_AMOUNT;
-// Perk settings
-extern bool PERK_ENABLED;
-extern std::vector<std::uint32_t> PERK_ID_LIST;
-extern std::vector<RE::BGSPerk *> g_perkList;
-// --- Keyword settings ---
-extern bool KEYWORD_ENABLED;
-extern std::vector<std::uint32_t> KEYWORD_ID_LIST;
-extern std::vector<RE::BGSKeyword *> g_keywordList;
-// --- Actor Exclusion List ---
-// List of Actor FormIDs to exclude from mod effects
-extern std::vector<std::uint32_t> EXCLUDE_ACTOR_ID_LIST;
-// Threat score weights
-extern float THREAT_WEAPON_BONUS;
-extern float THREAT_LEGENDARY_BONUS;
-extern float THREAT_UNIQUE_BONUS;
-extern float THREAT_HEALTH_BONUS;
-extern float THREAT_ALERT_BONUS;
+// Recent ammunition top-up passes (main thread only)
+extern RingBuffer<AmmoTopUpStats, 64> g_ammoHistory;
+// Buff table built from the buff settings
+extern std::atomic<std::shared_ptr<const BuffTable>> g_buffTable;
+// Lookup sets and resolved lists built from the current config generation
+extern std::atomic<std::shared_ptr<const CompiledConfig>> g_compiledConfig;
 // --- DATA ---
-// Current companion faction ID
-extern std::uint32_t CURRENT_COMPANION_FACTION_ID;
+// Forms resolved from the config IDs
 extern RE::TESFaction *g_companionFaction;
-// ActorValue for HC downed state
-extern std::uint32_t ACTORVALUE_HC_DOWNED_ID;
 extern RE::ActorValueInfo *g_actorValueHCDowned;
-// Item forms
-extern std::uint32_t ITEM_STIMPAK_ID;
 extern RE::TESForm *g_itemStimpak;
-// Repair Kit
-extern std::uint32_t ITEM_REPAIRKIT_ID;
 extern RE::TESForm *g_itemRepairKit;
-// Race forms for stimpak users
-extern std::vector<std::uint32_t> RACE_STIMPAK_ID;
-extern std::vector<RE::TESRace *> g_raceStimpak;
-// Synth 3 component
-extern std::uint32_t RACE_SYNTH3C_ID;
 extern RE::TESObjectMISC *g_raceSynth3C;
-// IDLE animations
-extern std::uint32_t IDLE_STIMPAK_ID;
 extern RE::TESIdleForm *g_idleStimpak;
-// Keywords
-extern std::uint32_t KYWD_ARMORTYPEPOWER_ID;
 extern RE::BGSKeyword* g_kwdArmorTypePower;
-extern std::uint32_t KYWD_ISPOWERARMORFRAME_ID;
 extern RE::BGSKeyword* g_kwdIsPowerArmorFrame;
-// Packages
-extern std::uint32_t PACK_FOLLOWERSCOMPANION_ID;
 extern RE::TESPackage* g_packFollowersCompanion;
 
 // REX Logging Compatibility
@@ -26,22 +26,41 @@ using namespace std::literals;
 #include <algorithm>
 #include <array>
 #include <atomic>
+#include <bit>
+#include <charconv>
+#include <chrono>
+#include <condition_variable>
 #include <cstdint>
 #include <cstdio>
 #include <exception>
 #include <filesystem>
+#include <fstream>
 #include <functional>
+#include <limits>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <new>
 #include <optional>
 #include <span>
 #include <string>
 #include <string_view>
+#include <thread>
+#include <unordered_map>
 #include <unordered_set>
 #include <utility>
 #include <vector>
 #include <windows.h>
 
+// --- SIMD ---
+// SSE2 is part of x64, other targets use the scalar kernels
+#if defined(_M_X64) || defined(__SSE2__)
+#define CCB_SSE2 1
+#include <emmintrin.h>
+#else
+#define CCB_SSE2 0
+#endif
+
 // --- Fixes ---
 // STD FORMATTER RE::BSFixedString
 #include <format>
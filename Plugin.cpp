@@ -2,33 +2,21 @@
 #include <PCH.h>
 
 // --- VARIABLES ---
-// Actor Tracking variables
-namespace ActorTracking {
-std::mutex g_actorDataMutex;
-std::vector<TrackedActorData> g_enemies;
-std::vector<TrackedActorData> g_companions;
-std::vector<TrackedActorData> g_neutralNPCs;
-std::vector<TrackedActorData> g_enemies_prev;
-std::vector<TrackedActorData> g_companions_prev;
-std::vector<TrackedActorData> g_neutralNPCs_prev;
-} // namespace ActorTracking
 // companion flags storage
 std::mutex ActorTracking::g_companionFlagsMutex;
-std::unordered_map<RE::Actor*, ActorTracking::CompanionFlags> ActorTracking::g_companionFlags;
+std::array<ActorTracking::CompanionFlags, ActorTracking::MAX_COMPANION_SLOTS> ActorTracking::g_companionFlags;
 // Reload interval counter
 int g_iniReloadCounter = 0;
 // Global for max enemy health in cell initialized to 1.0 to avoid division by zero
 std::atomic<float> g_enemyMaxHealthInCell = 1.0f;
 // Global settlement flag
 bool g_isInSettlement = false;
-// Main thread work pending flag
-std::atomic<bool> g_isMainThreadWorkPending = false;
 
 // --- EVENTS ---
 
 // Event handler for companion kill enemy events
 RE::BSEventNotifyControl CompanionKillEventSink::ProcessEvent(const RE::TESDeathEvent& a_event, RE::BSTEventSource<RE::TESDeathEvent>* a_eventSource) {
-    if (!XP_ENABLED)
+    if (!Cfg().XP_ENABLED)
         return RE::BSEventNotifyControl::kContinue;
     if (!a_event.actorDying || !a_event.actorKiller) {
         return RE::BSEventNotifyControl::kContinue;
@@ -44,14 +32,13 @@ RE::BSEventNotifyControl CompanionKillEventSink::ProcessEvent(const RE::TESDeath
     if (!victim->GetHostileToActor(player)) {
         return RE::BSEventNotifyControl::kContinue;
     }
-    // Make a local copy under mutex protection
-    // Copy companion data
-    auto companionDataCopy = ActorTracking::GetCompanionData();
+    // Zero-copy view of the current epoch
+    auto snapshot = ActorTracking::GetSnapshot();
     // Find the companion who is closest to the killer (i.e., likely the firing companion)
     auto victimPos = victim->GetPosition();
     RE::Actor* closestCompanion = nullptr;
-    float closestDistance = FLT_MAX;
-    for (auto& companionData : companionDataCopy) {
+    float closestDistanceSq = FLT_MAX;
+    for (const auto& companionData : snapshot->companions) {
         auto* companion = companionData.actor;
         if (!companion)
             continue;
@@ -61,15 +48,15 @@ RE::BSEventNotifyControl CompanionKillEventSink::ProcessEvent(const RE::TESDeath
         // Check if companion is in combat
         if (!companion->IsInCombat())
             continue;
-        // Calculate distance between COMPANION and VICTIM position
-        float distance = companion->GetPosition().GetDistance(victimPos);
-        if (distance < closestDistance) {
-            closestDistance = distance;
+        // Calculate squared distance between COMPANION and VICTIM position
+        float distanceSq = DistanceSquared(companion->GetPosition(), victimPos);
+        if (distanceSq < closestDistanceSq) {
+            closestDistanceSq = distanceSq;
             closestCompanion = companion;
         }
     }
     // Check if we found a firing companion
-    if (closestCompanion && closestDistance < XP_KILLER_TOLERANCE) {
+    if (closestCompanion && closestDistanceSq < Cfg().XP_KILLER_TOLERANCE * Cfg().XP_KILLER_TOLERANCE) {
         // Companion kill - award XP!
         if (DEBUGGING) {
             REX::INFO("-------------------- Companion Kill Detected --------------------");
@@ -79,7 +66,7 @@ RE::BSEventNotifyControl CompanionKillEventSink::ProcessEvent(const RE::TESDeath
         auto* victimNPC = victim->GetNPC();
         if (victimNPC && victimNPC->actorData.level > 0) {
             auto difficultyLevel = player->GetDifficultyLevel();
-            float awardedXP = victimNPC->actorData.level * 5.0f * XP_RATIO;
+            float awardedXP = victimNPC->actorData.level * 5.0f * Cfg().XP_RATIO;
             auto experienceReward = RE::GamePlayFormulas::GetExperienceReward(RE::GamePlayFormulas::EXPERIENCE_ACTIVITY::kKillNPC, difficultyLevel, awardedXP);
             player->RewardExperience(experienceReward, true, victim, nullptr);
             if (DEBUGGING) {
@@ -91,60 +78,106 @@ RE::BSEventNotifyControl CompanionKillEventSink::ProcessEvent(const RE::TESDeath
     return RE::BSEventNotifyControl::kContinue;
 }
 
+// Event handler for loaded cells, queue their references for the loot catalogue
+RE::BSEventNotifyControl LootCatalogueEventSink::ProcessEvent(const RE::TESCellFullyLoadedEvent& a_event, RE::BSTEventSource<RE::TESCellFullyLoadedEvent>* a_eventSource) {
+    if (Cfg().LOOT_ENABLED && a_event.cell)
+        LootTracking::QueueCell(a_event.cell->GetFormID());
+    return RE::BSEventNotifyControl::kContinue;
+}
+
+// Event handler for container changes, queue the containers and dropped items for the loot catalogue
+RE::BSEventNotifyControl LootCatalogueEventSink::ProcessEvent(const RE::TESContainerChangedEvent& a_event, RE::BSTEventSource<RE::TESContainerChangedEvent>* a_eventSource) {
+    // Inventory indexes of both sides are stale
+    InventoryCache::Invalidate(a_event.sourceContainerFormID);
+    InventoryCache::Invalidate(a_event.targetContainerFormID);
+    if (!Cfg().LOOT_ENABLED)
+        return RE::BSEventNotifyControl::kContinue;
+    LootTracking::QueueReference(a_event.sourceContainerFormID);
+    LootTracking::QueueReference(a_event.targetContainerFormID);
+    // Item dropped into the world as its own reference
+    if (!a_event.targetContainerFormID)
+        LootTracking::QueueReference(a_event.referenceFormID);
+    return RE::BSEventNotifyControl::kContinue;
+}
+
+// Event handler for deaths, the corpse becomes a loot candidate
+RE::BSEventNotifyControl LootCatalogueEventSink::ProcessEvent(const RE::TESDeathEvent& a_event, RE::BSTEventSource<RE::TESDeathEvent>* a_eventSource) {
+    if (Cfg().LOOT_ENABLED && a_event.actorDying)
+        LootTracking::QueueReference(a_event.actorDying->GetFormID());
+    return RE::BSEventNotifyControl::kContinue;
+}
+
 // --- FUNCTIONS ---
 
 // Main Update function
 void Update_Internal() {
-    // Quick check to ensure we are in a game session
-    g_taskInterface->AddTask([]() {
-        auto* player = RE::PlayerCharacter::GetSingleton();
-        if (!player || !player->parentCell) {
-            // Not in a game session, skip update and cancel timer
-            if (DEBUGGING)
-                REX::INFO("Update_Internal: Not in a game session, skipping update and stopping timer.");
-            g_updateTimer.Stop();
-            return;
-        }
-    });
-    // Reload INI settings if the interval is set
-    if (INI_RELOAD_INTERVAL > 0) {
+    // Check the INI for changes if the interval is set (fallback when the file watcher is not running)
+    if (Cfg().INI_RELOAD_INTERVAL > 0 && !g_configWatcher.IsRunning()) {
         g_iniReloadCounter++;
-        if (g_iniReloadCounter >= INI_RELOAD_INTERVAL) {
-            // Load config
-            LoadConfig();
+        if (g_iniReloadCounter >= Cfg().INI_RELOAD_INTERVAL) {
+            // Only reparses when the file changed
+            bool reloaded = ReloadConfigIfChanged();
             // Reset counter
             g_iniReloadCounter = 0;
-            if (DEBUGGING)
+            if (reloaded && DEBUGGING)
                 REX::INFO("Update_Internal: Reloaded INI configuration.");
         }
     }
+    // The rest of the tick (and the work it queues) reads one config generation
+    ConfigScope configScope;
     // Initialize the global variables in case the game data wasn't ready yet
     InitializeVariables_Internal();
+    // Make sure the global pointers are initialized
+    if (!g_companionFaction) {
+        // Try to get the TESFaction this is only run once per session
+        g_companionFaction = GetFormByFileAndID_Internal<RE::TESFaction>(Cfg().CURRENT_COMPANION_FACTION_ID);
+    }
+    if (!g_taskInterface)
+        return;
+    // Phase one: copy the actor data on the main thread while the game is not mutating it
+    g_mainThreadQueue.Submit(MAIN_JOB::GATHER, ActorTracking::GetSnapshot()->epoch, []() {
+        // Quick check to ensure we are in a game session
+        auto* player = RE::PlayerCharacter::GetSingleton();
+        if (!player || !player->parentCell) {
+            // Not in a game session, skip update and cancel the update job
+            if (DEBUGGING)
+                REX::INFO("Update_Internal: Not in a game session, skipping update and stopping the update job.");
+            g_scheduler.RemoveJob(g_updateJob);
+            return true;
+        }
+        auto buffer = std::make_shared<ActorPipeline::GatherBuffer>();
+        ActorPipeline::Gather(*buffer);
+        // Phase two: analyze the copy on the scheduler worker
+        g_scheduler.Post("Analyze", [buffer, config = GetConfig()]() {
+            ConfigScope configScope(config);
+            UpdateAnalyze_Internal(*buffer);
+        });
+        return true;
+    });
+}
+
+// Second half of the update, runs on the scheduler worker with the gathered actor data
+void UpdateAnalyze_Internal(const ActorPipeline::GatherBuffer& buffer) {
     // Continue with update
     if (DEBUGGING)
         REX::INFO("========================================================================");
-    // Check if this is a settlement cell
-    g_isInSettlement = CheckIsCurrentCellSettlement_Internal();
+    // Settlement state of the current cell (checked during the gather)
+    g_isInSettlement = buffer.isInSettlement;
     if (DEBUGGING)
         REX::INFO("Update_Internal: Info - Current cell is {}a settlement.", g_isInSettlement ? "" : "not ");
     if (DEBUGGING)
         REX::INFO("-----------------------------------------------------------------------");
     if (DEBUGGING)
         REX::INFO("Update_Internal: -------- Starting background work. --------");
-    // Make sure the global pointers are initialized
-    if (!g_companionFaction) {
-        // Try to get the TESFaction this is only run once per session
-        g_companionFaction = GetFormByFileAndID_Internal<RE::TESFaction>(CURRENT_COMPANION_FACTION_ID);
-    }
     // Update global actor arrays and calculate threat levels
-    int actorCount = UpdateGlobalActorArrays_Internal();
+    int actorCount = UpdateGlobalActorArrays_Internal(buffer);
     if (DEBUGGING)
         REX::INFO("Update_Internal: Actors - Found a total of {} actors in the current cell.", actorCount);
     if (DEBUGGING)
         REX::INFO("Update_Internal: -------- Background work completed --------");
     // Log the counts of tracked actors and current threat tier distribution
-    auto companionData = ActorTracking::GetCompanionData();
-    if (companionData.size() == 0) {
+    auto snapshot = ActorTracking::GetSnapshot();
+    if (snapshot->companions.empty()) {
         if (DEBUGGING)
             REX::INFO("Update_Internal: No companions detected, skipping main thread functions.");
         if (DEBUGGING)
@@ -152,109 +185,125 @@ void Update_Internal() {
         return;
     }
     if (DEBUGGING) {
-        auto neutralData = ActorTracking::GetNeutralNPCData();
-        auto enemyData = ActorTracking::GetEnemyData();
-        auto enemyTierCounts = EnemyActorAnalyzeThreatLevel_Internal(enemyData);
-        REX::INFO("Update_Internal: Actors - Current actor tracking summary:");
-        REX::INFO("  - Companions: {}", companionData.size());
-        REX::INFO("  - Neutral NPCs: {}", neutralData.size());
-        REX::INFO("  - Enemies: {}", enemyData.size());
+        auto enemyTierCounts = EnemyActorAnalyzeThreatLevel_Internal(*snapshot);
+        REX::INFO("Update_Internal: Actors - Current actor tracking summary (epoch {}):", snapshot->epoch);
+        REX::INFO("  - Companions: {}", snapshot->companions.size());
+        REX::INFO("  - Neutral NPCs: {}", snapshot->neutralNPCs.size());
+        REX::INFO("  - Enemies: {}", snapshot->enemies.size());
         REX::INFO("    - Low Tier: {}", enemyTierCounts[ENEMY_TIER::LOW]);
         REX::INFO("    - Medium Tier: {}", enemyTierCounts[ENEMY_TIER::MEDIUM]);
         REX::INFO("    - High Tier: {}", enemyTierCounts[ENEMY_TIER::HIGH]);
+        // Scheduler tick jitter and cost
+        for (auto [jobName, jobId] : {std::pair{"Update", g_updateJob.load()}, std::pair{"Movement", g_movementJob.load()}}) {
+            auto stats = g_scheduler.GetStats(jobId);
+            if (!stats || stats->ticks == 0)
+                continue;
+            using us = std::chrono::duration<double, std::micro>;
+            REX::INFO("Update_Internal: Scheduler - {} job: ticks={}, skipped={}, jitter avg={:.1f}us max={:.1f}us, run avg={:.1f}us max={:.1f}us", jobName, stats->ticks, stats->skipped, us(stats->totalLateness).count() / stats->ticks, us(stats->maxLateness).count(), us(stats->totalRunTime).count() / stats->ticks, us(stats->maxRunTime).count());
+        }
     }
     if (DEBUGGING)
         REX::INFO("-----------------------------------------------------------------------");
-    // Only modify game data on the main thread
-    if (g_taskInterface && !g_isMainThreadWorkPending) {
-        g_isMainThreadWorkPending = true;
-        g_taskInterface->AddTask([]() {
-            // Threadsafe work
-            if (DEBUGGING)
-                REX::INFO("Update_Internal: -------- Running functions on the main thread. --------");
-            if (AI_AGGRESSION_ENABLED) {
-                if (DEBUGGING)
-                    REX::INFO("-----------------------------------------------------------------------");
-                if (DEBUGGING)
-                    REX::INFO("Update_Internal: Aggression - Updating companion aggression states...");
-                ApplyAIAggression_Internal();
-                if (DEBUGGING)
-                    REX::INFO("-----------------------------------------------------------------------");
-            }
-            // Buff Companions
-            if (BUFF_ENABLED) {
-                if (DEBUGGING)
-                    REX::INFO("-----------------------------------------------------------------------");
-                if (DEBUGGING)
-                    REX::INFO("Update_Internal: Buff - Buffing companions...");
-                BuffCompanions_Internal();
-                if (DEBUGGING)
-                    REX::INFO("-----------------------------------------------------------------------");
-            }
-            if (PERK_ENABLED) {
-                if (DEBUGGING)
-                    REX::INFO("-----------------------------------------------------------------------");
-                if (DEBUGGING)
-                    REX::INFO("Update_Internal: Perk - Applying perks to companions...");
-                ApplyPerksToCompanions_Internal();
-                if (DEBUGGING)
-                    REX::INFO("-----------------------------------------------------------------------");
-            }
-            if (KEYWORD_ENABLED) {
-                if (DEBUGGING)
-                    REX::INFO("-----------------------------------------------------------------------");
-                if (DEBUGGING)
-                    REX::INFO("Update_Internal: Keyword - Applying keywords to companions...");
-                ApplyKeywordsToCompanions_Internal();
-                if (DEBUGGING)
-                    REX::INFO("-----------------------------------------------------------------------");
-            }
-            // Loot items by companions if enabled and not in settlement and the player is not in a menu (like container or inventory)
-            if (LOOT_ENABLED && !g_isInSettlement && !IsInventoryMenuOpen_Internal()) {
+    // Only modify game data on the main thread, a subsystem still pending from an older epoch is replaced
+    // Each job handles one companion (or loot reference) per slice, spread over frames by FRAME_BUDGET_MS
+    auto epoch = snapshot->epoch;
+    // Action Companions based on their states (revive and stimpaks come first)
+    g_mainThreadQueue.Submit(MAIN_JOB::ACTION, epoch, MakeCompanionSliceJob(snapshot, [first = true](const TrackedActorData& companionData) mutable {
+        if (first && DEBUGGING)
+            REX::INFO("Update_Internal: Action - Actioning companions...");
+        first = false;
+        ActionCompanions_Internal(companionData);
+    }));
+    if (Cfg().AI_AGGRESSION_ENABLED) {
+        g_mainThreadQueue.Submit(MAIN_JOB::AGGRESSION, epoch, MakeCompanionSliceJob(snapshot, [first = true](const TrackedActorData& companionData) mutable {
+            if (first && DEBUGGING)
+                REX::INFO("Update_Internal: Aggression - Updating companion aggression states...");
+            first = false;
+            ApplyAIAggression_Internal(companionData);
+        }));
+    }
+    // Equip best items for companions, ammunition for all companions in the first slice, then gear one companion per slice
+    if (Cfg().AI_EQUIP_ITEMS) {
+        g_mainThreadQueue.Submit(MAIN_JOB::EQUIP, epoch, [snapshot, index = std::size_t{0}, started = false]() mutable {
+            if (!started) {
                 if (DEBUGGING)
-                    REX::INFO("-----------------------------------------------------------------------");
-                if (DEBUGGING)
-                    REX::INFO("Update_Internal: Loot - Looting items by companions...");
-                auto itemcount = LootItems_Internal();
-                if (DEBUGGING)
-                    REX::INFO("Update_Internal: Loot - Looted a total of {} objects by companions.", itemcount);
-                if (DEBUGGING)
-                    REX::INFO("-----------------------------------------------------------------------");
-            }
-            // Equip best items for companions
-            if (AI_EQUIP_ITEMS) {
-                if (DEBUGGING)
-                    REX::INFO("-----------------------------------------------------------------------");
-                if (AI_EQUIP_GEAR) {
-                    if (DEBUGGING)
-                        REX::INFO("Update_Internal: Equip - Equipping best armor and weapons for companions...");
-                    EquipCompanions_Internal();
-                }
-                if (AI_EQUIP_AMMO_REFILL) {
-                    if (DEBUGGING)
-                        REX::INFO("Update_Internal: Equip - Equipping ammunition for companions...");
-                    EquipAmmunition_Internal();
-                }
+                    REX::INFO("Update_Internal: Equip - Equipping best gear and ammunition for companions...");
+                started = true;
+                if (Cfg().AI_EQUIP_AMMO_REFILL)
+                    EquipAmmunition_Internal(snapshot->companions);
+                return !Cfg().AI_EQUIP_GEAR || snapshot->companions.empty();
+            }
+            if (index < snapshot->companions.size())
+                EquipCompanions_Internal(snapshot->companions[index++]);
+            return index >= snapshot->companions.size();
+        });
+    }
+    // Buff Companions
+    if (Cfg().BUFF_ENABLED) {
+        g_mainThreadQueue.Submit(MAIN_JOB::BUFF, epoch, MakeCompanionSliceJob(snapshot, [first = true](const TrackedActorData& companionData) mutable {
+            if (first && DEBUGGING)
+                REX::INFO("Update_Internal: Buff - Buffing companions...");
+            first = false;
+            BuffCompanions_Internal(companionData);
+        }));
+    }
+    if (Cfg().PERK_ENABLED) {
+        g_mainThreadQueue.Submit(MAIN_JOB::PERK, epoch, MakeCompanionSliceJob(snapshot, [first = true](const TrackedActorData& companionData) mutable {
+            if (first && DEBUGGING)
+                REX::INFO("Update_Internal: Perk - Applying perks to companions...");
+            first = false;
+            ApplyPerksToCompanions_Internal(companionData);
+        }));
+    }
+    if (Cfg().KEYWORD_ENABLED) {
+        g_mainThreadQueue.Submit(MAIN_JOB::KEYWORD, epoch, MakeCompanionSliceJob(snapshot, [first = true](const TrackedActorData& companionData) mutable {
+            if (first && DEBUGGING)
+                REX::INFO("Update_Internal: Keyword - Applying keywords to companions...");
+            first = false;
+            ApplyKeywordsToCompanions_Internal(companionData);
+        }));
+    }
+    // Loot items by companions if enabled and not in settlement, planned in the first slice, then one transfer per slice
+    // The pass owns its buffers, StartScheduler drops them with the queued job
+    if (Cfg().LOOT_ENABLED && !g_isInSettlement) {
+        g_mainThreadQueue.Submit(MAIN_JOB::LOOT, epoch, [snapshot, catalogue = LootCatalogue(), input = LootPlanner::Input(), plan = LootPlanner::Plan(), items = std::vector<LootPlanner::ItemTransfer>(), index = std::size_t{0}, started = false, looted = 0]() mutable {
+            if (!started) {
+                // Not while the player is in a menu (like container or inventory)
+                if (IsInventoryMenuOpen_Internal())
+                    return true;
+                // Only the references changed since the last pass, sorted into corpses, containers and loose items
+                LootBuildCatalogue_Internal(catalogue);
+                LootPlanner::Gather(*snapshot, catalogue, input);
+                LootPlanner::Build(input, LootPlanner::MakeParams(), plan);
                 if (DEBUGGING)
-                    REX::INFO("-----------------------------------------------------------------------");
+                    REX::INFO("Update_Internal: Loot - Looting items by companions ({} corpses, {} containers, {} loose items, {} planned transfers)...", catalogue.Size(LOOT_BUCKET::CORPSE), catalogue.Size(LOOT_BUCKET::CONTAINER), catalogue.Size(LOOT_BUCKET::LOOSE), plan.transfers.size());
+                started = true;
+            }
+            if (index < plan.transfers.size() && LootExecuteTransfer_Internal(input, plan.transfers[index++], catalogue, items))
+                looted++;
+            if (index < plan.transfers.size())
+                return false;
+            // References without an eligible companion in range stay changed for a later pass
+            LootMarkVisited_Internal(input, plan);
+            if (DEBUGGING) {
+                const auto& skipStats = LootTracking::g_skipStats;
+                auto lookups = skipStats.hits + skipStats.misses;
+                REX::INFO("Update_Internal: Loot - Looted a total of {} objects by companions (skip memo: {} hits, {} misses, {:.1f}% hit rate, {} stored).", looted, skipStats.hits, skipStats.misses, lookups ? 100.0 * skipStats.hits / lookups : 0.0, skipStats.stored);
             }
-            // Action Companions based on their states
-            if (DEBUGGING)
-                REX::INFO("-----------------------------------------------------------------------");
-            if (DEBUGGING)
-                REX::INFO("Update_Internal: Action - Actioning companions...");
-            ActionCompanions_Internal();
-            if (DEBUGGING)
-                REX::INFO("-----------------------------------------------------------------------");
-            if (DEBUGGING)
-                REX::INFO("Update_Internal: -------- Finished main thread work. --------");
-            if (DEBUGGING)
-                REX::INFO("========================================================================");
+            return true;
         });
-        g_isMainThreadWorkPending = false;
-    } else {
-        if (DEBUGGING)
-            REX::INFO("Update_Internal: Main thread work still pending, skipping main thread functions this update.");
+    }
+    if (DEBUGGING) {
+        auto queueStats = g_mainThreadQueue.GetStats();
+        using ms = std::chrono::duration<double, std::milli>;
+        REX::INFO("Update_Internal: Main thread queue - depth={}, oldest={:.1f}ms, submitted={}, coalesced={}, executed={}, wait avg={:.1f}ms max={:.1f}ms, frames={}, over budget={}", queueStats.depth, ms(queueStats.oldestAge).count(), queueStats.submitted, queueStats.coalesced, queueStats.executed, queueStats.executed ? ms(queueStats.totalWait).count() / queueStats.executed : 0.0, ms(queueStats.maxWait).count(), queueStats.frames, queueStats.overBudget);
+        static constexpr std::array<const char*, static_cast<std::size_t>(MAIN_JOB::COUNT)> jobNames = {"Gather", "Action", "Aggression", "Equip", "Buff", "Perk", "Keyword", "Loot"};
+        for (std::size_t i = 0; i < jobNames.size(); ++i) {
+            const auto& sliceStats = queueStats.slices[i];
+            if (sliceStats.slices == 0)
+                continue;
+            REX::INFO("  - {} slices: count={}, avg={:.3f}ms, max={:.3f}ms", jobNames[i], sliceStats.slices, ms(sliceStats.totalTime).count() / sliceStats.slices, ms(sliceStats.maxTime).count());
+        }
     }
 }
 
@@ -263,272 +312,281 @@ void ActionCompanions_Internal() {
     if (DEBUGGING)
         REX::INFO("ActionCompanions_Internal: Function called.");
     // Go over our companions
-    auto companionDataCopy = ActorTracking::GetCompanionData();
-    for (auto& companionData : companionDataCopy) {
-        auto* comp = companionData.actor;
-        if (!comp)
-            continue;
-        auto* compInv = comp->inventoryList;
-        if (!compInv)
-            continue;
-        auto* player = RE::PlayerCharacter::GetSingleton();
-        if (!player)
-            continue;
-        // Action flags
-        bool usedStimpak = false;
-        bool fleeCombat = false;
-        RE::TESIdleForm* idleToPlay = nullptr;
-        // Pre-Check if the companion is out of action
-        if (CheckActorStatesMatch_Internal(comp, ACTOR_STATE::DEAD, ACTOR_STATE::ANY, ACTOR_STATE::ANY, ACTOR_STATE::ANY) 
-            || CheckActorStatesMatch_Internal(comp, ACTOR_STATE::BLEEDOUT, ACTOR_STATE::ANY, ACTOR_STATE::ANY, ACTOR_STATE::ANY) 
-            || CheckActorStatesMatch_Internal(comp, ACTOR_STATE::ESSENTIAL_DOWN, ACTOR_STATE::ANY, ACTOR_STATE::ANY, ACTOR_STATE::ANY)) {
-            if (AI_AUTO_REVIVE) {
-                // Attempt to revive the companion
-                if (companionData.usesStimpak) {
-                    auto* invStimpak = ActorAddInventoryItem_Internal(comp, g_itemStimpak, 1);
-                    if (DEBUGGING)
-                        REX::INFO("ActionCompanions_Internal: Revive - Attempting to auto-revive human companion {} using a stimpak...", comp->GetDisplayFullName());
-                    if (!invStimpak) {
-                        if (DEBUGGING)
-                            REX::WARN("ActionCompanions_Internal: Revive - Failed to add Stimpak to companion {}'s inventory for auto-revive.", comp->GetDisplayFullName());
-                        continue;
-                    }
-                    // Heal and revive
-                    HealActorHealth_Internal(comp, 100.0f);
-                    HealActorLimbs_Internal(comp);
-                    // Important to clear the HC downed flag
-                    HealActorDowned_Internal(comp);
-                    // Make it use the stimpak to get back up
-                    EquipInventoryItem_Internal(comp, invStimpak);
-                    // No more processing in this update needed, continue to next companion
-                    continue;
-                } else {
-                    auto* invRepairKit = ActorAddInventoryItem_Internal(comp, g_itemRepairKit, 1);
+    auto snapshot = ActorTracking::GetSnapshot();
+    for (const auto& companionData : snapshot->companions)
+        ActionCompanions_Internal(companionData);
+}
+
+// Action Companions based on their states (single companion slice)
+void ActionCompanions_Internal(const TrackedActorData& companionData) {
+    auto* comp = companionData.actor;
+    if (!comp)
+        return;
+    auto* compInv = comp->inventoryList;
+    if (!compInv)
+        return;
+    auto* player = RE::PlayerCharacter::GetSingleton();
+    if (!player)
+        return;
+    // Action flags
+    bool usedStimpak = false;
+    bool fleeCombat = false;
+    RE::TESIdleForm* idleToPlay = nullptr;
+    // Pre-Check if the companion is out of action
+    if (CheckActorStatesMatch_Internal(comp, ACTOR_STATE::DEAD, ACTOR_STATE::ANY, ACTOR_STATE::ANY, ACTOR_STATE::ANY) 
+        || CheckActorStatesMatch_Internal(comp, ACTOR_STATE::BLEEDOUT, ACTOR_STATE::ANY, ACTOR_STATE::ANY, ACTOR_STATE::ANY) 
+        || CheckActorStatesMatch_Internal(comp, ACTOR_STATE::ESSENTIAL_DOWN, ACTOR_STATE::ANY, ACTOR_STATE::ANY, ACTOR_STATE::ANY)) {
+        if (Cfg().AI_AUTO_REVIVE) {
+            // Attempt to revive the companion
+            if (companionData.usesStimpak) {
+                auto* invStimpak = ActorAddInventoryItem_Internal(comp, g_itemStimpak, 1);
+                if (DEBUGGING)
+                    REX::INFO("ActionCompanions_Internal: Revive - Attempting to auto-revive human companion {} using a stimpak...", comp->GetDisplayFullName());
+                if (!invStimpak) {
                     if (DEBUGGING)
-                        REX::INFO("ActionCompanions_Internal: Revive - Attempting to auto-revive non-human companion {} using a repair kit...", comp->GetDisplayFullName());
-                    if (!invRepairKit) {
-                        if (DEBUGGING)
-                            REX::WARN("ActionCompanions_Internal: Revive - Failed to add Repair Kit to companion {}'s inventory for auto-revive.", comp->GetDisplayFullName());
-                        continue;
-                    }
-                    // Heal and revive
-                    HealActorHealth_Internal(comp, 100.0f);
-                    HealActorLimbs_Internal(comp);
-                    // Important to clear the HC downed flag
-                    HealActorDowned_Internal(comp);
-                    // Make it use the repair kit to get back up
-                    EquipInventoryItem_Internal(comp, invRepairKit);
-                    // No more processing in this update needed, continue to next companion
-                    continue;
+                        REX::WARN("ActionCompanions_Internal: Revive - Failed to add Stimpak to companion {}'s inventory for auto-revive.", comp->GetDisplayFullName());
+                    return;
                 }
-                if (DEBUGGING)
-                    REX::INFO("ActionCompanions_Internal: Revive - Companion {} was revived automatically.", comp->GetDisplayFullName());
+                // Heal and revive
+                HealActorHealth_Internal(comp, 100.0f);
+                HealActorLimbs_Internal(comp);
+                // Important to clear the HC downed flag
+                HealActorDowned_Internal(comp);
+                // Make it use the stimpak to get back up
+                EquipInventoryItem_Internal(comp, invStimpak);
+                // No more processing in this update needed, continue to next companion
+                return;
             } else {
+                auto* invRepairKit = ActorAddInventoryItem_Internal(comp, g_itemRepairKit, 1);
                 if (DEBUGGING)
-                    REX::INFO("ActionCompanions_Internal: Revive - Actor {} is out of action. Skipping...", comp->GetDisplayFullName());
-                continue;
+                    REX::INFO("ActionCompanions_Internal: Revive - Attempting to auto-revive non-human companion {} using a repair kit...", comp->GetDisplayFullName());
+                if (!invRepairKit) {
+                    if (DEBUGGING)
+                        REX::WARN("ActionCompanions_Internal: Revive - Failed to add Repair Kit to companion {}'s inventory for auto-revive.", comp->GetDisplayFullName());
+                    return;
+                }
+                // Heal and revive
+                HealActorHealth_Internal(comp, 100.0f);
+                HealActorLimbs_Internal(comp);
+                // Important to clear the HC downed flag
+                HealActorDowned_Internal(comp);
+                // Make it use the repair kit to get back up
+                EquipInventoryItem_Internal(comp, invRepairKit);
+                // No more processing in this update needed, continue to next companion
+                return;
             }
+            if (DEBUGGING)
+                REX::INFO("ActionCompanions_Internal: Revive - Companion {} was revived automatically.", comp->GetDisplayFullName());
+        } else {
+            if (DEBUGGING)
+                REX::INFO("ActionCompanions_Internal: Revive - Actor {} is out of action. Skipping...", comp->GetDisplayFullName());
+            return;
         }
-        // Logging
-        RE::TESForm* pkgForm = nullptr;
+    }
+    // Logging
+    RE::TESForm* pkgForm = nullptr;
+    if (comp->currentProcess) {
+        auto* runningPackage = comp->currentProcess->GetPackageThatIsRunning();
+        pkgForm = runningPackage ? runningPackage : nullptr;
+    }
+    if (DEBUGGING) {
+        REX::INFO("ActionCompanions_Internal: Logging - Processing companion {} with race {}...", comp->GetDisplayFullName(), comp->race ? comp->race->GetFullName() : "Unknown");
+        REX::INFO("ActionCompanions_Internal: Logging - Actor={} runningPkgID=0x{:08X} packageTypeName={}", comp->GetDisplayFullName(), pkgForm ? pkgForm->GetFormID() : 0, pkgForm && pkgForm->GetObjectTypeName());
         if (comp->currentProcess) {
-            auto* runningPackage = comp->currentProcess->GetPackageThatIsRunning();
-            pkgForm = runningPackage ? runningPackage : nullptr;
-        }
-        if (DEBUGGING) {
-            REX::INFO("ActionCompanions_Internal: Logging - Processing companion {} with race {}...", comp->GetDisplayFullName(), comp->race ? comp->race->GetFullName() : "Unknown");
-            REX::INFO("ActionCompanions_Internal: Logging - Actor={} runningPkgID=0x{:08X} packageTypeName={}", comp->GetDisplayFullName(), pkgForm ? pkgForm->GetFormID() : 0, pkgForm && pkgForm->GetObjectTypeName());
-            if (comp->currentProcess) {
-                REX::INFO("ActionCompanions_Internal: Logging - followTarget==player? {} ; escortingPlayer={}, inCombat={}", (comp->currentProcess->followTarget == player->GetActorHandle()) ? "yes" : "no", comp->currentProcess->escortingPlayer ? "true" : "false", comp->IsInCombat() ? "true" : "false");
-            }
-            REX::INFO("ActionCompanions_Internal: Logging - The companions velocity is {:.2f} and is currently stuck: {}", ActorTracking::GetActorVelocityFast(comp), ActorTracking::GetActorStuckStatusFast(comp) ? "yes" : "no");
-            REX::INFO("ActionCompanions_Internal: Logging - The companion is stuck for {} updates.", ActorTracking::GetActorStuckCounterFast(comp));
+            REX::INFO("ActionCompanions_Internal: Logging - followTarget==player? {} ; escortingPlayer={}, inCombat={}", (comp->currentProcess->followTarget == player->GetActorHandle()) ? "yes" : "no", comp->currentProcess->escortingPlayer ? "true" : "false", comp->IsInCombat() ? "true" : "false");
         }
-        // Check if interacting
-        if (CheckActorStatesMatch_Internal(comp, ACTOR_STATE::ALIVE, ACTOR_STATE::ANY, ACTOR_STATE::ANY, ACTOR_STATE::INTERACTING)) {
-            if (DEBUGGING)
-                REX::INFO("ActionCompanions_Internal: Interacting - Actor {} is interacting. Skipping...", comp->GetDisplayFullName());
-            continue;
-        }
-        // Stimpak: The companion is in combat or alerted and low on health
-        if (companionData.isAlerted && companionData.healthPercent * 100.0f <= AI_HEALTH_THRESHOLD) {
-            if (DEBUGGING)
-                REX::INFO("ActionCompanions_Internal: Stimpak - Companion {} is alerted and low on health ({:.1f}%), checking for Stimpak or repair kit use...", comp->GetDisplayFullName(), companionData.healthPercent * 100.0f);
-            if (AI_USE_STIMPAK_UNLIMITED || (CheckActorHasItem_Internal(comp, g_itemStimpak) && companionData.usesStimpak) || (CheckActorHasItem_Internal(comp, g_itemRepairKit) && !companionData.usesStimpak)) {
-                // Remove a Stimpak from the inventory if not set to unlimited
-                if (!AI_USE_STIMPAK_UNLIMITED && companionData.usesStimpak) {
-                    ActorRemoveInventoryItem_Internal(comp, g_itemStimpak, 1);
-                } else if (!AI_USE_STIMPAK_UNLIMITED && !companionData.usesStimpak) {
-                    ActorRemoveInventoryItem_Internal(comp, g_itemRepairKit, 1);
-                }
-                // Unlimited Stimpak use
-                HealActorHealth_Internal(comp, 100.0f);
-                HealActorLimbs_Internal(comp);
-                usedStimpak = true;
-                idleToPlay = g_idleStimpak;
+        REX::INFO("ActionCompanions_Internal: Logging - The companions velocity is {:.2f} and is currently stuck: {}", ActorTracking::GetActorVelocityFast(comp), ActorTracking::GetActorStuckStatusFast(comp) ? "yes" : "no");
+        REX::INFO("ActionCompanions_Internal: Logging - The companion is stuck for {} updates.", ActorTracking::GetActorStuckCounterFast(comp));
+    }
+    // Check if interacting
+    if (CheckActorStatesMatch_Internal(comp, ACTOR_STATE::ALIVE, ACTOR_STATE::ANY, ACTOR_STATE::ANY, ACTOR_STATE::INTERACTING)) {
+        if (DEBUGGING)
+            REX::INFO("ActionCompanions_Internal: Interacting - Actor {} is interacting. Skipping...", comp->GetDisplayFullName());
+        return;
+    }
+    // Stimpak: The companion is in combat or alerted and low on health
+    if (companionData.isAlerted && companionData.healthPercent * 100.0f <= Cfg().AI_HEALTH_THRESHOLD) {
+        if (DEBUGGING)
+            REX::INFO("ActionCompanions_Internal: Stimpak - Companion {} is alerted and low on health ({:.1f}%), checking for Stimpak or repair kit use...", comp->GetDisplayFullName(), companionData.healthPercent * 100.0f);
+        if (Cfg().AI_USE_STIMPAK_UNLIMITED || (CheckActorHasItem_Internal(comp, g_itemStimpak) && companionData.usesStimpak) || (CheckActorHasItem_Internal(comp, g_itemRepairKit) && !companionData.usesStimpak)) {
+            // Remove a Stimpak from the inventory if not set to unlimited
+            if (!Cfg().AI_USE_STIMPAK_UNLIMITED && companionData.usesStimpak) {
+                ActorRemoveInventoryItem_Internal(comp, g_itemStimpak, 1);
+            } else if (!Cfg().AI_USE_STIMPAK_UNLIMITED && !companionData.usesStimpak) {
+                ActorRemoveInventoryItem_Internal(comp, g_itemRepairKit, 1);
+            }
+            // Unlimited Stimpak use
+            HealActorHealth_Internal(comp, 100.0f);
+            HealActorLimbs_Internal(comp);
+            usedStimpak = true;
+            idleToPlay = g_idleStimpak;
+            if (DEBUGGING)
+                REX::INFO("ActionCompanions_Internal: Stimpak - Companion {} used stimpak or repair kit! Health was at {:.1f}%", comp->GetDisplayFullName(), companionData.healthPercent * 100.0f);
+        } else {
+            if (Cfg().AI_FLEE_COMBAT) {
+                fleeCombat = true;
                 if (DEBUGGING)
-                    REX::INFO("ActionCompanions_Internal: Stimpak - Companion {} used stimpak or repair kit! Health was at {:.1f}%", comp->GetDisplayFullName(), companionData.healthPercent * 100.0f);
+                    REX::INFO("ActionCompanions_Internal: Stimpak - Companion {} wants to use a Stimpak or repair kit but has none, will flee combat!", comp->GetDisplayFullName());
             } else {
-                if (AI_FLEE_COMBAT) {
-                    fleeCombat = true;
-                    if (DEBUGGING)
-                        REX::INFO("ActionCompanions_Internal: Stimpak - Companion {} wants to use a Stimpak or repair kit but has none, will flee combat!", comp->GetDisplayFullName());
-                } else {
-                    if (DEBUGGING)
-                        REX::INFO("ActionCompanions_Internal: Stimpak - Companion {} wanted to use a Stimpak or repair kit but has none! Companion is not allowed to flee.", comp->GetDisplayFullName());
-                }
-            }
-        }
-        // Power Armor healing
-        if (PA_ENABLED) {
-            if (RE::PowerArmor::ActorInPowerArmor(*comp)) {
                 if (DEBUGGING)
-                    REX::INFO("ActionCompanions_Internal: Power Armor - Healing companion {} in Power Armor...", comp->GetDisplayFullName());
-                HealActorPA_Internal(comp);
+                    REX::INFO("ActionCompanions_Internal: Stimpak - Companion {} wanted to use a Stimpak or repair kit but has none! Companion is not allowed to flee.", comp->GetDisplayFullName());
             }
         }
-        // Chatter multiplier adjustment
-        if (CHATTER_ENABLED) {
+    }
+    // Power Armor healing
+    if (Cfg().PA_ENABLED) {
+        if (RE::PowerArmor::ActorInPowerArmor(*comp)) {
             if (DEBUGGING)
-                REX::INFO("ActionCompanions_Internal: Chatter - Setting chatter multiplier for companion {}...", comp->GetDisplayFullName());
-            SetCompanionChatter_Internal(comp);
+                REX::INFO("ActionCompanions_Internal: Power Armor - Healing companion {} in Power Armor...", comp->GetDisplayFullName());
+            HealActorPA_Internal(comp);
         }
-        // Set Combat AI only if enabled
-        if (COMBAT_ENABLED) {
-            if (DEBUGGING)
-                REX::INFO("ActionCompanions_Internal: Combat AI - Setting combat AI for companion {}...", comp->GetDisplayFullName());
-            auto* compCombatStyle = comp->GetCombatStyle();
-            if (compCombatStyle) {
-                SetCompanionCombatAI_Internal(comp, compCombatStyle);
-            }
+    }
+    // Chatter multiplier adjustment
+    if (Cfg().CHATTER_ENABLED) {
+        if (DEBUGGING)
+            REX::INFO("ActionCompanions_Internal: Chatter - Setting chatter multiplier for companion {}...", comp->GetDisplayFullName());
+        SetCompanionChatter_Internal(comp);
+    }
+    // Set Combat AI only if enabled
+    if (Cfg().COMBAT_ENABLED) {
+        if (DEBUGGING)
+            REX::INFO("ActionCompanions_Internal: Combat AI - Setting combat AI for companion {}...", comp->GetDisplayFullName());
+        auto* compCombatStyle = comp->GetCombatStyle();
+        if (compCombatStyle) {
+            SetCompanionCombatAI_Internal(comp, compCombatStyle);
         }
-        // Handle combat target setting
-        if (companionData.isAlerted && COMBAT_ENABLED) {
-            if (DEBUGGING)
-                REX::INFO("ActionCompanions_Internal: Combat Target - Setting target for companion {}...", comp->GetDisplayFullName());
-            // Set target for the companion if in combat
-            if (companionData.isAlerted) {
-                auto enemyDataCopy = ActorTracking::GetEnemyData();
-                RE::Actor* enemyToTarget = nullptr;
-                switch (COMBAT_TARGET) {
-                case 0: { // closest target
-                    float closestDistance = FLT_MAX;
-                    for (auto& enemyData : enemyDataCopy) {
-                        // Go over enemyData.distance to find the shortest one
-                        if (enemyData.distanceToPlayer < closestDistance) {
-                            closestDistance = enemyData.distanceToPlayer;
-                            enemyToTarget = enemyData.actor;
-                        }
+    }
+    // Handle combat target setting
+    if (companionData.isAlerted && Cfg().COMBAT_ENABLED) {
+        if (DEBUGGING)
+            REX::INFO("ActionCompanions_Internal: Combat Target - Setting target for companion {}...", comp->GetDisplayFullName());
+        // Set target for the companion if in combat
+        if (companionData.isAlerted) {
+            auto snapshot = ActorTracking::GetSnapshot();
+            const auto& enemies = snapshot->enemies;
+            RE::Actor* enemyToTarget = nullptr;
+            switch (Cfg().COMBAT_TARGET) {
+            case 0: { // closest target
+                float closestDistance = FLT_MAX;
+                for (const auto& enemyData : enemies) {
+                    // Go over enemyData.distance to find the shortest one
+                    if (enemyData.distanceToPlayer < closestDistance) {
+                        closestDistance = enemyData.distanceToPlayer;
+                        enemyToTarget = enemyData.actor;
                     }
-                    break;
                 }
-                case 1: { // Lowest threat target
-                    float lowestThreat = FLT_MAX;
-                    for (auto& enemyData : enemyDataCopy) {
-                        // Go over enemyData.threatLevel to find a LOW tier one
-                        if (enemyData.tier == ENEMY_TIER::LOW) {
-                            enemyToTarget = enemyData.actor;
-                        } else if (enemyData.tier == ENEMY_TIER::MEDIUM && lowestThreat > 1.0f) {
-                            lowestThreat = 1.0f;
-                            enemyToTarget = enemyData.actor;
-                        } else if (enemyData.tier == ENEMY_TIER::HIGH && lowestThreat > 2.0f) {
-                            lowestThreat = 2.0f;
-                            enemyToTarget = enemyData.actor;
-                        }
+                break;
+            }
+            case 1: { // Lowest threat target
+                float lowestThreat = FLT_MAX;
+                for (const auto& enemyData : enemies) {
+                    // Go over enemyData.threatLevel to find a LOW tier one
+                    if (enemyData.tier == ENEMY_TIER::LOW) {
+                        enemyToTarget = enemyData.actor;
+                    } else if (enemyData.tier == ENEMY_TIER::MEDIUM && lowestThreat > 1.0f) {
+                        lowestThreat = 1.0f;
+                        enemyToTarget = enemyData.actor;
+                    } else if (enemyData.tier == ENEMY_TIER::HIGH && lowestThreat > 2.0f) {
+                        lowestThreat = 2.0f;
+                        enemyToTarget = enemyData.actor;
                     }
-                    break;
                 }
-                case 2: { // Highest threat target
-                    float highestThreat = -1.0f;
-                    for (auto& enemyData : enemyDataCopy) {
-                        // Go over enemyData.threatLevel to find a HIGH tier one
-                        if (enemyData.tier == ENEMY_TIER::HIGH) {
-                            enemyToTarget = enemyData.actor;
-                            break; // highest possible, break immediately
-                        } else if (enemyData.tier == ENEMY_TIER::MEDIUM && highestThreat < 2.0f) {
-                            highestThreat = 2.0f;
-                            enemyToTarget = enemyData.actor;
-                        } else if (enemyData.tier == ENEMY_TIER::LOW && highestThreat < 1.0f) {
-                            highestThreat = 1.0f;
-                            enemyToTarget = enemyData.actor;
-                        }
+                break;
+            }
+            case 2: { // Highest threat target
+                float highestThreat = -1.0f;
+                for (const auto& enemyData : enemies) {
+                    // Go over enemyData.threatLevel to find a HIGH tier one
+                    if (enemyData.tier == ENEMY_TIER::HIGH) {
+                        enemyToTarget = enemyData.actor;
+                        break; // highest possible, break immediately
+                    } else if (enemyData.tier == ENEMY_TIER::MEDIUM && highestThreat < 2.0f) {
+                        highestThreat = 2.0f;
+                        enemyToTarget = enemyData.actor;
+                    } else if (enemyData.tier == ENEMY_TIER::LOW && highestThreat < 1.0f) {
+                        highestThreat = 1.0f;
+                        enemyToTarget = enemyData.actor;
                     }
-                    break;
-                }
                 }
-                // Set the target
-                comp->currentCombatTarget = enemyToTarget ? enemyToTarget->As<RE::Actor>() : nullptr;
-                comp->UpdateCombat();
+                break;
             }
-        }
-        // Finally act on based on flags if not in power armor
-        // Use Stimpak idle if used
-        if (usedStimpak && idleToPlay && !RE::PowerArmor::ActorInPowerArmor(*comp)) {
-            // Play Stimpak idle
-            if (comp && comp->currentProcess) {
-                comp->currentProcess->PlayIdle(*comp, idleToPlay, nullptr);
-                continue;
             }
+            // Set the target
+            comp->currentCombatTarget = enemyToTarget ? enemyToTarget->As<RE::Actor>() : nullptr;
+            comp->UpdateCombat();
         }
-        // Flee combat if needed
-        if (fleeCombat) {
-            // Flee combat to safe location
-            if (comp && comp->currentProcess) {
-                // Calculate a flee location AI_FLEE_DISTANCE units away from current position
-                float minDist = AI_FLEE_DISTANCE * 0.5f;
-                float maxDist = AI_FLEE_DISTANCE * 1.5f;
-                float fleeFromDist = minDist + static_cast<float>(std::rand()) / RAND_MAX * (maxDist - minDist);
-                float fleeToDist = fleeFromDist + static_cast<float>(std::rand()) / RAND_MAX * (maxDist - minDist);
-                // InitiateFlee(TESObjectREFR* a_fleeRef, bool a_runonce, bool a_knows, bool a_combatMode,
-                // TESObjectCELL* a_cell, TESObjectREFR* a_ref, float a_fleeFromDist, float a_fleeToDist)
-                comp->InitiateFlee(comp->currentCombatTarget.get().get(), false, false, true, nullptr, nullptr, fleeFromDist, fleeToDist);
-                continue;
-            }
-        }
-        if (AI_STUCK_CHECK) {
-            // Add the companion to the movement task list for the next UPDATE_INTERVAL seconds
-            if (DEBUGGING)
-                REX::INFO("ActionCompanions_Internal: Stuck Check - Adding companion {} to movement task list for stuck checking.", comp->GetDisplayFullName());
-            MovementSystem::AddCompanionTask(comp, UPDATE_INTERVAL);
-        } else {
-            // Remove from movement task list
-            MovementSystem::RemoveCompanionTask(comp);
+    }
+    // Finally act on based on flags if not in power armor
+    // Use Stimpak idle if used
+    if (usedStimpak && idleToPlay && !RE::PowerArmor::ActorInPowerArmor(*comp)) {
+        // Play Stimpak idle
+        if (comp && comp->currentProcess) {
+            comp->currentProcess->PlayIdle(*comp, idleToPlay, nullptr);
+            return;
         }
-        // Handle lost behaviour or stuck for more than 1 update (teleport to player)
-        if ((companionData.lost || companionData.distanceToPlayer > AI_STUCK_DISTANCE) && AI_STUCK_CHECK) {
-            if (DEBUGGING)
-                REX::INFO("ActionCompanions_Internal: Lost - Companion {} is lost - teleporting to player!", comp->GetDisplayFullName());
-            if (player) {
-                auto playerPos = player->GetPosition();
-                auto compPos = comp->GetPosition();
-                // Calculate the angle from player to companion's current position
-                float dx = compPos.x - playerPos.x;
-                float dy = compPos.y - playerPos.y;
-                float angle = std::atan2(dy, dx); // angle from player to companion
-                // Use 75% of the current distance
-                float currentDistance = std::sqrt(dx * dx + dy * dy);
-                float radius = currentDistance * 0.75f;
-                // Teleport companion to new position
-                RE::NiPoint3 newPos;
-                newPos.x = player->GetPosition().x + radius * std::cos(angle);
-                newPos.y = player->GetPosition().y + radius * std::sin(angle);
-                // Find a good Z position
-                newPos.z = player->GetPosition().z; // start with the player's Z
-                // Get collision filter of the companion
-                auto filter = comp->GetCollisionFilter();
-                // Get the xy position to a close object (position, filter, radiant steps, scan distance, move up distance)
-                RE::NiPoint3 closePos = GetPointXY_Internal(newPos, filter, 100.0f, 500.0f, 60.0f);
-                // Get ground Z at new position + 1.0f
-                newPos.z = GetPointZ_Internal(newPos, filter, 100.0f, 500.0f) + 1.0f; // Scan 100 units up and 500 units down and add 1.0f to spawn Slightly above ground to pick up new navmesh
-                // Set new position
-                comp->SetPosition(newPos, true);
-            }
-            // Reset flags after teleporting
-            ActorTracking::SetActorLostStatusFast(comp, false);
-            ActorTracking::SetActorStuckCounterFast(comp, 0);
-            continue;
+    }
+    // Flee combat if needed
+    if (fleeCombat) {
+        // Flee combat to safe location
+        if (comp && comp->currentProcess) {
+            // Calculate a flee location AI_FLEE_DISTANCE units away from current position
+            float minDist = Cfg().AI_FLEE_DISTANCE * 0.5f;
+            float maxDist = Cfg().AI_FLEE_DISTANCE * 1.5f;
+            float fleeFromDist = minDist + static_cast<float>(std::rand()) / RAND_MAX * (maxDist - minDist);
+            float fleeToDist = fleeFromDist + static_cast<float>(std::rand()) / RAND_MAX * (maxDist - minDist);
+            // InitiateFlee(TESObjectREFR* a_fleeRef, bool a_runonce, bool a_knows, bool a_combatMode,
+            // TESObjectCELL* a_cell, TESObjectREFR* a_ref, float a_fleeFromDist, float a_fleeToDist)
+            comp->InitiateFlee(comp->currentCombatTarget.get().get(), false, false, true, nullptr, nullptr, fleeFromDist, fleeToDist);
+            return;
         }
     }
+    if (Cfg().AI_STUCK_CHECK) {
+        // Add the companion to the movement task list for the next UPDATE_INTERVAL seconds
+        if (DEBUGGING)
+            REX::INFO("ActionCompanions_Internal: Stuck Check - Adding companion {} to movement task list for stuck checking.", comp->GetDisplayFullName());
+        MovementSystem::AddCompanionTask(comp, Cfg().UPDATE_INTERVAL);
+    } else {
+        // Remove from movement task list
+        MovementSystem::RemoveCompanionTask(comp);
+    }
+    // Handle lost behaviour or stuck for more than 1 update (teleport to player)
+    if ((companionData.lost || companionData.distanceToPlayer > Cfg().AI_STUCK_DISTANCE) && Cfg().AI_STUCK_CHECK) {
+        if (DEBUGGING)
+            REX::INFO("ActionCompanions_Internal: Lost - Companion {} is lost - teleporting to player!", comp->GetDisplayFullName());
+        if (player) {
+            auto playerPos = player->GetPosition();
+            auto compPos = comp->GetPosition();
+            // Calculate the angle from player to companion's current position
+            float dx = compPos.x - playerPos.x;
+            float dy = compPos.y - playerPos.y;
+            float angle = std::atan2(dy, dx); // angle from player to companion
+            // Use 75% of the current distance
+            float currentDistance = std::sqrt(dx * dx + dy * dy);
+            float radius = currentDistance * 0.75f;
+            // Teleport companion to new position
+            RE::NiPoint3 newPos;
+            newPos.x = player->GetPosition().x + radius * std::cos(angle);
+            newPos.y = player->GetPosition().y + radius * std::sin(angle);
+            // Find a good Z position
+            newPos.z = player->GetPosition().z; // start with the player's Z
+            // Get collision filter of the companion
+            auto filter = comp->GetCollisionFilter();
+            const auto raysBefore = ProbeSystem::g_stats.rays;
+            // Move up to 60 units away from an object closer than the clearance, scanning 500 units for room behind
+            newPos = ProbeSystem::ProbeXY(newPos, filter, 500.0f, 60.0f);
+            // Get ground Z at new position + 1.0f
+            newPos.z = ProbeSystem::ProbeZ(newPos, filter, 100.0f, 500.0f) + 1.0f; // Scan 100 units up and 500 units down and add 1.0f to spawn Slightly above ground to pick up new navmesh
+            ProbeSystem::g_stats.teleports++;
+            if (DEBUGGING)
+                REX::INFO("ActionCompanions_Internal: Lost - Teleport probes cast {} rays ({} ground samples cached, {} cast so far)", ProbeSystem::g_stats.rays - raysBefore, ProbeSystem::g_stats.groundCached, ProbeSystem::g_stats.groundCast);
+            // Set new position
+            comp->SetPosition(newPos, true);
+        }
+        // Reset flags after teleporting
+        ActorTracking::SetActorLostStatusFast(comp, false);
+        ActorTracking::SetActorStuckCounterFast(comp, 0);
+        return;
+    }
 }
 
 // Help Add item from actor's inventory
@@ -543,19 +601,14 @@ RE::BGSInventoryItem* ActorAddInventoryItem_Internal(RE::Actor* actor, RE::TESFo
     }
     auto* itemObject = itemForm->As<RE::TESBoundObject>();
     actor->AddObjectToContainer(itemObject, nullptr, 1, nullptr, RE::ITEM_REMOVE_REASON::kStoreContainer);
-    // Find and return the added item
-    for (auto& item : invList->data) {
-        // The item.object field is a RE::TESBoundObject*. We must compare it to our
-        // successfully cast itemObject to find the correct entry.
-        if (item.object == itemObject) {
-            // You are adding 'count' items. This item should have a count >= 'count'.
-            if (item.GetCount() >= count) {
-                // Return a pointer to the found item in the inventory data structure
-                return &item;
-            }
-        }
-    }
-    return nullptr;
+    InventoryCache::Invalidate(actor->GetFormID());
+    // Find and return the added item through the rebuilt index
+    auto* index = InventoryCache::Get(actor);
+    auto* itemCount = index ? index->counts.Find(itemObject->GetFormID()) : nullptr;
+    // You are adding 'count' items. The item should have a count >= 'count'.
+    if (!itemCount || itemCount->count < count)
+        return nullptr;
+    return InventoryCache::GetItem(actor, *index, static_cast<std::int32_t>(itemCount->entry));
 }
 
 // Help remove item from actor's inventory
@@ -573,46 +626,51 @@ void ActorRemoveInventoryItem_Internal(RE::Actor* actor, RE::TESForm* itemForm,
     data.reason = RE::ITEM_REMOVE_REASON::kNone;
     // Remove item
     auto result = actor->RemoveItem(data);
+    InventoryCache::Invalidate(actor->GetFormID());
 }
 
 // Helper function to apply the aggression settings to the companions current package
 void ApplyAIAggression_Internal() {
     // Go over our companions
-    auto companionDataCopy = ActorTracking::GetCompanionData();
-    for (auto& companionData : companionDataCopy) {
-        auto* actor = companionData.actor;
-        if (!actor)
-            continue;
-        if (actor->IsInCombat())
-            continue; // do not apply when already in combat
-        auto* npc = actor->GetNPC();
-        if (!npc)
-            continue;
-        // Log current aiData settings
-        if (npc) {
-            // Disable when sneaking if set in INI
-            if (actor->IsSneaking() && !AI_AGGRESSION_SNEAK) {
-                npc->aiData.useAggroRadius = static_cast<std::uint32_t>(0);
-                continue;
-            }
-            // Disable when the standard follower package is not running and AI_AGGRESSION_ALL is false
-            if (actor->currentProcess && actor->currentProcess->GetPackageThatIsRunning() && actor->currentProcess->GetPackageThatIsRunning()->GetFormID() != g_packFollowersCompanion->GetFormID() && !AI_AGGRESSION_ALL) {
-                npc->aiData.useAggroRadius = static_cast<std::uint32_t>(0);
-                continue;
-            }
-            // Changing settings at runtime if they do not match the INI settings
-            if (npc->aiData.useAggroRadius != static_cast<std::uint32_t>(AI_AGGRESSION_ENABLED)
-                || npc->aiData.aggroRadius[0] != static_cast<std::uint16_t>(AI_AGGRESSION_RADIUS0)
-                || npc->aiData.aggroRadius[1] != static_cast<std::uint16_t>(AI_AGGRESSION_RADIUS1)
-                || npc->aiData.aggroRadius[2] != static_cast<std::uint16_t>(AI_AGGRESSION_RADIUS2)) {
-                npc->aiData.useAggroRadius = static_cast<std::uint32_t>(AI_AGGRESSION_ENABLED);
-                npc->aiData.aggroRadius[0] = static_cast<std::uint16_t>(AI_AGGRESSION_RADIUS0);
-                npc->aiData.aggroRadius[1] = static_cast<std::uint16_t>(AI_AGGRESSION_RADIUS1);
-                npc->aiData.aggroRadius[2] = static_cast<std::uint16_t>(AI_AGGRESSION_RADIUS2);
-                if (DEBUGGING) {
-                    REX::INFO("ApplyAIAggression: Updated useAggroRadius={} for companion {}", static_cast<std::uint32_t>(npc->aiData.useAggroRadius), actor->GetDisplayFullName());
-                    REX::INFO("ApplyAIAggression: Updated aggroRadius = [{}, {}, {}] for companion {}", npc->aiData.aggroRadius[0], npc->aiData.aggroRadius[1], npc->aiData.aggroRadius[2], actor->GetDisplayFullName());
-                }
+    auto snapshot = ActorTracking::GetSnapshot();
+    for (const auto& companionData : snapshot->companions)
+        ApplyAIAggression_Internal(companionData);
+}
+
+// Helper function to apply the aggression settings to the companions current package (single companion slice)
+void ApplyAIAggression_Internal(const TrackedActorData& companionData) {
+    auto* actor = companionData.actor;
+    if (!actor)
+        return;
+    if (actor->IsInCombat())
+        return; // do not apply when already in combat
+    auto* npc = actor->GetNPC();
+    if (!npc)
+        return;
+    // Log current aiData settings
+    if (npc) {
+        // Disable when sneaking if set in INI
+        if (actor->IsSneaking() && !Cfg().AI_AGGRESSION_SNEAK) {
+            npc->aiData.useAggroRadius = static_cast<std::uint32_t>(0);
+            return;
+        }
+        // Disable when the standard follower package is not running and AI_AGGRESSION_ALL is false
+        if (actor->currentProcess && actor->currentProcess->GetPackageThatIsRunning() && actor->currentProcess->GetPackageThatIsRunning()->GetFormID() != g_packFollowersCompanion->GetFormID() && !Cfg().AI_AGGRESSION_ALL) {
+            npc->aiData.useAggroRadius = static_cast<std::uint32_t>(0);
+            return;
+        }
+        // Changing settings at runtime if they do not match the INI settings
+        if (npc->aiData.useAggroRadius != static_cast<std::uint32_t>(Cfg().AI_AGGRESSION_ENABLED)
+            || npc->aiData.aggroRadius[0] != static_cast<std::uint16_t>(Cfg().AI_AGGRESSION_RADIUS0)
+            || npc->aiData.aggroRadius[1] != static_cast<std::uint16_t>(Cfg().AI_AGGRESSION_RADIUS1)
+            || npc->aiData.aggroRadius[2] != static_cast<std::uint16_t>(Cfg().AI_AGGRESSION_RADIUS2)) {
+            npc->aiData.useAggroRadius = static_cast<std::uint32_t>(Cfg().AI_AGGRESSION_ENABLED);
+            npc->aiData.aggroRadius[0] = static_cast<std::uint16_t>(Cfg().AI_AGGRESSION_RADIUS0);
+            npc->aiData.aggroRadius[1] = static_cast<std::uint16_t>(Cfg().AI_AGGRESSION_RADIUS1);
+            npc->aiData.aggroRadius[2] = static_cast<std::uint16_t>(Cfg().AI_AGGRESSION_RADIUS2);
+            if (DEBUGGING) {
+                REX::INFO("ApplyAIAggression: Updated useAggroRadius={} for companion {}", static_cast<std::uint32_t>(npc->aiData.useAggroRadius), actor->GetDisplayFullName());
+                REX::INFO("ApplyAIAggression: Updated aggroRadius = [{}, {}, {}] for companion {}", npc->aiData.aggroRadius[0], npc->aiData.aggroRadius[1], npc->aiData.aggroRadius[2], actor->GetDisplayFullName());
             }
         }
     }
@@ -621,36 +679,47 @@ void ApplyAIAggression_Internal() {
 // Helper function to apply perks to companion actors
 void ApplyPerksToCompanions_Internal() {
     // Go over our companions
-    auto companionDataCopy = ActorTracking::GetCompanionData();
-    for (auto& companionData : companionDataCopy) {
-        auto* actor = companionData.actor;
-        if (!actor)
-            continue;
-        // Apply each perk from the global list
-        for (auto perk : g_perkList) {
-            if (perk && actor->GetPerkRank(perk) <= 0) {
-                actor->AddPerk(perk);
-                if (DEBUGGING)
-                    REX::INFO("ApplyPerksToCompanions: Adding perk {} for companion {}", perk->GetFormEditorID(), actor->GetDisplayFullName());
-            }
+    auto snapshot = ActorTracking::GetSnapshot();
+    for (const auto& companionData : snapshot->companions)
+        ApplyPerksToCompanions_Internal(companionData);
+}
+
+// Helper function to apply perks to companion actors (single companion slice)
+void ApplyPerksToCompanions_Internal(const TrackedActorData& companionData) {
+    auto* actor = companionData.actor;
+    if (!actor)
+        return;
+    // Apply each perk from the compiled list
+    auto compiled = g_compiledConfig.load(std::memory_order_acquire);
+    for (auto perk : compiled->perks) {
+        if (perk && actor->GetPerkRank(perk) <= 0) {
+            actor->AddPerk(perk);
+            if (DEBUGGING)
+                REX::INFO("ApplyPerksToCompanions: Adding perk {} for companion {}", perk->GetFormEditorID(), actor->GetDisplayFullName());
         }
     }
 }
 
+// Helper function to apply keywords to companion actors
 void ApplyKeywordsToCompanions_Internal() {
     // Go over our companions
-    auto companionDataCopy = ActorTracking::GetCompanionData();
-    for (auto& companionData : companionDataCopy) {
-        auto* actor = companionData.actor;
-        if (!actor)
-            continue;
-        // Apply each keyword from the global list
-        for (auto keyword : g_keywordList) {
-            if (keyword && !actor->HasKeyword(keyword)) {
-                actor->AddKeyword(keyword);
-                if (DEBUGGING)
-                    REX::INFO("ApplyKeywordsToCompanions: Adding keyword {} for companion {}", keyword->GetFormEditorID(), actor->GetDisplayFullName());
-            }
+    auto snapshot = ActorTracking::GetSnapshot();
+    for (const auto& companionData : snapshot->companions)
+        ApplyKeywordsToCompanions_Internal(companionData);
+}
+
+// Helper function to apply keywords to companion actors (single companion slice)
+void ApplyKeywordsToCompanions_Internal(const TrackedActorData& companionData) {
+    auto* actor = companionData.actor;
+    if (!actor)
+        return;
+    // Apply each keyword from the compiled list
+    auto compiled = g_compiledConfig.load(std::memory_order_acquire);
+    for (auto keyword : compiled->keywords) {
+        if (keyword && !actor->HasKeyword(keyword)) {
+            actor->AddKeyword(keyword);
+            if (DEBUGGING)
+                REX::INFO("ApplyKeywordsToCompanions: Adding keyword {} for companion {}", keyword->GetFormEditorID(), actor->GetDisplayFullName());
         }
     }
 }
@@ -659,335 +728,159 @@ void ApplyKeywordsToCompanions_Internal() {
 // Buff companion actors
 void BuffCompanions_Internal() {
     // Go over our companions
-    auto companionDataCopy = ActorTracking::GetCompanionData();
-    for (auto& companionData : companionDataCopy) {
-        auto* actor = companionData.actor;
-        if (!actor || companionData.buffed)
-            continue;
-        // Heal Rate buff
-        auto* healRateAV = RE::ActorValue::GetSingleton()->healRateMult;
-        if (healRateAV) {
-            float currentHealRate = actor->GetActorValue(*healRateAV);
-            if (currentHealRate < BUFF_HEAL_RATE) {
-                // Calculate exactly how much we need to add to hit the floor
-                float missingAmount = BUFF_HEAL_RATE - currentHealRate;
-                // Add heal rate buff based on BUFF_HEAL_RATE
-                actor->ModActorValue(RE::ACTOR_VALUE_MODIFIER::kPermanent, *healRateAV, missingAmount);
-                currentHealRate = actor->GetActorValue(*healRateAV);
-            }
-            if (DEBUGGING)
-                REX::INFO("BuffCompanions: Heal rate of {} is {:.2f}", actor->GetDisplayFullName(), currentHealRate);
-        } else {
-            if (DEBUGGING)
-                REX::WARN("BuffCompanions: Heal Rate ActorValue not found!");
-        }
-        // Combat Heal Rate buff
-        auto* combatHealRateAV = RE::ActorValue::GetSingleton()->combatHealthRegenMult;
-        if (combatHealRateAV) {
-            float currentCombatHealRate = actor->GetActorValue(*combatHealRateAV);
-            if (currentCombatHealRate < BUFF_COMBAT_HEAL_RATE) {
-                // Calculate exactly how much we need to add to hit the floor
-                float missingAmount = BUFF_COMBAT_HEAL_RATE - currentCombatHealRate;
-                // Add combat heal rate buff based on BUFF_COMBAT_HEAL_RATE
-                actor->ModActorValue(RE::ACTOR_VALUE_MODIFIER::kPermanent, *combatHealRateAV, missingAmount);
-                currentCombatHealRate = actor->GetActorValue(*combatHealRateAV);
-            }
-            if (DEBUGGING)
-                REX::INFO("BuffCompanions: Combat heal rate of {} is {:.2f}", actor->GetDisplayFullName(), currentCombatHealRate);
-        } else {
-            if (DEBUGGING)
-                REX::WARN("BuffCompanions: Combat Heal Rate ActorValue not found!");
-        }
-        // Damage Resist buff
-        auto* dmgResistAV = RE::ActorValue::GetSingleton()->damageResistance;
-        if (dmgResistAV) {
-            float currentDmgResist = actor->GetActorValue(*dmgResistAV);
-            if (currentDmgResist < BUFF_DAMAGE_RESIST) {
-                // Calculate exactly how much we need to add to hit the floor
-                float missingAmount = BUFF_DAMAGE_RESIST - currentDmgResist;
-                // Add damage resistance buff based on BUFF_DAMAGE_RESIST
-                actor->ModActorValue(RE::ACTOR_VALUE_MODIFIER::kPermanent, *dmgResistAV, missingAmount);
-                currentDmgResist = actor->GetActorValue(*dmgResistAV);
-            }
-            if (DEBUGGING)
-                REX::INFO("BuffCompanions: Damage resistance of {} is {:.2f}", actor->GetDisplayFullName(), currentDmgResist);
-        } else {
-            if (DEBUGGING)
-                REX::WARN("BuffCompanions: Damage Resistance ActorValue not found!");
-        }
-        // Fire Resist buff
-        auto* fireResistAV = RE::ActorValue::GetSingleton()->fireResistance;
-        if (fireResistAV) {
-            float currentFireResist = actor->GetActorValue(*fireResistAV);
-            if (currentFireResist < BUFF_FIRE_RESIST) {
-                // Calculate exactly how much we need to add to hit the floor
-                float missingAmount = BUFF_FIRE_RESIST - currentFireResist;
-                // Add fire resistance buff based on BUFF_FIRE_RESIST
-                actor->ModActorValue(RE::ACTOR_VALUE_MODIFIER::kPermanent, *fireResistAV, missingAmount);
-                currentFireResist = actor->GetActorValue(*fireResistAV);
-            }
-            if (DEBUGGING)
-                REX::INFO("BuffCompanions: Fire resistance of {} is {:.2f}", actor->GetDisplayFullName(), currentFireResist);
-        } else {
-            if (DEBUGGING)
-                REX::WARN("BuffCompanions: Fire Resistance ActorValue not found!");
-        }
-        // Electrical Resist buff
-        auto* electricalResistAV = RE::ActorValue::GetSingleton()->electricalResistance;
-        if (electricalResistAV) {
-            float currentElectricalResist = actor->GetActorValue(*electricalResistAV);
-            if (currentElectricalResist < BUFF_ELECTRICAL_RESIST) {
-                // Calculate exactly how much we need to add to hit the floor
-                float missingAmount = BUFF_ELECTRICAL_RESIST - currentElectricalResist;
-                // Add electrical resistance buff based on BUFF_ELECTRICAL_RESIST
-                actor->ModActorValue(RE::ACTOR_VALUE_MODIFIER::kPermanent, *electricalResistAV, missingAmount);
-                currentElectricalResist = actor->GetActorValue(*electricalResistAV);
-            }
-            if (DEBUGGING)
-                REX::INFO("BuffCompanions: Electrical resistance of {} is {:.2f}", actor->GetDisplayFullName(), currentElectricalResist);
-        } else {
-            if (DEBUGGING)
-                REX::WARN("BuffCompanions: Electrical Resistance ActorValue not found!");
-        }
-        // Frost Resist buff
-        auto* frostResistAV = RE::ActorValue::GetSingleton()->frostResistance;
-        if (frostResistAV) {
-            float currentFrostResist = actor->GetActorValue(*frostResistAV);
-            if (currentFrostResist < BUFF_FROST_RESIST) {
-                // Calculate exactly how much we need to add to hit the floor
-                float missingAmount = BUFF_FROST_RESIST - currentFrostResist;
-                // Add frost resistance buff based on BUFF_FROST_RESIST
-                actor->ModActorValue(RE::ACTOR_VALUE_MODIFIER::kPermanent, *frostResistAV, missingAmount);
-                currentFrostResist = actor->GetActorValue(*frostResistAV);
-            }
-            if (DEBUGGING)
-                REX::INFO("BuffCompanions: Frost resistance of {} is {:.2f}", actor->GetDisplayFullName(), currentFrostResist);
-        } else {
-            if (DEBUGGING)
-                REX::WARN("BuffCompanions: Frost Resistance ActorValue not found!");
-        }
-        // Energy Resist buff
-        auto* energyResistAV = RE::ActorValue::GetSingleton()->energyResistance;
-        if (energyResistAV) {
-            float currentEnergyResist = actor->GetActorValue(*energyResistAV);
-            if (currentEnergyResist < BUFF_ENERGY_RESIST) {
-                // Calculate exactly how much we need to add to hit the floor
-                float missingAmount = BUFF_ENERGY_RESIST - currentEnergyResist;
-                // Add energy resistance buff based on BUFF_ENERGY_RESIST
-                actor->ModActorValue(RE::ACTOR_VALUE_MODIFIER::kPermanent, *energyResistAV, missingAmount);
-                currentEnergyResist = actor->GetActorValue(*energyResistAV);
-            }
-            if (DEBUGGING)
-                REX::INFO("BuffCompanions: Energy resistance of {} is {:.2f}", actor->GetDisplayFullName(), currentEnergyResist);
-        } else {
-            if (DEBUGGING)
-                REX::WARN("BuffCompanions: Energy Resistance ActorValue not found!");
-        }
-        // Poison Resist buff
-        auto* poisonResistAV = RE::ActorValue::GetSingleton()->poisonResistance;
-        if (poisonResistAV) {
-            float currentPoisonResist = actor->GetActorValue(*poisonResistAV);
-            if (currentPoisonResist < BUFF_POISON_RESIST) {
-                // Calculate exactly how much we need to add to hit the floor
-                float missingAmount = BUFF_POISON_RESIST - currentPoisonResist;
-                // Add poison resistance buff based on BUFF_POISON_RESIST
-                actor->ModActorValue(RE::ACTOR_VALUE_MODIFIER::kPermanent, *poisonResistAV, missingAmount);
-                currentPoisonResist = actor->GetActorValue(*poisonResistAV);
-            }
-            if (DEBUGGING)
-                REX::INFO("BuffCompanions: Poison resistance of {} is {:.2f}", actor->GetDisplayFullName(), currentPoisonResist);
-        } else {
-            if (DEBUGGING)
-                REX::WARN("BuffCompanions: Poison Resistance ActorValue not found!");
-        }
-        // Radiation Exposure Resist buff
-        auto* radiationResistAV = RE::ActorValue::GetSingleton()->radExposureResistance;
-        if (radiationResistAV) {
-            float currentRadiationResist = actor->GetActorValue(*radiationResistAV);
-            if (currentRadiationResist < BUFF_RADIATION_RESIST) {
-                // Calculate exactly how much we need to add to hit the floor
-                float missingAmount = BUFF_RADIATION_RESIST - currentRadiationResist;
-                // Add radiation exposure resistance buff based on BUFF_RADIATION_RESIST
-                actor->ModActorValue(RE::ACTOR_VALUE_MODIFIER::kPermanent, *radiationResistAV, missingAmount);
-                currentRadiationResist = actor->GetActorValue(*radiationResistAV);
-            }
-            if (DEBUGGING)
-                REX::INFO("BuffCompanions: Radiation exposure resistance of {} is {:.2f}", actor->GetDisplayFullName(), currentRadiationResist);
-        } else {
-            if (DEBUGGING)
-                REX::WARN("BuffCompanions: Radiation Exposure Resistance ActorValue not found!");
-        }
-        // Agility buff
-        auto* agilityAV = RE::ActorValue::GetSingleton()->agility;
-        if (agilityAV) {
-            float currentAgility = actor->GetActorValue(*agilityAV);
-            if (currentAgility < BUFF_AGILITY) {
-                // Calculate exactly how much we need to add to hit the floor
-                float missingAmount = BUFF_AGILITY - currentAgility;
-                // Add agility buff based on BUFF_AGILITY
-                actor->ModActorValue(RE::ACTOR_VALUE_MODIFIER::kPermanent, *agilityAV, missingAmount);
-                currentAgility = actor->GetActorValue(*agilityAV);
-            }
-            if (DEBUGGING)
-                REX::INFO("BuffCompanions: Agility of {} is {:.2f}", actor->GetDisplayFullName(), currentAgility);
-        } else {
-            if (DEBUGGING)
-                REX::WARN("BuffCompanions: Agility ActorValue not found!");
-        }
-        // Endurance buff
-        auto* enduranceAV = RE::ActorValue::GetSingleton()->endurance;
-        if (enduranceAV) {
-            float currentEndurance = actor->GetActorValue(*enduranceAV);
-            if (currentEndurance < BUFF_ENDURANCE) {
-                // Calculate exactly how much we need to add to hit the floor
-                float missingAmount = BUFF_ENDURANCE - currentEndurance;
-                // Add endurance buff based on BUFF_ENDURANCE
-                actor->ModActorValue(RE::ACTOR_VALUE_MODIFIER::kPermanent, *enduranceAV, missingAmount);
-                currentEndurance = actor->GetActorValue(*enduranceAV);
-            }
-            if (DEBUGGING)
-                REX::INFO("BuffCompanions: Endurance of {} is {:.2f}", actor->GetDisplayFullName(), currentEndurance);
-        } else {
-            if (DEBUGGING)
-                REX::WARN("BuffCompanions: Endurance ActorValue not found!");
-        }
-        // Intelligence buff
-        auto* intelligenceAV = RE::ActorValue::GetSingleton()->intelligence;
-        if (intelligenceAV) {
-            float currentIntelligence = actor->GetActorValue(*intelligenceAV);
-            if (currentIntelligence < BUFF_INTELLIGENCE) {
-                // Calculate exactly how much we need to add to hit the floor
-                float missingAmount = BUFF_INTELLIGENCE - currentIntelligence;
-                // Add intelligence buff based on BUFF_INTELLIGENCE
-                actor->ModActorValue(RE::ACTOR_VALUE_MODIFIER::kPermanent, *intelligenceAV, missingAmount);
-                currentIntelligence = actor->GetActorValue(*intelligenceAV);
-            }
-            if (DEBUGGING)
-                REX::INFO("BuffCompanions: Intelligence of {} is {:.2f}", actor->GetDisplayFullName(), currentIntelligence);
-        } else {
-            if (DEBUGGING)
-                REX::WARN("BuffCompanions: Intelligence ActorValue not found!");
-        }
-        // Lockpick buff
-        auto* lockpickAV = RE::ActorValue::GetSingleton()->lockpicking;
-        if (lockpickAV) {
-            float currentLockpick = actor->GetActorValue(*lockpickAV);
-            if (currentLockpick < BUFF_LOCKPICK) {
-                // Calculate exactly how much we need to add to hit the floor
-                float missingAmount = BUFF_LOCKPICK - currentLockpick;
-                // Add lockpick buff based on BUFF_LOCKPICK
-                actor->ModActorValue(RE::ACTOR_VALUE_MODIFIER::kPermanent, *lockpickAV, missingAmount);
-                currentLockpick = actor->GetActorValue(*lockpickAV);
-            }
-            if (DEBUGGING)
-                REX::INFO("BuffCompanions: Lockpick of {} is {:.2f}", actor->GetDisplayFullName(), currentLockpick);
-        } else {
-            if (DEBUGGING)
-                REX::WARN("BuffCompanions: Lockpick ActorValue not found!");
-        }
-        // Luck buff
-        auto* luckAV = RE::ActorValue::GetSingleton()->luck;
-        if (luckAV) {
-            float currentLuck = actor->GetActorValue(*luckAV);
-            if (currentLuck < BUFF_LUCK) {
-                // Calculate exactly how much we need to add to hit the floor
-                float missingAmount = BUFF_LUCK - currentLuck;
-                // Add luck buff based on BUFF_LUCK
-                actor->ModActorValue(RE::ACTOR_VALUE_MODIFIER::kPermanent, *luckAV, missingAmount);
-                currentLuck = actor->GetActorValue(*luckAV);
-            }
-            if (DEBUGGING)
-                REX::INFO("BuffCompanions: Luck of {} is {:.2f}", actor->GetDisplayFullName(), currentLuck);
-        } else {
-            if (DEBUGGING)
-                REX::WARN("BuffCompanions: Luck ActorValue not found!");
-        }
-        // Perception buff
-        auto* perceptionAV = RE::ActorValue::GetSingleton()->perception;
-        if (perceptionAV) {
-            float currentPerception = actor->GetActorValue(*perceptionAV);
-            if (currentPerception < BUFF_PERCEPTION) {
-                // Calculate exactly how much we need to add to hit the floor
-                float missingAmount = BUFF_PERCEPTION - currentPerception;
-                // Add perception buff based on BUFF_PERCEPTION
-                actor->ModActorValue(RE::ACTOR_VALUE_MODIFIER::kPermanent, *perceptionAV, missingAmount);
-                currentPerception = actor->GetActorValue(*perceptionAV);
-            }
-            if (DEBUGGING)
-                REX::INFO("BuffCompanions: Perception of {} is {:.2f}", actor->GetDisplayFullName(), currentPerception);
-        } else {
+    auto snapshot = ActorTracking::GetSnapshot();
+    for (const auto& companionData : snapshot->companions)
+        BuffCompanions_Internal(companionData);
+}
+
+// Buff companion actors (single companion slice)
+void BuffCompanions_Internal(const TrackedActorData& companionData) {
+    auto* actor = companionData.actor;
+    if (!actor)
+        return;
+    auto table = g_buffTable.load(std::memory_order_acquire);
+    // Only re-check the actor values when the companion or the table changed since the last pass
+    auto* flags = ActorTracking::GetCompanionFlags(ActorTracking::FindCompanionSlot(actor), actor);
+    std::uint64_t signature = BuffSignature_Internal(actor, *table);
+    bool applied = BuffEngine::Apply(*table, signature, flags ? &flags->buffSignature : nullptr,
+        [actor](const RE::ActorValueInfo& actorValue) { return actor->GetActorValue(actorValue); },
+        [actor](RE::ACTOR_VALUE_MODIFIER modifier, const RE::ActorValueInfo& actorValue, float delta) { actor->ModActorValue(modifier, actorValue, delta); });
+    if (DEBUGGING && applied) {
+        for (const auto& buff : table->entries)
+            REX::INFO("BuffCompanions: {} of {} is {:.2f}", buff.name, actor->GetDisplayFullName(), actor->GetActorValue(*buff.actorValue));
+    }
+}
+
+// Signature of what the buffs depend on: table generation, level and equipped gear
+std::uint64_t BuffSignature_Internal(RE::Actor* actor, const BuffTable& table) {
+    if (!actor)
+        return 0;
+    return BuffEngine::Signature(table.generation, actor->GetLevel(), actor->equippedWeight);
+}
+
+// Build the buff table from the settings, publish it only when a floor changed
+void BuildBuffTable_Internal() {
+    auto* avSingleton = RE::ActorValue::GetSingleton();
+    if (!avSingleton)
+        return;
+    std::vector<BuffEntry> entries;
+    auto add = [&entries](RE::ActorValueInfo* actorValue, float floor, const char* name) {
+        if (!actorValue) {
             if (DEBUGGING)
-                REX::WARN("BuffCompanions: Perception ActorValue not found!");
-        }
-        // Sneak buff
-        auto* sneakAV = RE::ActorValue::GetSingleton()->sneak;
-        if (sneakAV) {
-            float currentSneak = actor->GetActorValue(*sneakAV);
-            if (currentSneak < BUFF_SNEAK) {
-                // Calculate exactly how much we need to add to hit the floor
-                float missingAmount = BUFF_SNEAK - currentSneak;
-                // Add sneak buff based on BUFF_SNEAK
-                actor->ModActorValue(RE::ACTOR_VALUE_MODIFIER::kPermanent, *sneakAV, missingAmount);
-                currentSneak = actor->GetActorValue(*sneakAV);
+                REX::WARN("BuildBuffTable_Internal: {} ActorValue not found!", name);
+            return;
+        }
+        entries.push_back({actorValue, floor, RE::ACTOR_VALUE_MODIFIER::kPermanent, name});
+    };
+    add(avSingleton->healRateMult, Cfg().BUFF_HEAL_RATE, "Heal rate");
+    add(avSingleton->combatHealthRegenMult, Cfg().BUFF_COMBAT_HEAL_RATE, "Combat heal rate");
+    add(avSingleton->damageResistance, Cfg().BUFF_DAMAGE_RESIST, "Damage resistance");
+    add(avSingleton->fireResistance, Cfg().BUFF_FIRE_RESIST, "Fire resistance");
+    add(avSingleton->electricalResistance, Cfg().BUFF_ELECTRICAL_RESIST, "Electrical resistance");
+    add(avSingleton->frostResistance, Cfg().BUFF_FROST_RESIST, "Frost resistance");
+    add(avSingleton->energyResistance, Cfg().BUFF_ENERGY_RESIST, "Energy resistance");
+    add(avSingleton->poisonResistance, Cfg().BUFF_POISON_RESIST, "Poison resistance");
+    add(avSingleton->radExposureResistance, Cfg().BUFF_RADIATION_RESIST, "Radiation exposure resistance");
+    add(avSingleton->agility, Cfg().BUFF_AGILITY, "Agility");
+    add(avSingleton->endurance, Cfg().BUFF_ENDURANCE, "Endurance");
+    add(avSingleton->intelligence, Cfg().BUFF_INTELLIGENCE, "Intelligence");
+    add(avSingleton->lockpicking, Cfg().BUFF_LOCKPICK, "Lockpick");
+    add(avSingleton->luck, Cfg().BUFF_LUCK, "Luck");
+    add(avSingleton->perception, Cfg().BUFF_PERCEPTION, "Perception");
+    add(avSingleton->sneak, Cfg().BUFF_SNEAK, "Sneak");
+    add(avSingleton->strength, Cfg().BUFF_STRENGTH, "Strength");
+    add(avSingleton->carryWeight, Cfg().BUFF_CARRYWEIGHT, "Carry Weight");
+    // Keep the current table (and generation) if nothing changed
+    auto current = g_buffTable.load(std::memory_order_acquire);
+    if (BuffEngine::SameEntries(entries, current->entries))
+        return;
+    auto next = std::make_shared<BuffTable>();
+    next->generation = current->generation + 1;
+    next->entries = std::move(entries);
+    if (DEBUGGING)
+        REX::INFO("BuildBuffTable_Internal: Buff table rebuilt with {} entries (generation {})", next->entries.size(), next->generation);
+    g_buffTable.store(std::move(next), std::memory_order_release);
+}
+
+// Build the lookup sets of the current config generation, publish them once game data is ready
+void CompileConfig_Internal() {
+    const Config& config = Cfg();
+    auto current = g_compiledConfig.load(std::memory_order_acquire);
+    if (current->generation == config.generation && current->formsResolved)
+        return;
+    auto next = std::make_shared<CompiledConfig>();
+    next->generation = config.generation;
+    next->formsResolved = g_dataHandle != nullptr;
+    next->excludedActors.Reserve(config.EXCLUDE_ACTOR_ID_LIST.size());
+    for (std::uint32_t actorID : config.EXCLUDE_ACTOR_ID_LIST)
+        next->excludedActors.Insert(actorID, 1);
+    // Loot decision per form type, unknown types are never looted
+    next->lootEnabled = config.LOOT_ENABLED;
+    if (config.LOOT_ENABLED) {
+        next->lootRules[static_cast<std::uint8_t>(RE::ENUM_FORM_ID::kMISC)] = config.LOOT_JUNK ? LOOT_RULE::ALWAYS : LOOT_RULE::NEVER;
+        next->lootRules[static_cast<std::uint8_t>(RE::ENUM_FORM_ID::kAMMO)] = config.LOOT_AMMO ? LOOT_RULE::ALWAYS : LOOT_RULE::NEVER;
+        next->lootRules[static_cast<std::uint8_t>(RE::ENUM_FORM_ID::kALCH)] = config.LOOT_AID ? LOOT_RULE::ALWAYS : LOOT_RULE::NEVER;
+        next->lootRules[static_cast<std::uint8_t>(RE::ENUM_FORM_ID::kWEAP)] = LOOT_RULE::VALUE;
+        next->lootRules[static_cast<std::uint8_t>(RE::ENUM_FORM_ID::kARMO)] = LOOT_RULE::VALUE;
+    }
+    next->lootMinValue = config.LOOT_MIN_VALUE;
+    next->lootMaxValue = config.LOOT_MAX_VALUE;
+    // Forms can only be resolved once the game data is loaded
+    if (next->formsResolved) {
+        next->stimpakRaces.Reserve(config.RACE_STIMPAK_ID.size());
+        for (std::uint32_t raceID : config.RACE_STIMPAK_ID) {
+            auto* race = GetFormByFileAndID_Internal<RE::TESRace>(raceID);
+            if (race)
+                next->stimpakRaces.Insert(race->GetFormID(), 1);
+            else if (DEBUGGING)
+                REX::WARN("CompileConfig_Internal: Race with ID 0x{:08X} not found", raceID);
+        }
+        for (std::uint32_t perkID : config.PERK_ID_LIST) {
+            auto* perk = GetFormByFileAndID_Internal<RE::BGSPerk>(perkID);
+            if (perk) {
+                next->perks.push_back(perk);
+                if (DEBUGGING)
+                    REX::INFO("CompileConfig_Internal: Perk found with ID 0x{:08X}", perkID);
+            } else {
+                if (DEBUGGING)
+                    REX::WARN("CompileConfig_Internal: Perk with ID 0x{:08X} not found", perkID);
             }
-            if (DEBUGGING)
-                REX::INFO("BuffCompanions: Sneak of {} is {:.2f}", actor->GetDisplayFullName(), currentSneak);
-        } else {
-            if (DEBUGGING)
-                REX::WARN("BuffCompanions: Sneak ActorValue not found!");
-        }
-        // Strength buff
-        auto* strengthAV = RE::ActorValue::GetSingleton()->strength;
-        if (strengthAV) {
-            float currentStrength = actor->GetActorValue(*strengthAV);
-            if (currentStrength < BUFF_STRENGTH) {
-                // Calculate exactly how much we need to add to hit the floor
-                float missingAmount = BUFF_STRENGTH - currentStrength;
-                // Add strength buff based on BUFF_STRENGTH
-                actor->ModActorValue(RE::ACTOR_VALUE_MODIFIER::kPermanent, *strengthAV, missingAmount);
-                currentStrength = actor->GetActorValue(*strengthAV);
+        }
+        for (std::uint32_t keywordID : config.KEYWORD_ID_LIST) {
+            auto* keyword = GetFormByFileAndID_Internal<RE::BGSKeyword>(keywordID);
+            if (keyword) {
+                next->keywords.push_back(keyword);
+                if (DEBUGGING)
+                    REX::INFO("CompileConfig_Internal: Keyword found with ID 0x{:08X}", keywordID);
+            } else {
+                if (DEBUGGING)
+                    REX::WARN("CompileConfig_Internal: Keyword with ID 0x{:08X} not found", keywordID);
             }
-            if (DEBUGGING)
-                REX::INFO("BuffCompanions: Strength of {} is {:.2f}", actor->GetDisplayFullName(), currentStrength);
-        } else {
-            if (DEBUGGING)
-                REX::WARN("BuffCompanions: Strength ActorValue not found!");
-        }
-        // Carry weight buff
-        auto* carryWeightAV = RE::ActorValue::GetSingleton()->carryWeight;
-        if (carryWeightAV) {
-            float currentCarryWeight = actor->GetActorValue(*carryWeightAV);
-            if (currentCarryWeight < BUFF_CARRYWEIGHT) {
-                // Calculate exactly how much we need to add to hit the floor
-                float missingAmount = BUFF_CARRYWEIGHT - currentCarryWeight;
-                // Add carry weight buff based on BUFF_CARRYWEIGHT
-                actor->ModActorValue(RE::ACTOR_VALUE_MODIFIER::kPermanent, *carryWeightAV, missingAmount);
-                currentCarryWeight = actor->GetActorValue(*carryWeightAV);
+        }
+        // Loot keyword lists
+        for (auto [ids, keywords] : {std::pair{&config.LOOT_KEYWORD_ALLOW, &next->lootKeywordAllow}, std::pair{&config.LOOT_KEYWORD_DENY, &next->lootKeywordDeny}}) {
+            keywords->Reserve(ids->size());
+            for (std::uint32_t keywordID : *ids) {
+                auto* keyword = GetFormByFileAndID_Internal<RE::BGSKeyword>(keywordID);
+                if (keyword)
+                    keywords->Insert(keyword->GetFormID(), 1);
+                else if (DEBUGGING)
+                    REX::WARN("CompileConfig_Internal: Loot keyword with ID 0x{:08X} not found", keywordID);
             }
-            if (DEBUGGING)
-                REX::INFO("BuffCompanions: Carry Weight of {} is {:.2f}", actor->GetDisplayFullName(), currentCarryWeight);
-        } else {
-            if (DEBUGGING)
-                REX::WARN("BuffCompanions: Carry Weight ActorValue not found!");
         }
-        companionData.buffed = true;
     }
+    if (DEBUGGING)
+        REX::INFO("CompileConfig_Internal: Compiled config generation {} ({} excluded, {} races, {} perks, {} keywords, {}/{} loot keywords allowed/denied)", next->generation, next->excludedActors.Size(), next->stimpakRaces.Size(), next->perks.size(), next->keywords.size(), next->lootKeywordAllow.Size(), next->lootKeywordDeny.Size());
+    g_compiledConfig.store(std::move(next), std::memory_order_release);
 }
 
 // Helper function to get distance between Actor and Player
 bool CheckActorHasItem_Internal(RE::Actor* actor, RE::TESForm* itemForm) {
     if (!actor || !itemForm)
         return false;
-    auto* invList = actor->inventoryList;
-    if (!invList)
-        return false;
     // Check if the item exists in the inventory
-    for (const auto& item : invList->data) {
-        if (item.object == itemForm && item.GetCount() > 0) {
-            return true;
-        }
-    }
-    return false;
+    auto* index = InventoryCache::Get(actor);
+    return index && InventoryCache::GetCount(*index, itemForm->GetFormID()) > 0;
 }
 
 // Helper function to check Actor states
@@ -1036,265 +929,146 @@ bool CheckIsCurrentCellSettlement_Internal() {
     return encounterZone->data.flags.all(RE::ENCOUNTER_ZONE_DATA::FLAG::kWorkshopZone);
 }
 
-// Create tracked data for an actor
-TrackedActorData CreateTrackedData_Internal(RE::Actor* actor, ENEMY_TIER tier) {
-    TrackedActorData data{};
-    data.actor = actor;
-    data.tier = tier;
-    data.aiUpdated = false;
-    data.lastUpdate = std::chrono::steady_clock::now();
-    if (!actor)
-        return data;
-    // Distance
-    data.distanceToPlayer = GetActorDistanceToPlayer_Internal(actor);
-    // States
-    auto states = CheckActorStates(actor);
-    data.lifeState = states.lifeState;
-    data.weaponState = states.weaponState;
-    data.gunState = states.gunState;
-    data.interactingState = states.interactingState;
-    // Health
-    auto* health = RE::ActorValue::GetSingleton()->health;
-    if (health) {
-        float currentHealth = actor->GetActorValue(*health);
-        data.maxHealth = actor->GetPermanentActorValue(*health);
-        data.healthPercent = (data.maxHealth > 0) ? (currentHealth / data.maxHealth) : 0.0f;
-    }
-    // Combat state
-    data.isAlerted = actor->IsInCombat();
-    // NPC info
-    auto* npc = actor->GetNPC();
-    if (npc) {
-        data.isUnique = npc->IsUnique();
-        data.isLegendary = (npc->legendTemplate != nullptr || npc->legendChance != nullptr);
-    }
-    return data;
-}
-
 // Analyze enemy threat level of an actor
 EnemyAnalysis EnemyActorAnalyze_Internal(RE::Actor* actor) {
-    EnemyAnalysis analysis{};
-    analysis.tier = ENEMY_TIER::LOW; // Default
-    if (!actor)
-        return analysis;
-    auto* npc = actor->GetNPC();
-    if (!npc)
-        return analysis;
-    // Get actor's current/max health
-    float currentHealth = actor->GetActorValue(*RE::ActorValue::GetSingleton()->health);
-    float maxHealth = actor->GetPermanentActorValue(*RE::ActorValue::GetSingleton()->health);
-    // Calculate health percentage relative to strongest enemy
-    analysis.healthPercentOfMax = (maxHealth > 0.0f) ? (currentHealth / g_enemyMaxHealthInCell.load()) : 0.0f;
-    // Check unique/legendary status
-    analysis.isUnique = npc->IsUnique();
-    analysis.isLegendary = (npc->legendTemplate != nullptr || npc->legendChance != nullptr);
-    // Check if alerted/in combat
-    analysis.isAlerted = actor->IsInCombat();
-    // Check equipped weapon to determine combat type
-    int weaponThreatBonus = 0;
-    if (actor->currentProcess && actor->currentProcess->middleHigh) {
-        auto& equippedItems = actor->currentProcess->middleHigh->equippedItems;
-        for (auto& equippedItem : equippedItems) {
-            if (auto* weapon = equippedItem.item.object->As<RE::TESObjectWEAP>()) {
-                std::uint32_t weaponValue = weapon->weaponData.value;
-                // Weapon value-based threat scaling
-                if (weaponValue >= 1000) {
-                    weaponThreatBonus = 3; // Legendary/Unique weapons
-                } else if (weaponValue >= 500) {
-                    weaponThreatBonus = 2; // Heavily modified/enchanted
-                } else if (weaponValue >= 250) {
-                    weaponThreatBonus = 1; // Standard modified weapon
-                }
-                // Check weapon damage
-                float weaponDamage = weapon->weaponData.attackDamage;
-                if (weaponDamage > 100) {
-                    weaponThreatBonus += 1; // High-damage weapon
-                }
-                // Determine combat style from animation type
-                auto weaponType = weapon->weaponData.type.get();
-                if (weaponType == RE::WEAPON_TYPE::kHandToHand || weaponType == RE::WEAPON_TYPE::kOneHandSword || weaponType == RE::WEAPON_TYPE::kOneHandDagger || weaponType == RE::WEAPON_TYPE::kOneHandAxe || weaponType == RE::WEAPON_TYPE::kOneHandMace || weaponType == RE::WEAPON_TYPE::kTwoHandSword || weaponType == RE::WEAPON_TYPE::kTwoHandAxe) {
-                    analysis.isMelee = true;
-                    weaponThreatBonus += 2; // Melee = high threat (gets in your face)
-                } else if (weaponType == RE::WEAPON_TYPE::kGrenade || weaponType == RE::WEAPON_TYPE::kMine) {
-                    analysis.hasGrenades = true;
-                    analysis.isRanged = true;
-                    weaponThreatBonus += 2; // Explosives = high threat (area damage)
-                } else if (weaponType == RE::WEAPON_TYPE::kGun || weaponType == RE::WEAPON_TYPE::kBow || weaponType == RE::WEAPON_TYPE::kStaff) {
-                    analysis.isRanged = true;
-                    weaponThreatBonus += 1; // Ranged = moderate threat (can be avoided)
-                }
-            }
-        }
-    }
-    // Calculate tier based on multiple factors
-    int threatScore = 0;
-    // Add weapon threat bonus
-    threatScore += (weaponThreatBonus * THREAT_WEAPON_BONUS);
-    // Check display name for "Legendary" prefix (more reliable than template check)
-    auto displayName = actor->GetDisplayFullName();
-    if (displayName) {
-        std::string nameStr(displayName);
-        if (nameStr.find("Legendary") != std::string::npos) {
-            analysis.isLegendary = true;
-            threatScore += (3 * THREAT_LEGENDARY_BONUS); // always high threat for legendary enemies
-        }
-    }
-    // Health factor (0-3 points)
-    if (analysis.healthPercentOfMax > 0.8f)
-        threatScore += (3 * THREAT_HEALTH_BONUS);
-    else if (analysis.healthPercentOfMax > 0.5f)
-        threatScore += (2 * THREAT_HEALTH_BONUS);
-    else if (analysis.healthPercentOfMax > 0.3f)
-        threatScore += (1 * THREAT_HEALTH_BONUS);
-    // Special status (0-3 points) - only if not already counted from name
-    if (!analysis.isLegendary && npc->legendTemplate) {
-        analysis.isLegendary = true;
-        threatScore += (3 * THREAT_LEGENDARY_BONUS);
-    } else if (analysis.isUnique) {
-        threatScore += (2 * THREAT_UNIQUE_BONUS);
-    }
-    // Alert status (0-1 point)
-    if (analysis.isAlerted)
-        threatScore += (1 * THREAT_ALERT_BONUS);
-    // Assign tier based on total score
-    if (threatScore >= 7) {
-        analysis.tier = ENEMY_TIER::HIGH;
-    } else if (threatScore >= 4) {
-        analysis.tier = ENEMY_TIER::MEDIUM;
-    } else {
+    if (!actor) {
+        EnemyAnalysis analysis{};
         analysis.tier = ENEMY_TIER::LOW;
+        return analysis;
     }
-    return analysis;
+    auto record = ActorPipeline::GatherActor(actor, RE::PlayerCharacter::GetSingleton(), *g_compiledConfig.load(std::memory_order_acquire));
+    return ActorPipeline::ScoreEnemy(record, g_enemyMaxHealthInCell.load(), ActorPipeline::MakeAnalyzeParams());
 }
 
-// Informational function to analyze all enemies and return tier distribution
-std::map<ENEMY_TIER, int> EnemyActorAnalyzeThreatLevel_Internal(std::vector<TrackedActorData> enemyData) {
-    std::map<ENEMY_TIER, int> tierCount{{ENEMY_TIER::LOW, 0}, {ENEMY_TIER::MEDIUM, 0}, {ENEMY_TIER::HIGH, 0}};
-    if (enemyData.empty())
-        return tierCount;
-    // Analyze each enemy
-    for (auto& enemyDataEntry : enemyData) {
-        if (!enemyDataEntry.actor)
-            continue;
-        auto analysis = EnemyActorAnalyze_Internal(enemyDataEntry.actor);
-        tierCount[analysis.tier]++;
-    }
+// Informational function to return the enemy tier distribution of a snapshot
+std::map<ENEMY_TIER, int> EnemyActorAnalyzeThreatLevel_Internal(const ActorTracking::Snapshot& snapshot) {
+    // Counted once when the snapshot was published (no engine access, safe off the main thread)
+    std::map<ENEMY_TIER, int> tierCount;
+    for (auto tier : {ENEMY_TIER::LOW, ENEMY_TIER::MEDIUM, ENEMY_TIER::HIGH})
+        tierCount[tier] = static_cast<int>(snapshot.enemyTierCounts[static_cast<std::size_t>(tier)]);
     return tierCount;
 }
 
 // Equip the best items from inventory
 void EquipCompanions_Internal() {
-    std::vector<int> slotOrder = {33, 30, 41, 42, 43, 44, 45};
     // Go over each companion and equip best armor item
-    auto companionDataCopy = ActorTracking::GetCompanionData();
-    for (auto& companionData : companionDataCopy) {
-        auto* actor = companionData.actor;
-        if (!actor)
-            continue;
-        auto* compInv = actor->inventoryList;
-        if (!compInv)
-            continue;
-        if (actor->IsInCombat())
-            continue; // Skip if in combat
-        // Equip best armor for each slot
-        for (int slot : slotOrder) {
-            RE::BGSInventoryItem* bestArmorItem = nullptr;
-            float bestArmorValue = 0.0f;
-            // Iterate through inventory to find best item for the slot
-            for (auto& item : compInv->data) {
-                // Early exit if not armor/weapon
-                if (!IsArmorItem_Internal(item.object))
-                    continue;
-                auto* armor = item.object->As<RE::TESObjectARMO>();
-                // Check if armor fits the slot
-                if ((armor->bipedModelData.bipedObjectSlots & GetSlotMaskFromIndex_Internal(slot)) != 0) {
-                    // Get armor value
-                    float armorValue = armor->armorData.value;
-                    // Check if this is the best item so far
-                    if (armorValue > bestArmorValue) {
-                        bestArmorValue = armorValue;
-                        bestArmorItem = &item;
-                    }
-                }
-            }
-            // Equip the best item found for the slot
-            if (bestArmorItem && !IsActorItemEquipped_Internal(actor, bestArmorItem)) {
-                EquipInventoryItem_Internal(actor, bestArmorItem);
-                if (DEBUGGING)
-                    REX::INFO("EquipCompanions_Internal: Equipped {} on {} for slot {}", bestArmorItem->GetDisplayFullName(std::uint8_t(0)), actor->GetDisplayFullName(), slot);
-            }
-        }
-        // Equip best weapon
-        RE::BGSInventoryItem* bestWeaponItem = nullptr;
-        float bestWeaponValue = 0.0f;
-        for (auto& item : compInv->data) {
-            // Early exit if not weapon
-            if (!IsWeaponItem_Internal(item.object))
-                continue;
-            auto* weapon = item.object->As<RE::TESObjectWEAP>();
-            // Get weapon value
-            float weaponValue = weapon->weaponData.value;
-            // Check if this is the best weapon so far
-            if (weaponValue > bestWeaponValue) {
-                bestWeaponValue = weaponValue;
-                bestWeaponItem = &item;
-            }
-        }
-        // Equip the best weapon found
-        if (bestWeaponItem && !IsActorItemEquipped_Internal(actor, bestWeaponItem)) {
-            EquipInventoryItem_Internal(actor, bestWeaponItem);
-            if (DEBUGGING)
-                REX::INFO("EquipCompanions_Internal: Equipped {} on {} for weapon slot", bestWeaponItem->GetDisplayFullName(std::uint8_t(0)), actor->GetDisplayFullName());
-        }
+    auto snapshot = ActorTracking::GetSnapshot();
+    for (const auto& companionData : snapshot->companions)
+        EquipCompanions_Internal(companionData);
+}
+
+// Equip the best items from inventory (single companion slice)
+void EquipCompanions_Internal(const TrackedActorData& companionData) {
+    auto* actor = companionData.actor;
+    if (!actor)
+        return;
+    auto* index = InventoryCache::Get(actor);
+    if (!index)
+        return;
+    if (actor->IsInCombat())
+        return; // Skip if in combat
+    // Equip best armor for each slot
+    for (std::size_t slot = 0; slot < InventoryCache::ARMOR_SLOT_ORDER.size(); ++slot) {
+        auto* bestArmorItem = InventoryCache::GetItem(actor, *index, index->bestArmor[slot]);
+        // Equip the best item found for the slot
+        if (bestArmorItem && !IsActorItemEquipped_Internal(actor, bestArmorItem)) {
+            EquipInventoryItem_Internal(actor, bestArmorItem);
+            if (DEBUGGING)
+                REX::INFO("EquipCompanions_Internal: Equipped {} on {} for slot {}", bestArmorItem->GetDisplayFullName(std::uint8_t(0)), actor->GetDisplayFullName(), InventoryCache::ARMOR_SLOT_ORDER[slot]);
+        }
+    }
+    // Equip the best weapon found
+    auto* bestWeaponItem = InventoryCache::GetItem(actor, *index, index->bestWeapon);
+    if (bestWeaponItem && !IsActorItemEquipped_Internal(actor, bestWeaponItem)) {
+        EquipInventoryItem_Internal(actor, bestWeaponItem);
+        if (DEBUGGING)
+            REX::INFO("EquipCompanions_Internal: Equipped {} on {} for weapon slot", bestWeaponItem->GetDisplayFullName(std::uint8_t(0)), actor->GetDisplayFullName());
     }
 }
 
-// Equip the best items from inventory
+// Top up the ammunition of all companions
 void EquipAmmunition_Internal() {
+    auto snapshot = ActorTracking::GetSnapshot();
+    EquipAmmunition_Internal(snapshot->companions);
+}
+
+// Top up the ammunition of all companions, one add per companion and ammo type
+void EquipAmmunition_Internal(const std::vector<TrackedActorData>& companions) {
     // Check if any inventory menu is open, no refilling during menu interaction
     if (IsInventoryMenuOpen_Internal())
         return;
-    // Go over each companion and equip ammo for equipped weapons
-    auto companionDataCopy = ActorTracking::GetCompanionData();
-    for (auto& companionData : companionDataCopy) {
-        auto* actor = companionData.actor;
-        if (!actor)
+    auto start = std::chrono::steady_clock::now();
+    AmmoTopUpStats stats{};
+    stats.time = start;
+    // Reused between passes, main thread only
+    static std::vector<AmmoDeficit> deficits;
+    deficits.clear();
+    // One pass over the equipped weapons and the cached inventory counts
+    for (const auto& companionData : companions)
+        AmmoCollectDeficits_Internal(companionData, deficits, stats);
+    // One add per companion and ammo type
+    for (const auto& deficit : deficits) {
+        std::int32_t ammoToAdd = deficit.minimum - deficit.count;
+        deficit.actor->AddObjectToContainer(deficit.ammo, nullptr, ammoToAdd, nullptr, RE::ITEM_REMOVE_REASON::kStoreContainer);
+        InventoryCache::Invalidate(deficit.actor->GetFormID());
+        stats.added += ammoToAdd;
+        if (DEBUGGING)
+            REX::INFO("EquipAmmunition_Internal: Adding {} of ammo {} to {}.", ammoToAdd, deficit.ammo->GetFullName(), deficit.actor->GetDisplayFullName());
+    }
+    stats.deficits = static_cast<std::uint32_t>(deficits.size());
+    stats.runTime = std::chrono::steady_clock::now() - start;
+    g_ammoHistory.Push(stats);
+    if (DEBUGGING && stats.deficits > 0) {
+        // Cost over the recent passes
+        std::int64_t added = 0;
+        std::uint64_t topUps = 0;
+        std::chrono::steady_clock::duration runTime{};
+        for (std::size_t i = 0; i < g_ammoHistory.Size(); ++i) {
+            added += g_ammoHistory[i].added;
+            topUps += g_ammoHistory[i].deficits;
+            runTime += g_ammoHistory[i].runTime;
+        }
+        using ms = std::chrono::duration<double, std::milli>;
+        REX::INFO("EquipAmmunition_Internal: {} companions, {} weapons, {} top-ups, {} rounds in {:.3f}ms (last {} passes: {} top-ups, {} rounds, {:.3f}ms)", stats.companions, stats.weapons, stats.deficits, stats.added, ms(stats.runTime).count(), g_ammoHistory.Size(), topUps, added, ms(runTime).count());
+    }
+}
+
+// Add the ammunition a companion is short of for all its equipped weapons (same ammo merged)
+void AmmoCollectDeficits_Internal(const TrackedActorData& companionData, std::vector<AmmoDeficit>& deficits, AmmoTopUpStats& stats) {
+    auto* actor = companionData.actor;
+    if (!actor || !actor->currentProcess || !actor->currentProcess->middleHigh)
+        return;
+    auto* index = InventoryCache::Get(actor);
+    if (!index)
+        return;
+    stats.companions++;
+    std::size_t first = deficits.size();
+    for (const auto& equippedItem : actor->currentProcess->middleHigh->equippedItems) {
+        auto* weapon = equippedItem.item.object ? equippedItem.item.object->As<RE::TESObjectWEAP>() : nullptr;
+        auto* ammo = weapon ? weapon->weaponData.ammo : nullptr;
+        if (!ammo)
             continue;
-        auto* compInv = actor->inventoryList;
-        if (!compInv)
+        stats.weapons++;
+        std::int32_t minimum = AmmoMinimum_Internal(weapon);
+        // Weapons sharing an ammo type need the highest minimum, not the sum
+        auto it = std::find_if(deficits.begin() + first, deficits.end(), [ammo](const AmmoDeficit& deficit) { return deficit.ammo == ammo; });
+        if (it != deficits.end()) {
+            it->minimum = (std::max)(it->minimum, minimum);
             continue;
-        // Check for ammo needs
-        if (actor->currentProcess && actor->currentProcess->middleHigh) {
-            auto& equippedItems = actor->currentProcess->middleHigh->equippedItems; // Ensure equippedItems is valid
-            for (const auto& equippedItem : equippedItems) {
-                auto* weapon = equippedItem.item.object->As<RE::TESObjectWEAP>();
-                if (weapon) {
-                    auto* ammo = weapon->weaponData.ammo;
-                    if (ammo) {
-                        // Now check inventory for ammo count
-                        int ammoCount = 0;
-                        auto* invList = actor->inventoryList;
-                        if (invList) {
-                            for (const auto& item : invList->data) {
-                                if (item.object == ammo) {
-                                    ammoCount = item.GetCount();
-                                    break;
-                                }
-                            }
-                        }
-                        // If ammo count is less than desired amount, add more
-                        if (ammoCount < AI_EQUIP_AMMO_AMOUNT) {
-                            int ammoToAdd = AI_EQUIP_AMMO_AMOUNT - ammoCount;
-                            actor->AddObjectToContainer(weapon->weaponData.ammo, nullptr, ammoToAdd, nullptr, RE::ITEM_REMOVE_REASON::kStoreContainer);
-                            if (DEBUGGING)
-                                REX::INFO("EquipCompanions_Internal: Adding {} of ammo {} to NPC inventory.", ammoToAdd, ammo->GetFullName());
-                            return; // Only equip ammo for the equipped weapon
-                        }
-                    }
-                }
-            }
         }
+        deficits.push_back({actor, ammo, InventoryCache::GetCount(*index, ammo->GetFormID()), minimum});
     }
+    // Keep only the real deficits
+    deficits.erase(std::remove_if(deficits.begin() + first, deficits.end(), [](const AmmoDeficit& deficit) { return deficit.count >= deficit.minimum; }), deficits.end());
+}
+
+// Minimum rounds for a weapon: by weapon type, and never less than one full magazine
+std::int32_t AmmoMinimum_Internal(RE::TESObjectWEAP* weapon) {
+    if (!weapon)
+        return 0;
+    bool automatic = weapon->weaponData.flags.any(RE::WEAPON_FLAGS::kAutomatic);
+    std::int32_t minimum = automatic ? Cfg().AI_EQUIP_AMMO_AMOUNT_AUTOMATIC : Cfg().AI_EQUIP_AMMO_AMOUNT;
+    return (std::max)(minimum, static_cast<std::int32_t>(weapon->weaponData.ammoCapacity));
 }
 
 // Helper function to equip a single inventory item to an NPC
@@ -1352,19 +1126,15 @@ std::vector<RE::Actor*> GetAllActors_Internal() {
     auto* processLists = RE::ProcessLists::GetSingleton();
     if (!player || !processLists)
         return actors;
+    // Compare squared distances to skip the sqrt per actor
+    const float searchRadiusSq = Cfg().ACTOR_SEARCH_RADIUS * Cfg().ACTOR_SEARCH_RADIUS;
     // Check high priority actors
     for (auto& actorHandle : processLists->highActorHandles) {
         if (auto* actor = actorHandle.get().get()) {
             // Filter by distance instead of cell (true "radar" approach)
-            auto actorPos = actor->GetPosition();
-            float dx = actorPos.x - playerPos.x;
-            float dy = actorPos.y - playerPos.y;
-            float dz = actorPos.z - playerPos.z;
-            float distance = std::sqrt(dx * dx + dy * dy + dz * dz);
-
             // Include actors within a reasonable radius
             // Adjust this value based on your needs
-            if (distance <= ACTOR_SEARCH_RADIUS) {
+            if (DistanceSquared(actor->GetPosition(), playerPos) <= searchRadiusSq) {
                 actorSet.insert(actor);
             }
         }
@@ -1372,13 +1142,7 @@ std::vector<RE::Actor*> GetAllActors_Internal() {
     // Also check medium-high actors (companions might be here when further away)
     for (auto& actorHandle : processLists->middleHighActorHandles) {
         if (auto* actor = actorHandle.get().get()) {
-            auto actorPos = actor->GetPosition();
-            float dx = actorPos.x - playerPos.x;
-            float dy = actorPos.y - playerPos.y;
-            float dz = actorPos.z - playerPos.z;
-            float distance = std::sqrt(dx * dx + dy * dy + dz * dz);
-
-            if (distance <= ACTOR_SEARCH_RADIUS) {
+            if (DistanceSquared(actor->GetPosition(), playerPos) <= searchRadiusSq) {
                 actorSet.insert(actor);
             }
         }
@@ -1386,13 +1150,7 @@ std::vector<RE::Actor*> GetAllActors_Internal() {
     // Also check low actors (companions might be here when further away)
     for (auto& actorHandle : processLists->lowActorHandles) {
         if (auto* actor = actorHandle.get().get()) {
-            auto actorPos = actor->GetPosition();
-            float dx = actorPos.x - playerPos.x;
-            float dy = actorPos.y - playerPos.y;
-            float dz = actorPos.z - playerPos.z;
-            float distance = std::sqrt(dx * dx + dy * dy + dz * dz);
-
-            if (distance <= ACTOR_SEARCH_RADIUS) {
+            if (DistanceSquared(actor->GetPosition(), playerPos) <= searchRadiusSq) {
                 actorSet.insert(actor);
             }
         }
@@ -1491,91 +1249,6 @@ RE::BGSInventoryItem::Stack* GetInventoryItemStackData_Internal(RE::BGSInventory
     return nullptr;
 }
 
-// Helper to find a valid X,Y position by scanning around
-RE::NiPoint3 GetPointXY_Internal(RE::NiPoint3 a_pos, RE::CFilter a_filter, float a_stepRadians, float a_scanDistance, float a_moveDistance) {
-    auto* player = RE::PlayerCharacter::GetSingleton();
-    if (!player || !player->parentCell)
-        return a_pos;
-    const float scanDistance = a_scanDistance;
-    const float stepRadians = a_stepRadians;
-    const float moveDistance = a_moveDistance;
-    const float TWO_PI = 6.28318530717958647692f;
-    RE::bhkPickData pickData;
-    bool found = false;
-    float bestDist = FLT_MAX;
-    float bestDirX = 0.0f, bestDirY = 0.0f;
-    // For each sampled direction cast a horizontal-ish ray and record closest hit
-    for (float angle = 0.0f; angle < TWO_PI; angle += stepRadians) {
-        float dx = std::cos(angle);
-        float dy = std::sin(angle);
-        RE::NiPoint3 rayStart{a_pos.x, a_pos.y, a_pos.z + 50.0f};
-        RE::NiPoint3 rayEnd{a_pos.x + dx * scanDistance, a_pos.y + dy * scanDistance, a_pos.z + 50.0f};
-        pickData.SetStartEnd(rayStart, rayEnd);
-        pickData.collisionFilter.filter = a_filter.filter;
-        // Find the hitpoint along the ray
-        auto* hitObj = player->parentCell->Pick(pickData);
-        if (pickData.HasHit()) {
-            // fraction is along the ray from rayStart->rayEnd (0..1)
-            float fraction = pickData.GetHitFraction();
-            float hitDist = fraction * scanDistance;
-            if (hitDist < bestDist) {
-                bestDist = hitDist;
-                bestDirX = dx;
-                bestDirY = dy;
-                found = true;
-            }
-        }
-    }
-    // If hit, move position towards closest hit point
-    if (found) {
-        // Move position towards closest hit point
-        a_pos.x += bestDirX * moveDistance;
-        a_pos.y += bestDirY * moveDistance;
-    }
-    return a_pos;
-}
-
-// Helper to find the ground Z coordinate at a given X,Y position
-float GetPointZ_Internal(RE::NiPoint3 a_pos, RE::CFilter a_filter, float a_scanDistanceUp, float a_scanDistanceDown) {
-    auto* player = RE::PlayerCharacter::GetSingleton();
-    if (!player || !player->parentCell)
-        return a_pos.z;
-    // Get the physics world from the current cell
-    auto* world = player->parentCell->GetbhkWorld();
-    if (!world)
-        return a_pos.z;
-    // Offset matrix to test multiple rays around the position
-    RE::NiPoint3 offsets[] = {
-        { 0.0f, 0.0f, 0.0f }, // The center point
-        { 10.0f, 0.0f, 0.0f },
-        { -10.0f, 0.0f, 0.0f },
-        { 0.0f, 10.0f, 0.0f },
-        { 0.0f, -10.0f, 0.0f } // Cross pattern around the point
-    };
-    int hits = 0;
-    double sumZ = 0.0;
-    for (auto& off : offsets) {
-        RE::bhkPickData pickData; // Initializing PickData every iteration to reset previous hit info
-        pickData.collisionFilter.filter = a_filter.filter;
-        RE::NiPoint3 rayStart{ a_pos.x + off.x, a_pos.y + off.y, a_pos.z + a_scanDistanceUp };
-        RE::NiPoint3 rayEnd  { a_pos.x + off.x, a_pos.y + off.y, a_pos.z - a_scanDistanceDown };
-        pickData.SetStartEnd(rayStart, rayEnd);
-            player->parentCell->Pick(pickData);
-            if (pickData.HasHit()) {
-                float frac = pickData.GetHitFraction();
-                float hitZ = rayStart.z + (rayEnd.z - rayStart.z) * frac;
-                sumZ += hitZ;
-                ++hits;
-            }
-        }
-    if (hits > 0) {
-        // Return average Z of all hits
-        return static_cast<float>(sumZ / hits);
-    }
-    // Return original if no ground was found
-    return a_pos.z;
-}
-
 // Helper function to convert a Papyrus slot index to a bitmask.
 // This function now handles all slots from 30 to 61 using a bitwise shift.
 std::uint32_t GetSlotMaskFromIndex_Internal(std::int32_t aiSlotIndex) {
@@ -1660,83 +1333,54 @@ void HealActorHealth_Internal(RE::Actor* actor, float healthPercent) {
         actor->ModActorValue(RE::ACTOR_VALUE_MODIFIER::kTemporary, *healthAV, delta);
         float newHealth = actor->GetActorValue(*healthAV);
         float newPercent = (maxHealth > 0) ? (newHealth / maxHealth) * 100.0f : 0.0f;
-        if (DEBUGGING)
-            REX::INFO("HealActorHealth_Internal: Healed actor {} from {:.2f} to {:.2f} health ({:.2f}%).", actor->GetDisplayFullName(), currentHealth, newHealth, newPercent);
-    }
-}
-
-// Helper function to heal all actor Power Armour
-void HealActorPA_Internal(RE::Actor* actor) {
-    if (!actor) return;
-    // Power armour are equpped items that have the ArmorTypePower keyword
-    auto* invList = actor->inventoryList;
-    if (!invList) return;
-    for (auto& item : invList->data) {
-        if (!IsArmorItem_Internal(item.object))
-            continue;
-        auto* armor = item.object->As<RE::TESObjectARMO>();
-        if (!armor)
-            continue;
-        // Armor pieces but not the frame itself
-        if (armor->HasKeyword(g_kwdArmorTypePower) && !armor->HasKeyword(g_kwdIsPowerArmorFrame)) {
-            RE::BGSInventoryItem::Stack* stackData = GetInventoryItemStackData_Internal(&item);
-            if (stackData && stackData->extra && stackData->IsEquipped()) {
-                float curPct = stackData->extra->GetHealthPercent();   // 0..1
-                if (curPct >= 1.0f)
-                    continue; // already at max
-                float newPct = std::clamp(curPct + PA_REPAIR_AMOUNT, 0.0f, 1.0f); // heal 1% and cap at 100%
-                stackData->extra->SetHealthPercent(newPct);
-                if (DEBUGGING)
-                    REX::INFO("HealActorPA_Internal: Repaired power armor item: {} from {:.2f}% to {:.2f}%.", armor->GetFullName(), curPct * 100.0f, newPct * 100.0f);
-            }
-        }
-    }
-}
-
-// Initialize global variables
-void InitializeVariables_Internal() {
-    if (g_perkList.empty() || g_perkList.size() < PERK_ID_LIST.size()) {
-        g_perkList.clear();
-        for (std::uint32_t perkID : PERK_ID_LIST) {
-            auto* perk = GetFormByFileAndID_Internal<RE::BGSPerk>(perkID);
-            if (perk) {
-                g_perkList.push_back(perk);
-                if (DEBUGGING)
-                    REX::INFO("InitializeVariables_Internal: Perk found with ID 0x{:08X}", perkID);
-            } else {
-                if (DEBUGGING)
-                    REX::WARN("InitializeVariables_Internal: Perk with ID 0x{:08X} not found", perkID);
-            }
-        }
-    }
-    if (g_keywordList.empty() || g_keywordList.size() < KEYWORD_ID_LIST.size()) {
-        g_keywordList.clear();
-        for (std::uint32_t keywordID : KEYWORD_ID_LIST) {
-            auto* keyword = GetFormByFileAndID_Internal<RE::BGSKeyword>(keywordID);
-            if (keyword) {
-                g_keywordList.push_back(keyword);
-                if (DEBUGGING)
-                    REX::INFO("InitializeVariables_Internal: Keyword found with ID 0x{:08X}", keywordID);
-            } else {
-                if (DEBUGGING)
-                    REX::WARN("InitializeVariables_Internal: Keyword with ID 0x{:08X} not found", keywordID);
-            }
+        if (DEBUGGING)
+            REX::INFO("HealActorHealth_Internal: Healed actor {} from {:.2f} to {:.2f} health ({:.2f}%).", actor->GetDisplayFullName(), currentHealth, newHealth, newPercent);
+    }
+}
+
+// Helper function to heal all actor Power Armour
+void HealActorPA_Internal(RE::Actor* actor) {
+    if (!actor) return;
+    // Power armour are equpped items that have the ArmorTypePower keyword
+    auto* index = InventoryCache::Get(actor);
+    if (!index) return;
+    for (auto entry : index->powerArmorPieces) {
+        auto* item = InventoryCache::GetItem(actor, *index, static_cast<std::int32_t>(entry));
+        if (!item)
+            continue;
+        RE::BGSInventoryItem::Stack* stackData = GetInventoryItemStackData_Internal(item);
+        if (stackData && stackData->extra && stackData->IsEquipped()) {
+            float curPct = stackData->extra->GetHealthPercent();   // 0..1
+            if (curPct >= 1.0f)
+                continue; // already at max
+            float newPct = std::clamp(curPct + Cfg().PA_REPAIR_AMOUNT, 0.0f, 1.0f); // heal 1% and cap at 100%
+            stackData->extra->SetHealthPercent(newPct);
+            if (DEBUGGING)
+                REX::INFO("HealActorPA_Internal: Repaired power armor item: {} from {:.2f}% to {:.2f}%.", item->object->GetFullName(), curPct * 100.0f, newPct * 100.0f);
         }
     }
+}
+
+// Initialize global variables
+void InitializeVariables_Internal() {
+    // Buff table from the current settings
+    BuildBuffTable_Internal();
+    // Lookup sets and resolved lists, once per config generation
+    CompileConfig_Internal();
     // Initialize companion faction pointer
     if (!g_companionFaction) {
-        g_companionFaction = GetFormByFileAndID_Internal<RE::TESFaction>(CURRENT_COMPANION_FACTION_ID);
+        g_companionFaction = GetFormByFileAndID_Internal<RE::TESFaction>(Cfg().CURRENT_COMPANION_FACTION_ID);
         if (g_companionFaction) {
             if (DEBUGGING)
-                REX::INFO("InitializeVariables_Internal: Companion faction found with ID 0x{:08X}", CURRENT_COMPANION_FACTION_ID);
+                REX::INFO("InitializeVariables_Internal: Companion faction found with ID 0x{:08X}", Cfg().CURRENT_COMPANION_FACTION_ID);
         } else {
             if (DEBUGGING)
-                REX::WARN("InitializeVariables_Internal: Companion faction with ID 0x{:08X} not found", CURRENT_COMPANION_FACTION_ID);
+                REX::WARN("InitializeVariables_Internal: Companion faction with ID 0x{:08X} not found", Cfg().CURRENT_COMPANION_FACTION_ID);
         }
     }
     // Initialize actor value pointers
     if (!g_actorValueHCDowned) {
-        g_actorValueHCDowned = GetFormByFileAndID_Internal<RE::ActorValueInfo>(ACTORVALUE_HC_DOWNED_ID);
+        g_actorValueHCDowned = GetFormByFileAndID_Internal<RE::ActorValueInfo>(Cfg().ACTORVALUE_HC_DOWNED_ID);
         if (g_actorValueHCDowned) {
             if (DEBUGGING)
                 REX::INFO("InitializeVariables_Internal: HCDowned ActorValue pointer initialized");
@@ -1747,88 +1391,78 @@ void InitializeVariables_Internal() {
     }
     // Initialize stimpak and repair kit items
     if (!g_itemStimpak) {
-        g_itemStimpak = GetFormByFileAndID_Internal<RE::AlchemyItem>(ITEM_STIMPAK_ID);
+        g_itemStimpak = GetFormByFileAndID_Internal<RE::AlchemyItem>(Cfg().ITEM_STIMPAK_ID);
         if (g_itemStimpak) {
             if (DEBUGGING)
-                REX::INFO("InitializeVariables_Internal: Stimpak item found with ID 0x{:08X}", ITEM_STIMPAK_ID);
+                REX::INFO("InitializeVariables_Internal: Stimpak item found with ID 0x{:08X}", Cfg().ITEM_STIMPAK_ID);
         } else {
             if (DEBUGGING)
-                REX::WARN("InitializeVariables_Internal: Stimpak item with ID 0x{:08X} not found", ITEM_STIMPAK_ID);
+                REX::WARN("InitializeVariables_Internal: Stimpak item with ID 0x{:08X} not found", Cfg().ITEM_STIMPAK_ID);
         }
     }
     if (!g_itemRepairKit) {
         // This is in DLCRobot.esm
-        g_itemRepairKit = GetFormByFileAndID_Internal<RE::AlchemyItem>(ITEM_REPAIRKIT_ID, "DLCRobot.esm");
+        g_itemRepairKit = GetFormByFileAndID_Internal<RE::AlchemyItem>(Cfg().ITEM_REPAIRKIT_ID, "DLCRobot.esm");
         if (g_itemRepairKit) {
             if (DEBUGGING)
-                REX::INFO("InitializeVariables_Internal: Repair Kit item found with ID 0x{:08X}", ITEM_REPAIRKIT_ID);
+                REX::INFO("InitializeVariables_Internal: Repair Kit item found with ID 0x{:08X}", Cfg().ITEM_REPAIRKIT_ID);
         } else {
             if (DEBUGGING)
-                REX::WARN("InitializeVariables_Internal: Repair Kit item with ID 0x{:08X} not found", ITEM_REPAIRKIT_ID);
-        }
-    }
-    // Race form for stimpak usage check
-    if (g_raceStimpak.size() == 0 || g_raceStimpak.size() < RACE_STIMPAK_ID.size()) {
-        g_raceStimpak.clear();
-        for (std::uint32_t raceID : RACE_STIMPAK_ID) {
-            auto* race = GetFormByFileAndID_Internal<RE::TESRace>(raceID);
-            if (race) {
-                g_raceStimpak.push_back(race);
-            }
+                REX::WARN("InitializeVariables_Internal: Repair Kit item with ID 0x{:08X} not found", Cfg().ITEM_REPAIRKIT_ID);
         }
     }
     // Synth 3 component
     if (!g_raceSynth3C) {
-        g_raceSynth3C = GetFormByFileAndID_Internal<RE::TESObjectMISC>(RACE_SYNTH3C_ID);
+        g_raceSynth3C = GetFormByFileAndID_Internal<RE::TESObjectMISC>(Cfg().RACE_SYNTH3C_ID);
         if (g_raceSynth3C) {
             if (DEBUGGING)
-                REX::INFO("InitializeVariables_Internal: Synth 3 Component found with ID 0x{:08X}", RACE_SYNTH3C_ID);
+                REX::INFO("InitializeVariables_Internal: Synth 3 Component found with ID 0x{:08X}", Cfg().RACE_SYNTH3C_ID);
         } else {
             if (DEBUGGING)
-                REX::WARN("InitializeVariables_Internal: Synth 3 Component with ID 0x{:08X} not found", RACE_SYNTH3C_ID);
+                REX::WARN("InitializeVariables_Internal: Synth 3 Component with ID 0x{:08X} not found", Cfg().RACE_SYNTH3C_ID);
         }
     }
     // initialize animation idles
     if (!g_idleStimpak) {
-        g_idleStimpak = GetFormByFileAndID_Internal<RE::TESIdleForm>(IDLE_STIMPAK_ID);
+        g_idleStimpak = GetFormByFileAndID_Internal<RE::TESIdleForm>(Cfg().IDLE_STIMPAK_ID);
         if (g_idleStimpak) {
             if (DEBUGGING)
-                REX::INFO("InitializeVariables_Internal: Stimpak idle found with ID 0x{:08X}", IDLE_STIMPAK_ID);
+                REX::INFO("InitializeVariables_Internal: Stimpak idle found with ID 0x{:08X}", Cfg().IDLE_STIMPAK_ID);
         } else {
             if (DEBUGGING)
-                REX::WARN("InitializeVariables_Internal: Stimpak idle with ID 0x{:08X} not found", IDLE_STIMPAK_ID);
+                REX::WARN("InitializeVariables_Internal: Stimpak idle with ID 0x{:08X} not found", Cfg().IDLE_STIMPAK_ID);
         }
     }
     // Keywords
     if (!g_kwdArmorTypePower) {
-        g_kwdArmorTypePower = GetFormByFileAndID_Internal<RE::BGSKeyword>(KYWD_ARMORTYPEPOWER_ID);
+        g_kwdArmorTypePower = GetFormByFileAndID_Internal<RE::BGSKeyword>(Cfg().KYWD_ARMORTYPEPOWER_ID);
         if (g_kwdArmorTypePower) {
             if (DEBUGGING)
-                REX::INFO("InitializeVariables_Internal: Power Armor Type keyword found with ID 0x{:08X}", KYWD_ARMORTYPEPOWER_ID);
+                REX::INFO("InitializeVariables_Internal: Power Armor Type keyword found with ID 0x{:08X}", Cfg().KYWD_ARMORTYPEPOWER_ID);
         } else {
             if (DEBUGGING)
-                REX::WARN("InitializeVariables_Internal: Power Armor Type keyword with ID 0x{:08X} not found", KYWD_ARMORTYPEPOWER_ID);
+                REX::WARN("InitializeVariables_Internal: Power Armor Type keyword with ID 0x{:08X} not found", Cfg().KYWD_ARMORTYPEPOWER_ID);
         }
     }
     if (!g_kwdIsPowerArmorFrame) {
-        g_kwdIsPowerArmorFrame = GetFormByFileAndID_Internal<RE::BGSKeyword>(KYWD_ISPOWERARMORFRAME_ID);
+        g_kwdIsPowerArmorFrame = GetFormByFileAndID_Internal<RE::BGSKeyword>(Cfg().KYWD_ISPOWERARMORFRAME_ID);
         if (g_kwdIsPowerArmorFrame) {
             if (DEBUGGING)
-                REX::INFO("InitializeVariables_Internal: Is Power Armor keyword found with ID 0x{:08X}", KYWD_ISPOWERARMORFRAME_ID);
+                REX::INFO("InitializeVariables_Internal: Is Power Armor keyword found with ID 0x{:08X}", Cfg().KYWD_ISPOWERARMORFRAME_ID);
         } else {
             if (DEBUGGING)
-                REX::WARN("InitializeVariables_Internal: Is Power Armor keyword with ID 0x{:08X} not found", KYWD_ISPOWERARMORFRAME_ID);
+                REX::WARN("InitializeVariables_Internal: Is Power Armor keyword with ID 0x{:08X} not found", Cfg().KYWD_ISPOWERARMORFRAME_ID);
         }
     }
     // Packages
     if (!g_packFollowersCompanion) {
-        g_packFollowersCompanion = GetFormByFileAndID_Internal<RE::TESPackage>(PACK_FOLLOWERSCOMPANION_ID);
+        g_packFollowersCompanion = GetFormByFileAndID_Internal<RE::TESPackage>(Cfg().PACK_FOLLOWERSCOMPANION_ID);
         if (g_packFollowersCompanion) {
             if (DEBUGGING)
-                REX::INFO("InitializeVariables_Internal: Follow Player package found with ID 0x{:08X}", PACK_FOLLOWERSCOMPANION_ID);
+                REX::INFO("InitializeVariables_Internal: Follow Player package found with ID 0x{:08X}", Cfg().PACK_FOLLOWERSCOMPANION_ID);
         } else {
             if (DEBUGGING)
-                REX::WARN("InitializeVariables_Internal: Follow Player package with ID 0x{:08X} not found", PACK_FOLLOWERSCOMPANION_ID);
+                REX::WARN("InitializeVariables_Internal: Follow Player package with ID 0x{:08X} not found", Cfg().PACK_FOLLOWERSCOMPANION_ID);
         }
     }
 }
@@ -1840,7 +1474,7 @@ bool IsActorActiveCompanion_Internal(RE::Actor* actor) {
     // Check for a specific faction, keyword, or other criteria that defines a companion
     if (!g_companionFaction) {
         if (DEBUGGING)
-            REX::WARN("IsActorActiveCompanion_Internal: Companion faction with ID 0x{:08X} not found", CURRENT_COMPANION_FACTION_ID);
+            REX::WARN("IsActorActiveCompanion_Internal: Companion faction with ID 0x{:08X} not found", Cfg().CURRENT_COMPANION_FACTION_ID);
         return false;
     }
     return actor->IsInFaction(g_companionFaction);
@@ -1866,26 +1500,13 @@ bool IsActorExcluded_Internal(RE::Actor* actor) {
     auto* npc = actor->GetNPC();
     if (!npc)
         return false;
-    // Check against exclusion list
-    auto npcRefFormID = actor->GetFormID();
-    auto npcBaseFormID = npc->GetFormID();
+    // Check any of the relevant form IDs against the exclusion set
+    auto compiled = g_compiledConfig.load(std::memory_order_acquire);
+    const auto& excluded = compiled->excludedActors;
+    if (excluded.Empty())
+        return false;
     auto otherFormID = actor->GetObjectReference() ? actor->GetObjectReference()->GetFormID() : 0;
-    for (std::uint32_t excludedID : EXCLUDE_ACTOR_ID_LIST) {
-        // Check any of the relevant form IDs
-        if (npc->formID == excludedID) {
-            return true;
-        }
-        if (npcRefFormID == excludedID) {
-            return true;
-        }
-        if (npcBaseFormID == excludedID) {
-            return true;
-        }
-        if (otherFormID == excludedID) {
-            return true;
-        }
-    }
-    return false;
+    return excluded.Contains(npc->formID) || excluded.Contains(actor->GetFormID()) || excluded.Contains(npc->GetFormID()) || excluded.Contains(otherFormID);
 }
 
 // Helper function to check if an item is already equipped
@@ -1980,177 +1601,181 @@ bool IsWeaponItem_Internal(RE::TESForm* itemForm) {
 
 // Loot items from all references in the current cell by active companions in the loot radius
 std::int32_t LootItems_Internal() {
-    std::vector<RE::Actor*> companions = ActorTracking::GetCompanionActors();
-    if (companions.empty()) return 0;
-    std::vector<RE::TESObjectREFR*> objectReferences = GetAllReferencesInCurrentCell_Internal();
+    auto snapshot = ActorTracking::GetSnapshot();
+    if (snapshot->companions.empty()) return 0;
+    LootCatalogue catalogue;
+    LootBuildCatalogue_Internal(catalogue);
+    LootPlanner::Input input;
+    LootPlanner::Plan plan;
+    std::vector<LootPlanner::ItemTransfer> items;
+    LootPlanner::Gather(*snapshot, catalogue, input);
+    LootPlanner::Build(input, LootPlanner::MakeParams(), plan);
     std::int32_t lootedRefCount = 0;
-    for (auto* object : objectReferences) {
-        if (!object)
-            continue;
-        // Check if the object has an owner and LOOT_STEAL is false
-        if (object->IsCrimeToActivate() && LOOT_STEAL == false)
-            continue;
-        // Get the total weight of the objects items
-        float objectWeight = object->GetWeightInContainer();
-        // iterate through companions to find the closest one
-        RE::Actor* closestCompanion = nullptr;
-        // Only consider companions within LOOT_RADIUS
-        float closestDistance = LOOT_RADIUS;
-        auto* avSingleton = RE::ActorValue::GetSingleton();
-        auto* carryweightAV = avSingleton->carryWeight;
-        for (auto* companion : companions) {
-            // Skip if none or in combat and LOOT_COMBAT is false
-            if (!companion)
-                continue;
-            if (companion->IsInCombat() && LOOT_COMBAT == false)
-                continue;
-            if (companion->IsDead(false))
-                continue;
-            float carrytWeight = companion->GetActorValue(*carryweightAV);
-            float currentWeight = companion->equippedWeight + companion->GetWeightInContainer();
-            if (LOOT_WEIGHT_LIMIT && (currentWeight + objectWeight) > carrytWeight) {
-                continue; // Cannot carry more weight
-            }
-            // Calculate distance
-            float distance = GetActorDistanceToObject_Internal(companion, object);
-            if (distance < closestDistance) {
-                closestDistance = distance;
-                closestCompanion = companion;
-            }
-        }
-        if (closestCompanion) {
-            if (LootItemsFromReference_Internal(object, closestCompanion)) {
-                lootedRefCount++;
-            }
-        }
+    for (const auto& transfer : plan.transfers) {
+        if (LootExecuteTransfer_Internal(input, transfer, catalogue, items))
+            lootedRefCount++;
     }
+    LootMarkVisited_Internal(input, plan);
     return lootedRefCount;
 }
 
-// Filter function to determine if an item should be looted
-bool LootItemFilter_Internal(RE::TESForm* aForm) {
-    if (!aForm)
-        return false;
-    // Check if looting is enabled
-    if (!LOOT_ENABLED)
-        return false;
-    // Get the form type
-    auto formType = aForm->GetFormType();
-    // Check against INI settings
-    switch (formType) {
-    case RE::ENUM_FORM_ID::kMISC: // Junk items
-        return LOOT_JUNK;
-    case RE::ENUM_FORM_ID::kAMMO: // Ammunition
-        return LOOT_AMMO;
-    case RE::ENUM_FORM_ID::kALCH: // Aid items (stimpaks, chems)
-        return LOOT_AID;
-    case RE::ENUM_FORM_ID::kWEAP: // Weapons
-        if (IsWeaponItem_Internal(aForm) == false)
-            return false; // Sanity check for CTD
-        if (auto* weapon = aForm->As<RE::TESObjectWEAP>()) {
-            if (weapon && weapon->weaponData.value) {
-                return weapon->weaponData.value >= LOOT_MIN_VALUE && weapon->weaponData.value <= LOOT_MAX_VALUE;
-            }
-        }
+// Build the loot catalogue from the references changed since the last loot pass
+void LootBuildCatalogue_Internal(LootCatalogue& catalogue) {
+    catalogue.Clear();
+    LootTracking::Refresh();
+    LootTracking::Collect(catalogue);
+    catalogue.Build();
+}
+
+// Execute one transfer of a loot plan (single reference slice)
+bool LootExecuteTransfer_Internal(const LootPlanner::Input& input, const LootPlanner::Transfer& transfer, const LootCatalogue& catalogue, std::vector<LootPlanner::ItemTransfer>& items) {
+    // References can be unloaded and companions can die between planning and execution
+    auto object = input.targets[transfer.target].handle.get();
+    auto* companion = input.looters[transfer.looter].actor;
+    if (!object || !companion || companion->IsDead(false))
         return false;
-    case RE::ENUM_FORM_ID::kARMO: // Armor
-        if (IsArmorItem_Internal(aForm) == false)
-            return false; // Sanity check for CTD
-        if (auto* armor = aForm->As<RE::TESObjectARMO>()) {
-            // Check value
-            if (armor && armor->armorData.value) {
-                return armor->armorData.value >= LOOT_MIN_VALUE && armor->armorData.value <= LOOT_MAX_VALUE;
-            }
-        }
+    bool looted = LootItemsFromReference_Internal(object.get(), companion, catalogue, items);
+    LootTracking::MarkVisited(input.targets[transfer.target].formID);
+    return looted;
+}
+
+// Mark the known unlootable references an eligible companion was close to as visited
+void LootMarkVisited_Internal(const LootPlanner::Input& input, const LootPlanner::Plan& plan) {
+    for (auto target : plan.ruledOut)
+        LootTracking::MarkVisited(input.targets[target].formID);
+}
+
+// Filter function to determine if an item should be looted, evaluated once per base form and config
+bool LootItemFilter_Internal(RE::TESForm* aForm, const CompiledConfig& compiled) {
+    if (!aForm)
         return false;
+    // Verdicts of one compiled config (main thread only)
+    static LootFilter::VerdictCache verdicts;
+    verdicts.Sync(compiled);
+    std::uint32_t formID = aForm->GetFormID();
+    if (const bool* loot = verdicts.Find(formID, aForm))
+        return *loot;
+    bool loot = LootItemEvaluate_Internal(aForm, compiled);
+    verdicts.Insert(formID, aForm, loot);
+    return loot;
+}
+
+// Loot decision for one base form: read its value and keywords for LootFilter::Evaluate
+bool LootItemEvaluate_Internal(RE::TESForm* aForm, const CompiledConfig& compiled) {
+    // Weapons and armor have a value, other forms are decided by their type
+    std::int32_t value = 0;
+    if (auto* weapon = aForm->As<RE::TESObjectWEAP>())
+        value = static_cast<std::int32_t>(weapon->weaponData.value);
+    else if (auto* armor = aForm->As<RE::TESObjectARMO>())
+        value = static_cast<std::int32_t>(armor->armorData.value);
+    auto* keywordForm = LootItemKeywords_Internal(aForm);
+    auto keyword = [keywordForm](std::uint32_t i) {
+        auto* keyword = keywordForm->keywords[i];
+        return keyword ? keyword->GetFormID() : 0u;
+    };
+    return LootFilter::Evaluate(static_cast<std::uint8_t>(aForm->GetFormType()), value, keywordForm ? keywordForm->numKeywords : 0u, keyword, compiled);
+}
+
+// Keywords of the lootable item types (nullptr for other forms)
+RE::BGSKeywordForm* LootItemKeywords_Internal(RE::TESForm* aForm) {
+    switch (aForm->GetFormType()) {
+    case RE::ENUM_FORM_ID::kWEAP:
+        return aForm->As<RE::TESObjectWEAP>();
+    case RE::ENUM_FORM_ID::kARMO:
+        return aForm->As<RE::TESObjectARMO>();
+    case RE::ENUM_FORM_ID::kMISC:
+        return aForm->As<RE::TESObjectMISC>();
+    case RE::ENUM_FORM_ID::kAMMO:
+        return aForm->As<RE::TESAmmo>();
+    case RE::ENUM_FORM_ID::kALCH:
+        return aForm->As<RE::AlchemyItem>();
     default:
-        return false; // Don't loot unknown types
+        return nullptr;
     }
 }
 
 // Helper to find and pick up dropped weapons near a corpse
-bool LootItemsWeaponLooseNearCorpse_Internal(RE::TESObjectREFR* looseItem, RE::Actor* companion) {
+bool LootItemsWeaponLooseNearCorpse_Internal(RE::TESObjectREFR* looseItem, RE::Actor* companion, const LootCatalogue& catalogue) {
     if (!looseItem || !companion)
         return false;
     // Must be a weapon
-    if (!IsWeaponItem_Internal(looseItem->GetObjectReference()))
+    if (!IsWeaponItem_Internal(looseItem->GetObjectReference())) {
+        LootTracking::MarkSkip(looseItem->GetFormID(), LOOT_SKIP::NOT_LOOTABLE);
         return false;
+    }
     // Apply loot filter for value check
     auto* baseForm = looseItem->GetObjectReference();
-    if (!LootItemFilter_Internal(baseForm))
+    if (!LootItemFilter_Internal(baseForm, *g_compiledConfig.load(std::memory_order_acquire)))
         return false;
-    auto* player = RE::PlayerCharacter::GetSingleton();
-    if (!player || !player->parentCell)
+    // Must be close to a corpse (dropped weapons are usually within 50-100 units)
+    if (!catalogue.HasCorpseNear(looseItem->GetPosition(), 100.0f)) // Adjust radius as needed
         return false;
-    auto* currentCell = player->parentCell;
-    // Skips alive actors
-    auto AllReferences = GetAllReferencesInCurrentCell_Internal();
-    // Get the position of the loose item
-    auto looseItemPos = looseItem->GetPosition();
-    bool pickedUpAny = false;
-    // Search cell references for weapons near this loose item
-    for (auto* ref : AllReferences) {
-        if (!ref) continue;
-        // Must be close to loose item (dropped weapons are usually within 50-100 units)
-        float distance = ref->GetPosition().GetDistance(looseItemPos);
-        if (distance > 100.0f) // Adjust radius as needed
-            continue;
-        // Pick it up
-        companion->PickUpObject(looseItem, 1, false);
-        pickedUpAny = true;
-        break;
-    }
-    return pickedUpAny;
+    // Pick it up
+    companion->PickUpObject(looseItem, 1, false);
+    return true;
 }
 
-// Loot the items from a reference to a companion based on item filter
-bool LootItemsFromReference_Internal(RE::TESObjectREFR* source, RE::Actor* companion) {
+// Loot the items from a reference to a companion based on item filter, items is the removal buffer of the loot pass
+bool LootItemsFromReference_Internal(RE::TESObjectREFR* source, RE::Actor* companion, const LootCatalogue& catalogue, std::vector<LootPlanner::ItemTransfer>& items) {
     if (!source || !companion)
         return false;
     // Check if source is owned by player
     auto* player = RE::PlayerCharacter::GetSingleton();
     if (!player)
         return false;
+    // Negative verdicts are remembered until the reference changes
+    std::uint32_t sourceFormID = source->GetFormID();
     auto* owner = source->GetOwner();
-    if (owner && owner->GetFormID() == player->GetFormID())
+    if (owner && owner->GetFormID() == player->GetFormID()) {
+        LootTracking::MarkSkip(sourceFormID, LOOT_SKIP::PLAYER_OWNED);
         return false; // Do not loot items owned by player
+    }
     // Access the inventory list
     auto* invList = source->inventoryList;
     // Check if this is a power armor frame
     if (IsArmorPowerFrame_Internal(source)) {
+        LootTracking::MarkSkip(sourceFormID, LOOT_SKIP::POWER_ARMOR);
         return false; // Do not loot power armor frames
     }
     // It's a loose item, we need to handle it first in case it is a dropped weapon
     if (!invList) {
-        return LootItemsWeaponLooseNearCorpse_Internal(source, companion);
+        return LootItemsWeaponLooseNearCorpse_Internal(source, companion, catalogue);
     }
     // It is a container, check if it has items
-    if (invList->data.empty())
+    if (invList->data.empty()) {
+        LootTracking::MarkSkip(sourceFormID, LOOT_SKIP::EMPTY);
         return false; // No items to loot
+    }
     // Check Lock status
     RE::REFR_LOCK* lock = source->GetLock();
-    if (lock && lock->GetLockLevel(source) != RE::LOCK_LEVEL::kUnlocked)
+    if (lock && lock->GetLockLevel(source) != RE::LOCK_LEVEL::kUnlocked) {
+        LootTracking::MarkSkip(sourceFormID, LOOT_SKIP::LOCKED);
         return false; // Cannot loot locked containers
+    }
     // Cast RE::Actor to RE::TESObjectREFR for destination
     auto* companionRef = companion->As<RE::TESObjectREFR>();
     if (!companionRef)
         return false; // should always succeed
-    // Get all the items to transfer
-    auto totalItemCount = 0;
-    std::vector<RE::BGSInventoryItem> toTransfer;
-    for (auto & itemEntry : invList->data) {
+    // Get all the items to transfer, RemoveItem changes the inventory so only object and count are kept
+    // No stack index: without stackData RemoveItem takes the count from the object's stacks itself
+    items.clear();
+    auto compiled = g_compiledConfig.load(std::memory_order_acquire);
+    for (const auto& itemEntry : invList->data) {
         if (!itemEntry.object)
             continue;
-        if (LootItemFilter_Internal(itemEntry.object)) {
-            toTransfer.push_back(itemEntry);
-        }
+        std::int32_t itemCount = static_cast<std::int32_t>(itemEntry.GetCount());
+        if (itemCount > 0 && LootItemFilter_Internal(itemEntry.object, *compiled))
+            items.push_back({itemEntry.object, itemCount});
+    }
+    if (items.empty()) {
+        LootTracking::MarkSkip(sourceFormID, LOOT_SKIP::NOTHING_TO_LOOT);
+        return false;
     }
-    for (auto& itemEntry : toTransfer) {
-        if (!itemEntry.object || itemEntry.GetCount() <= 0) continue;
-        int itemCount = itemEntry.GetCount();
-        totalItemCount += itemCount;
+    std::int32_t totalItemCount = 0;
+    for (const auto& item : items) {
+        totalItemCount += item.count;
         // Transfer the item
-        auto removeData = LootBuildRemoveItemData_Internal(&itemEntry, companionRef, itemCount);
+        auto removeData = LootBuildRemoveItemData_Internal(item.object, companionRef, item.count);
         source->RemoveItem(removeData);
     }
     // Some items were looted
@@ -2162,7 +1787,7 @@ bool LootItemsFromReference_Internal(RE::TESObjectREFR* source, RE::Actor* compa
 
 // Helper to construct the RemoveItemData for the RemoveItem(RemoveItemData zData) function
 // std::int32_t
-RE::TESObjectREFR::RemoveItemData LootBuildRemoveItemData_Internal(RE::BGSInventoryItem *aInventoryItem, RE::TESObjectREFR *aContainer, std::int32_t aCount) {
+RE::TESObjectREFR::RemoveItemData LootBuildRemoveItemData_Internal(RE::TESBoundObject *aObject, RE::TESObjectREFR *aContainer, std::int32_t aCount) {
     // --- RemoveItemData ---
     // Main constructor that takes a TESBoundObject and the item count:
     //    RemoveItemData(TESBoundObject* a_object, std::int32_t a_count)
@@ -2183,7 +1808,7 @@ RE::TESObjectREFR::RemoveItemData LootBuildRemoveItemData_Internal(RE::BGSInvent
     // const NiPoint3* dropLoc{ nullptr };
     // const NiPoint3* rotate{ nullptr };
     // The constructor for RemoveItemData takes the base object and count.
-    RE::TESObjectREFR::RemoveItemData newData(aInventoryItem->object, aCount);
+    RE::TESObjectREFR::RemoveItemData newData(aObject, aCount);
     // Set the destination container and the reason for the transfer.
     newData.a_otherContainer = aContainer;
     // Needs to be RE::ITEM_REMOVE_REASON::kStoreTeammate to work properly
@@ -2207,11 +1832,11 @@ void SetCompanionChatter_Internal(RE::Actor* comp) {
     float targetMax = 0.0f;
     // Adjust based on sneaking status
     if (comp->IsSneaking()) {
-        targetMin = idleChatterBaseMin * CHATTER_MULTIPLIER_SNEAK;
-        targetMax = idleChatterBaseMax * CHATTER_MULTIPLIER_SNEAK;
+        targetMin = idleChatterBaseMin * Cfg().CHATTER_MULTIPLIER_SNEAK;
+        targetMax = idleChatterBaseMax * Cfg().CHATTER_MULTIPLIER_SNEAK;
     } else {
-        targetMin = idleChatterBaseMin * CHATTER_MULTIPLIER;
-        targetMax = idleChatterBaseMax * CHATTER_MULTIPLIER;
+        targetMin = idleChatterBaseMin * Cfg().CHATTER_MULTIPLIER;
+        targetMax = idleChatterBaseMax * Cfg().CHATTER_MULTIPLIER;
     }
     // Apply changes if different from current
     if (std::abs(idleChatterMin - targetMin) > 0.1f) {
@@ -2247,39 +1872,39 @@ void SetCompanionCombatAI_Internal(RE::Actor* comp, RE::TESCombatStyle* combatSt
     // Cover
     if (DEBUGGING) REX::INFO(" - Current Cover Search Distance Multiplier: {}", combatStyle->coverData.coverSearchDistanceMult); */
     // Apply new settings from INI
-    if (combatStyle->generalData.offensiveMult != COMBAT_OFFENSIVE && COMBAT_OFFENSIVE != 1.0f)
-        combatStyle->generalData.offensiveMult = COMBAT_OFFENSIVE;
-    if (combatStyle->generalData.defensiveMult != COMBAT_DEFENSIVE && COMBAT_DEFENSIVE != 1.0f)
-        combatStyle->generalData.defensiveMult = COMBAT_DEFENSIVE;
-    if (combatStyle->generalData.rangedScoreMult != COMBAT_RANGED && COMBAT_RANGED != 1.0f)
-        combatStyle->generalData.rangedScoreMult = COMBAT_RANGED;
-    if (combatStyle->generalData.meleeScoreMult != COMBAT_MELEE && COMBAT_MELEE != 1.0f)
-        combatStyle->generalData.meleeScoreMult = COMBAT_MELEE;
+    if (combatStyle->generalData.offensiveMult != Cfg().COMBAT_OFFENSIVE && Cfg().COMBAT_OFFENSIVE != 1.0f)
+        combatStyle->generalData.offensiveMult = Cfg().COMBAT_OFFENSIVE;
+    if (combatStyle->generalData.defensiveMult != Cfg().COMBAT_DEFENSIVE && Cfg().COMBAT_DEFENSIVE != 1.0f)
+        combatStyle->generalData.defensiveMult = Cfg().COMBAT_DEFENSIVE;
+    if (combatStyle->generalData.rangedScoreMult != Cfg().COMBAT_RANGED && Cfg().COMBAT_RANGED != 1.0f)
+        combatStyle->generalData.rangedScoreMult = Cfg().COMBAT_RANGED;
+    if (combatStyle->generalData.meleeScoreMult != Cfg().COMBAT_MELEE && Cfg().COMBAT_MELEE != 1.0f)
+        combatStyle->generalData.meleeScoreMult = Cfg().COMBAT_MELEE;
     // Ranged
-    if (combatStyle->longRangeData.adjustRangeMult != COMBAT_RANGED_ADJUSTMENT && COMBAT_RANGED_ADJUSTMENT != 1.0f)
-        combatStyle->longRangeData.adjustRangeMult = COMBAT_RANGED_ADJUSTMENT;
-    if (combatStyle->longRangeData.crouchMult != COMBAT_RANGED_CROUCHING && COMBAT_RANGED_CROUCHING != 1.0f)
-        combatStyle->longRangeData.crouchMult = COMBAT_RANGED_CROUCHING;
-    if (combatStyle->longRangeData.strafeMult != COMBAT_RANGED_STRAFE && COMBAT_RANGED_STRAFE != 1.0f)
-        combatStyle->longRangeData.strafeMult = COMBAT_RANGED_STRAFE;
-    if (combatStyle->longRangeData.waitMult != COMBAT_RANGED_WAITING && COMBAT_RANGED_WAITING != 1.0f)
-        combatStyle->longRangeData.waitMult = COMBAT_RANGED_WAITING;
-    if (combatStyle->rangedData.accuracyMult != COMBAT_RANGED_ACCURACY && COMBAT_RANGED_ACCURACY != 1.0f)
-        combatStyle->rangedData.accuracyMult = COMBAT_RANGED_ACCURACY;
+    if (combatStyle->longRangeData.adjustRangeMult != Cfg().COMBAT_RANGED_ADJUSTMENT && Cfg().COMBAT_RANGED_ADJUSTMENT != 1.0f)
+        combatStyle->longRangeData.adjustRangeMult = Cfg().COMBAT_RANGED_ADJUSTMENT;
+    if (combatStyle->longRangeData.crouchMult != Cfg().COMBAT_RANGED_CROUCHING && Cfg().COMBAT_RANGED_CROUCHING != 1.0f)
+        combatStyle->longRangeData.crouchMult = Cfg().COMBAT_RANGED_CROUCHING;
+    if (combatStyle->longRangeData.strafeMult != Cfg().COMBAT_RANGED_STRAFE && Cfg().COMBAT_RANGED_STRAFE != 1.0f)
+        combatStyle->longRangeData.strafeMult = Cfg().COMBAT_RANGED_STRAFE;
+    if (combatStyle->longRangeData.waitMult != Cfg().COMBAT_RANGED_WAITING && Cfg().COMBAT_RANGED_WAITING != 1.0f)
+        combatStyle->longRangeData.waitMult = Cfg().COMBAT_RANGED_WAITING;
+    if (combatStyle->rangedData.accuracyMult != Cfg().COMBAT_RANGED_ACCURACY && Cfg().COMBAT_RANGED_ACCURACY != 1.0f)
+        combatStyle->rangedData.accuracyMult = Cfg().COMBAT_RANGED_ACCURACY;
     // Close-Quarters
-    if (combatStyle->closeRangeData.fallbackMult != COMBAT_CLOSE_FALLBACK && COMBAT_CLOSE_FALLBACK != 1.0f)
-        combatStyle->closeRangeData.fallbackMult = COMBAT_CLOSE_FALLBACK;
-    if (combatStyle->closeRangeData.circleMult != COMBAT_CLOSE_CIRCLE && COMBAT_CLOSE_CIRCLE != 1.0f)
-        combatStyle->closeRangeData.circleMult = COMBAT_CLOSE_CIRCLE;
-    if (combatStyle->closeRangeData.disengageProbability != COMBAT_CLOSE_DISENGAGE && COMBAT_CLOSE_DISENGAGE != 1.0f)
-        combatStyle->closeRangeData.disengageProbability = COMBAT_CLOSE_DISENGAGE;
-    if (combatStyle->closeRangeData.flankVarianceMult != COMBAT_CLOSE_FLANK && COMBAT_CLOSE_FLANK != 1.0f)
-        combatStyle->closeRangeData.flankVarianceMult = COMBAT_CLOSE_FLANK;
-    if (combatStyle->closeRangeData.throwMaxTargets != COMBAT_CLOSE_THROW_GRENADE && COMBAT_CLOSE_THROW_GRENADE != 1.0f)
-        combatStyle->closeRangeData.throwMaxTargets = COMBAT_CLOSE_THROW_GRENADE;
+    if (combatStyle->closeRangeData.fallbackMult != Cfg().COMBAT_CLOSE_FALLBACK && Cfg().COMBAT_CLOSE_FALLBACK != 1.0f)
+        combatStyle->closeRangeData.fallbackMult = Cfg().COMBAT_CLOSE_FALLBACK;
+    if (combatStyle->closeRangeData.circleMult != Cfg().COMBAT_CLOSE_CIRCLE && Cfg().COMBAT_CLOSE_CIRCLE != 1.0f)
+        combatStyle->closeRangeData.circleMult = Cfg().COMBAT_CLOSE_CIRCLE;
+    if (combatStyle->closeRangeData.disengageProbability != Cfg().COMBAT_CLOSE_DISENGAGE && Cfg().COMBAT_CLOSE_DISENGAGE != 1.0f)
+        combatStyle->closeRangeData.disengageProbability = Cfg().COMBAT_CLOSE_DISENGAGE;
+    if (combatStyle->closeRangeData.flankVarianceMult != Cfg().COMBAT_CLOSE_FLANK && Cfg().COMBAT_CLOSE_FLANK != 1.0f)
+        combatStyle->closeRangeData.flankVarianceMult = Cfg().COMBAT_CLOSE_FLANK;
+    if (combatStyle->closeRangeData.throwMaxTargets != Cfg().COMBAT_CLOSE_THROW_GRENADE && Cfg().COMBAT_CLOSE_THROW_GRENADE != 1.0f)
+        combatStyle->closeRangeData.throwMaxTargets = Cfg().COMBAT_CLOSE_THROW_GRENADE;
     // Cover
-    if (combatStyle->coverData.coverSearchDistanceMult != COMBAT_COVER_DISTANCE && COMBAT_COVER_DISTANCE != 1.0f)
-        combatStyle->coverData.coverSearchDistanceMult = COMBAT_COVER_DISTANCE;
+    if (combatStyle->coverData.coverSearchDistanceMult != Cfg().COMBAT_COVER_DISTANCE && Cfg().COMBAT_COVER_DISTANCE != 1.0f)
+        combatStyle->coverData.coverSearchDistanceMult = Cfg().COMBAT_COVER_DISTANCE;
     /* if (DEBUGGING) REX::INFO("SetCompanionCombatAI_Internal: Combat style for companion {} updated.", comp->GetDisplayFullName());
     if (DEBUGGING) REX::INFO(" - New Offensive Multiplier: {}", combatStyle->generalData.offensiveMult);
     if (DEBUGGING) REX::INFO(" - New Defensive Multiplier: {}", combatStyle->generalData.defensiveMult);
@@ -2301,248 +1926,931 @@ void SetCompanionCombatAI_Internal(RE::Actor* comp, RE::TESCombatStyle* combatSt
     if (DEBUGGING) REX::INFO(" - New Cover Search Distance Multiplier: {}", combatStyle->coverData.coverSearchDistanceMult); */
 }
 
-// Populate global arrays with current cell actors
-std::int32_t UpdateGlobalActorArrays_Internal() {
-    // Timestamp
-    auto now = std::chrono::steady_clock::now();
-    // Get all actors in cell
-    auto actors = GetAllActors_Internal();
-    // Collect enemies to calculate max health
-    std::vector<RE::Actor*> tempEnemies;
-    for (auto* actor : actors) {
-        if (actor && !actor->IsDead(true) && IsActorEnemy_Internal(actor)) {
-            tempEnemies.push_back(actor);
-        }
+// Populate global arrays from the gathered actor data
+std::int32_t UpdateGlobalActorArrays_Internal(const ActorPipeline::GatherBuffer& buffer) {
+    // Previous epoch for frame to frame comparison
+    auto prevSnapshot = ActorTracking::GetSnapshot();
+    // Classify the actors and calculate threat levels
+    auto result = ActorPipeline::Analyze(buffer, *prevSnapshot, ActorPipeline::MakeAnalyzeParams());
+    if (result.enemyMaxHealth > 0.0f) {
+        g_enemyMaxHealthInCell = result.enemyMaxHealth;
     }
-    // Calculate max enemy health for relative comparison
-    float maxHealth = 0.0f;
-    for (auto* enemy : tempEnemies) {
-        if (!enemy)
-            continue;
-        float health = enemy->GetPermanentActorValue(*RE::ActorValue::GetSingleton()->health);
-        if (health > maxHealth) {
-            maxHealth = health;
+    // Synchronize companion flags with the new companion data
+    ActorTracking::SyncCompanionFlagsWithSnapshot(result.companions);
+    // Publish the new epoch, the current one becomes the previous epoch
+    ActorTracking::PublishSnapshot(std::move(result.companions), std::move(result.enemies), std::move(result.neutralNPCs));
+    return static_cast<std::int32_t>(buffer.records.size());
+}
+
+// --- HOOKS ---
+
+// Submit a job for a subsystem
+bool CCB_MainThreadQueue::Submit(MAIN_JOB subsystem, std::uint64_t epoch, Job callback) {
+    if (!callback || subsystem >= MAIN_JOB::COUNT)
+        return false;
+    bool scheduleDrain = false;
+    bool added = true;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto& slot = slots[static_cast<std::size_t>(subsystem)];
+        stats.submitted++;
+        if (slot.pending) {
+            // Merge into the pending job, the newer epoch wins and the original queue time is kept
+            stats.coalesced++;
+            added = false;
+        } else {
+            slot.pending = true;
+            slot.queued = Clock::now();
+        }
+        slot.started = false;
+        slot.epoch = epoch;
+        slot.config = GetConfig();
+        slot.callback = std::make_shared<Job>(std::move(callback));
+        if (!drainScheduled) {
+            drainScheduled = true;
+            scheduleDrain = true;
         }
     }
-    if (maxHealth > 0.0f) {
-        g_enemyMaxHealthInCell = maxHealth;
+    if (scheduleDrain)
+        ScheduleDrain();
+    return added;
+}
+
+// Check if a subsystem has a job waiting to run or in progress
+bool CCB_MainThreadQueue::IsPending(MAIN_JOB subsystem) {
+    if (subsystem >= MAIN_JOB::COUNT)
+        return false;
+    std::lock_guard<std::mutex> lock(mutex);
+    return slots[static_cast<std::size_t>(subsystem)].pending;
+}
+
+// Drop all pending jobs
+void CCB_MainThreadQueue::Clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto& slot : slots) {
+        slot.pending = false;
+        slot.started = false;
+        slot.callback.reset();
+        slot.config.reset();
     }
-    // Create tracked data for each actor
-    auto dataCompanionActors = std::vector<TrackedActorData>();
-    auto dataEnemyActors = std::vector<TrackedActorData>();
-    auto dataNeutralActors = std::vector<TrackedActorData>();
-    // Categorize and store
-    for (auto* actor : actors) {
-        if (!actor || actor->IsDead(true))
-            continue;
-        // Skip player
-        if (actor->IsPlayerRef())
-            continue;
-        // Skip excluded actors
-        if (IsActorExcluded_Internal(actor))
+}
+
+// Get a copy of the queue statistics
+CCB_MainThreadQueue::QueueStats CCB_MainThreadQueue::GetStats() {
+    std::lock_guard<std::mutex> lock(mutex);
+    QueueStats result = stats;
+    auto now = Clock::now();
+    for (auto& slot : slots) {
+        if (!slot.pending)
             continue;
-        // Companion
-        if (IsActorActiveCompanion_Internal(actor)) {
-            auto dataCompanionActor = CreateTrackedData_Internal(actor, ENEMY_TIER::LOW); // Companions are not enemies, tier is irrelevant
-            // Compare with previous state for changes
-            auto prevOpt = ActorTracking::GetPreviousCompanionData(actor);
-            if (prevOpt) {
-                // Preserve aiUpdated from previous state if it exists
-                dataCompanionActor.aiUpdated = prevOpt->aiUpdated;
-                dataCompanionActor.buffed = prevOpt->buffed;
-                // Stimpak usage and health/distance changes
-                bool wasUsingStimpak = prevOpt->usesStimpak;
-                // Check if the companion is using a stimpak
-                if (actor->inventoryList && actor->race && !actor->IsDead(false) && !g_raceStimpak.empty() && g_raceSynth3C) {
-                    bool isStimpakRace = false;
-                    for (auto* humanRace : g_raceStimpak) {
-                        if (actor->race->GetFormID() == humanRace->GetFormID()) {
-                            isStimpakRace = true;
-                            break;
-                        }
-                    }
-                    if (isStimpakRace) {
-                        dataCompanionActor.usesStimpak = true;
-                        for (const auto& item : actor->inventoryList->data) {
-                            if (item.object && item.object->GetFormID() == g_raceSynth3C->GetFormID()) {
-                                dataCompanionActor.usesStimpak = false;
-                                break;
-                            }
-                        }
-                    } else {
-                        dataCompanionActor.usesStimpak = false;
-                    }
-                } else {
-                    dataCompanionActor.usesStimpak = wasUsingStimpak;
-                }
-                // Check if the companion took damage
-                float healthDelta = dataCompanionActor.healthPercent - prevOpt->healthPercent;
-                // Update position
-                dataCompanionActor.position = actor->GetPosition();
-                // Update velocity
-                float velocity = actor->GetPosition().GetDistance(prevOpt->position) / UPDATE_INTERVAL;
-                dataCompanionActor.velocity = velocity;
-                // Update stuck counter
-                int stuckCounter = ActorTracking::GetActorStuckCounterFast(actor);
-                dataCompanionActor.stuckCounter = stuckCounter;
-                // Update lost status
-                dataCompanionActor.lost = ActorTracking::GetActorLostStatusFast(actor);
-            }
-            dataCompanionActors.push_back(dataCompanionActor);
-        } else if (IsActorEnemy_Internal(actor)) {
-            // Enemy - analyze threat with CORRECT max health
-            auto analysis = EnemyActorAnalyze_Internal(actor);
-            auto dataEnemyActor = CreateTrackedData_Internal(actor, analysis.tier);
-            dataEnemyActor.isRanged = analysis.isRanged;
-            dataEnemyActor.isMelee = analysis.isMelee;
-            dataEnemyActor.hasGrenades = analysis.hasGrenades;
-            dataEnemyActors.push_back(dataEnemyActor);
-        } else {
-            // Neutral NPC
-            auto dataNeutralActor = CreateTrackedData_Internal(actor, ENEMY_TIER::LOW);
-            dataNeutralActors.push_back(dataNeutralActor);
-        }
-    }
-    // Cache current state
-    ActorTracking::CacheCurrentState();
-    // Clear old data
-    ActorTracking::g_enemies.clear();
-    ActorTracking::g_companions.clear();
-    ActorTracking::g_neutralNPCs.clear();
-    // Push new data
-    ActorTracking::ReplaceCompanionData(dataCompanionActors);
-    ActorTracking::ReplaceEnemyData(dataEnemyActors);
-    ActorTracking::ReplaceNeutralNPCData(dataNeutralActors);
-    // Synchronize companion flags with current snapshot
-    ActorTracking::SyncCompanionFlagsWithSnapshot(dataCompanionActors);
-    return actors.size();
+        result.depth++;
+        result.oldestAge = (std::max)(result.oldestAge, now - slot.queued);
+    }
+    return result;
 }
 
-// --- HOOKS ---
+// Queue a drain task for the next frame
+void CCB_MainThreadQueue::ScheduleDrain() {
+    if (g_taskInterface) {
+        g_taskInterface->AddTask([this]() { Drain(); });
+    } else {
+        std::lock_guard<std::mutex> lock(mutex);
+        drainScheduled = false;
+    }
+}
+
+// Run slices by priority until the frame budget is used up
+void CCB_MainThreadQueue::Drain() {
+    auto frameStart = Clock::now();
+    auto budget = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<float, std::milli>(Cfg().FRAME_BUDGET_MS));
+    bool ranSlice = false;
+    bool workLeft = false;
+    std::unique_lock<std::mutex> lock(mutex);
+    // Jobs submitted from now on need a new drain task
+    drainScheduled = false;
+    while (true) {
+        // Highest priority pending job
+        auto it = std::find_if(slots.begin(), slots.end(), [](const Slot& slot) { return slot.pending; });
+        if (it == slots.end())
+            break;
+        // Always make progress, then stop once the budget is used up
+        if (ranSlice && Clock::now() - frameStart >= budget) {
+            workLeft = true;
+            break;
+        }
+        auto& slot = *it;
+        auto subsystem = static_cast<std::size_t>(it - slots.begin());
+        if (!slot.started) {
+            slot.started = true;
+            auto wait = Clock::now() - slot.queued;
+            stats.maxWait = (std::max)(stats.maxWait, wait);
+            stats.totalWait += wait;
+            stats.executed++;
+        }
+        auto callback = slot.callback;
+        auto config = slot.config;
+        lock.unlock();
+        auto sliceStart = Clock::now();
+        bool finished = false;
+        {
+            // Slices run with the config of the tick that submitted the job
+            ConfigScope configScope(config);
+            finished = (*callback)();
+        }
+        auto sliceTime = Clock::now() - sliceStart;
+        lock.lock();
+        ranSlice = true;
+        auto& sliceStats = stats.slices[subsystem];
+        sliceStats.slices++;
+        sliceStats.maxTime = (std::max)(sliceStats.maxTime, sliceTime);
+        sliceStats.totalTime += sliceTime;
+        // A submit during the slice replaced the job, keep the new one pending
+        if (finished && slot.callback == callback) {
+            slot.pending = false;
+            slot.started = false;
+            slot.callback.reset();
+            slot.config.reset();
+        }
+    }
+    if (ranSlice)
+        stats.frames++;
+    bool scheduleDrain = false;
+    if (workLeft) {
+        stats.overBudget++;
+        // Continue next frame
+        if (!drainScheduled) {
+            drainScheduled = true;
+            scheduleDrain = true;
+        }
+    }
+    lock.unlock();
+    if (scheduleDrain)
+        ScheduleDrain();
+}
+
+// Build a job that handles one companion of the snapshot per slice
+CCB_MainThreadQueue::Job MakeCompanionSliceJob(ActorTracking::SnapshotPtr snapshot, std::function<void(const TrackedActorData&)> perCompanion) {
+    return [snapshot = std::move(snapshot), perCompanion = std::move(perCompanion), index = std::size_t{0}]() mutable {
+        if (index < snapshot->companions.size())
+            perCompanion(snapshot->companions[index++]);
+        return index >= snapshot->companions.size();
+    };
+}
 
-void ActorTracking::EnsureCompanionFlagEntry(RE::Actor* actor) {
-    if (!actor) return;
+void ActorTracking::CompanionFlags::StorePosition(const RE::NiPoint3& pos) {
+    // Claim the write by moving the sequence to odd (waits for a concurrent writer)
+    std::uint32_t seq = posSeq.load(std::memory_order_relaxed);
+    do {
+        while (seq & 1)
+            seq = posSeq.load(std::memory_order_relaxed);
+    } while (!posSeq.compare_exchange_weak(seq, seq + 1, std::memory_order_acquire, std::memory_order_relaxed));
+    std::atomic_thread_fence(std::memory_order_release);
+    lastPosX.store(pos.x, std::memory_order_relaxed);
+    lastPosY.store(pos.y, std::memory_order_relaxed);
+    lastPosZ.store(pos.z, std::memory_order_relaxed);
+    posSeq.store(seq + 2, std::memory_order_release);
+}
+
+RE::NiPoint3 ActorTracking::CompanionFlags::LoadPosition() const {
+    RE::NiPoint3 pos;
+    std::uint32_t before, after;
+    do {
+        before = posSeq.load(std::memory_order_acquire);
+        pos.x = lastPosX.load(std::memory_order_relaxed);
+        pos.y = lastPosY.load(std::memory_order_relaxed);
+        pos.z = lastPosZ.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        after = posSeq.load(std::memory_order_relaxed);
+    } while ((before & 1) || before != after);
+    return pos;
+}
+
+void ActorTracking::CompanionFlags::Reset() {
+    stuck.store(false, std::memory_order_relaxed);
+    stuckCounter.store(0, std::memory_order_relaxed);
+    velocity.store(0.0f, std::memory_order_relaxed);
+    lost.store(false, std::memory_order_relaxed);
+    buffSignature.store(0, std::memory_order_relaxed);
+    StorePosition(RE::NiPoint3{0.0f, 0.0f, 0.0f});
+}
+
+std::uint32_t ActorTracking::FindCompanionSlot(RE::Actor* actor) {
+    if (!actor) return INVALID_SLOT;
+    for (std::uint32_t slot = 0; slot < MAX_COMPANION_SLOTS; ++slot) {
+        if (g_companionFlags[slot].owner.load(std::memory_order_acquire) == actor)
+            return slot;
+    }
+    return INVALID_SLOT;
+}
+
+std::uint32_t ActorTracking::AcquireCompanionSlotLocked(RE::Actor* actor) {
+    std::uint32_t freeSlot = INVALID_SLOT;
+    for (std::uint32_t slot = 0; slot < MAX_COMPANION_SLOTS; ++slot) {
+        auto* owner = g_companionFlags[slot].owner.load(std::memory_order_relaxed);
+        if (owner == actor)
+            return slot;
+        if (!owner && freeSlot == INVALID_SLOT)
+            freeSlot = slot;
+    }
+    if (freeSlot == INVALID_SLOT) {
+        if (DEBUGGING)
+            REX::WARN("AcquireCompanionSlot: All {} companion flag slots are in use", MAX_COMPANION_SLOTS);
+        return INVALID_SLOT;
+    }
+    // Reset before publishing the owner so readers never see the previous companion's values
+    g_companionFlags[freeSlot].Reset();
+    g_companionFlags[freeSlot].owner.store(actor, std::memory_order_release);
+    return freeSlot;
+}
+
+std::uint32_t ActorTracking::AcquireCompanionSlot(RE::Actor* actor) {
+    if (!actor) return INVALID_SLOT;
+    std::uint32_t slot = FindCompanionSlot(actor);
+    if (slot != INVALID_SLOT) return slot;
     std::lock_guard<std::mutex> lk(g_companionFlagsMutex);
-    g_companionFlags.try_emplace(actor);
+    return AcquireCompanionSlotLocked(actor);
+}
+
+ActorTracking::CompanionFlags* ActorTracking::GetCompanionFlags(std::uint32_t slot, RE::Actor* actor) {
+    if (!actor || slot >= MAX_COMPANION_SLOTS) return nullptr;
+    auto& flags = g_companionFlags[slot];
+    return flags.owner.load(std::memory_order_acquire) == actor ? &flags : nullptr;
+}
+
+void ActorTracking::EnsureCompanionFlagEntry(RE::Actor* actor) {
+    AcquireCompanionSlot(actor);
 }
 
 void ActorTracking::SyncCompanionFlagsWithSnapshot(const std::vector<TrackedActorData>& snapshot) {
     std::lock_guard<std::mutex> lk(g_companionFlagsMutex);
-    // Build set of current actors from snapshot
-    std::unordered_set<RE::Actor*> present;
-    present.reserve(snapshot.size());
-    for (const auto &d : snapshot) if (d.actor) present.insert(d.actor);
-    // Remove stale entries
-    for (auto it = g_companionFlags.begin(); it != g_companionFlags.end();) {
-        if (present.find(it->first) == present.end()) it = g_companionFlags.erase(it);
-        else ++it;
-    }
-    // Add missing entries
-    for (auto *a : present) {
-        if (g_companionFlags.find(a) == g_companionFlags.end())
-            g_companionFlags.try_emplace(a);
-    }
+    // Release slots of actors that are no longer tracked
+    for (auto& flags : g_companionFlags) {
+        auto* owner = flags.owner.load(std::memory_order_relaxed);
+        if (!owner) continue;
+        bool present = std::any_of(snapshot.begin(), snapshot.end(), [owner](const TrackedActorData& d) { return d.actor == owner; });
+        if (!present) flags.owner.store(nullptr, std::memory_order_release);
+    }
+    // Assign slots to new actors and update their values
     for (const auto &d : snapshot) {
-        auto it = g_companionFlags.find(d.actor);
-        if (it == g_companionFlags.end()) continue;
+        if (!d.actor) continue;
+        std::uint32_t slot = AcquireCompanionSlotLocked(d.actor);
+        if (slot == INVALID_SLOT) continue;
+        auto& flags = g_companionFlags[slot];
         // Update last position
-        it->second.lastPosX.store(d.position.x, std::memory_order_release);
-        it->second.lastPosY.store(d.position.y, std::memory_order_release);
-        it->second.lastPosZ.store(d.position.z, std::memory_order_release);
+        flags.StorePosition(d.position);
         // Update velocity
-        it->second.velocity.store(d.velocity, std::memory_order_release);
+        flags.velocity.store(d.velocity, std::memory_order_release);
         // Update stuck counter
-        it->second.stuckCounter.store(d.stuckCounter, std::memory_order_release);
+        flags.stuckCounter.store(d.stuckCounter, std::memory_order_release);
         // Update lost status
-        it->second.lost.store(d.lost, std::memory_order_release);
-    }
-    for (auto *a : present) {
-        g_companionFlags.try_emplace(a);
+        flags.lost.store(d.lost, std::memory_order_release);
     }
 }
 
-// Fast getters/setters (use atomic fields; small mutex only for map lookup/creation)
+// Fast getters/setters by actor (lock free scan of the slot owners)
 bool ActorTracking::GetActorStuckStatusFast(RE::Actor* actor) {
-    if (!actor) return false;
-    std::lock_guard<std::mutex> lk(g_companionFlagsMutex);
-    auto it = g_companionFlags.find(actor);
-    return (it != g_companionFlags.end()) ? it->second.stuck.load(std::memory_order_acquire) : false;
+    auto* flags = GetCompanionFlags(FindCompanionSlot(actor), actor);
+    return flags ? flags->stuck.load(std::memory_order_acquire) : false;
 }
 void ActorTracking::SetActorStuckStatusFast(RE::Actor* actor, bool stuck) {
-    if (!actor) return;
-    std::lock_guard<std::mutex> lk(g_companionFlagsMutex);
-    auto it = g_companionFlags.find(actor);
-    if (it == g_companionFlags.end()) it = g_companionFlags.try_emplace(actor).first;
-    it->second.stuck.store(stuck, std::memory_order_release);
+    if (auto* flags = GetCompanionFlags(AcquireCompanionSlot(actor), actor))
+        flags->stuck.store(stuck, std::memory_order_release);
 }
 
 int ActorTracking::GetActorStuckCounterFast(RE::Actor* actor) {
-    if (!actor) return 0;
-    std::lock_guard<std::mutex> lk(g_companionFlagsMutex);
-    auto it = g_companionFlags.find(actor);
-    return (it != g_companionFlags.end()) ? it->second.stuckCounter.load(std::memory_order_acquire) : 0;
+    auto* flags = GetCompanionFlags(FindCompanionSlot(actor), actor);
+    return flags ? flags->stuckCounter.load(std::memory_order_acquire) : 0;
 }
 void ActorTracking::IncrementActorStuckCounterFast(RE::Actor* actor) {
-    if (!actor) return;
-    std::lock_guard<std::mutex> lk(g_companionFlagsMutex);
-    auto it = g_companionFlags.find(actor);
-    if (it == g_companionFlags.end()) it = g_companionFlags.try_emplace(actor).first;
-    it->second.stuckCounter.fetch_add(1, std::memory_order_acq_rel);
+    if (auto* flags = GetCompanionFlags(AcquireCompanionSlot(actor), actor))
+        flags->stuckCounter.fetch_add(1, std::memory_order_acq_rel);
 }
 void ActorTracking::SetActorStuckCounterFast(RE::Actor* actor, int counter) {
-    if (!actor) return;
-    std::lock_guard<std::mutex> lk(g_companionFlagsMutex);
-    auto it = g_companionFlags.find(actor);
-    if (it == g_companionFlags.end()) it = g_companionFlags.try_emplace(actor).first;
-    it->second.stuckCounter.store(counter, std::memory_order_release);
+    if (auto* flags = GetCompanionFlags(AcquireCompanionSlot(actor), actor))
+        flags->stuckCounter.store(counter, std::memory_order_release);
 }
 
 float ActorTracking::GetActorVelocityFast(RE::Actor* actor) {
-    if (!actor) return 0.0f;
-    std::lock_guard<std::mutex> lk(g_companionFlagsMutex);
-    auto it = g_companionFlags.find(actor);
-    return (it != g_companionFlags.end()) ? it->second.velocity.load(std::memory_order_acquire) : 0.0f;
+    auto* flags = GetCompanionFlags(FindCompanionSlot(actor), actor);
+    return flags ? flags->velocity.load(std::memory_order_acquire) : 0.0f;
 }
 void ActorTracking::SetActorVelocityFast(RE::Actor* actor, float vel) {
-    if (!actor) return;
-    std::lock_guard<std::mutex> lk(g_companionFlagsMutex);
-    auto it = g_companionFlags.find(actor);
-    if (it == g_companionFlags.end()) it = g_companionFlags.try_emplace(actor).first;
-    it->second.velocity.store(vel, std::memory_order_release);
+    if (auto* flags = GetCompanionFlags(AcquireCompanionSlot(actor), actor))
+        flags->velocity.store(vel, std::memory_order_release);
 }
 
 void ActorTracking::SetActorLastPositionFast(RE::Actor* actor, const RE::NiPoint3& pos) {
-    if (!actor) return;
-    std::lock_guard<std::mutex> lk(g_companionFlagsMutex);
-    auto it = g_companionFlags.find(actor);
-    if (it == g_companionFlags.end()) it = g_companionFlags.try_emplace(actor).first;
-    it->second.lastPosX.store(pos.x, std::memory_order_release);
-    it->second.lastPosY.store(pos.y, std::memory_order_release);
-    it->second.lastPosZ.store(pos.z, std::memory_order_release);
+    if (auto* flags = GetCompanionFlags(AcquireCompanionSlot(actor), actor))
+        flags->StorePosition(pos);
 }
 void ActorTracking::GetActorLastPositionFast(RE::Actor* actor, RE::NiPoint3& outPos) {
-    outPos = RE::NiPoint3{0.0f, 0.0f, 0.0f};
-    if (!actor) return;
-    std::lock_guard<std::mutex> lk(g_companionFlagsMutex);
-    auto it = g_companionFlags.find(actor);
-    if (it == g_companionFlags.end()) return;
-    outPos.x = it->second.lastPosX.load(std::memory_order_acquire);
-    outPos.y = it->second.lastPosY.load(std::memory_order_acquire);
-    outPos.z = it->second.lastPosZ.load(std::memory_order_acquire);
+    auto* flags = GetCompanionFlags(FindCompanionSlot(actor), actor);
+    outPos = flags ? flags->LoadPosition() : RE::NiPoint3{0.0f, 0.0f, 0.0f};
 }
 
 bool ActorTracking::GetActorLostStatusFast(RE::Actor* actor) {
-    if (!actor) return false;
-    std::lock_guard<std::mutex> lk(g_companionFlagsMutex);
-    auto it = g_companionFlags.find(actor);
-    return (it != g_companionFlags.end()) ? it->second.lost.load(std::memory_order_acquire) : false;
+    auto* flags = GetCompanionFlags(FindCompanionSlot(actor), actor);
+    return flags ? flags->lost.load(std::memory_order_acquire) : false;
 }
 void ActorTracking::SetActorLostStatusFast(RE::Actor* actor, bool lost) {
-    if (!actor) return;
-    std::lock_guard<std::mutex> lk(g_companionFlagsMutex);
-    auto it = g_companionFlags.find(actor);
-    if (it == g_companionFlags.end()) it = g_companionFlags.try_emplace(actor).first;
-    it->second.lost.store(lost, std::memory_order_release);
+    if (auto* flags = GetCompanionFlags(AcquireCompanionSlot(actor), actor))
+        flags->lost.store(lost, std::memory_order_release);
+}
+
+// Two phase actor scan
+namespace ActorPipeline {
+GatherRecord GatherActor(RE::Actor* actor, RE::PlayerCharacter* player, const CompiledConfig& compiled) {
+    GatherRecord record{};
+    record.actor = actor;
+    if (!actor)
+        return record;
+    record.formID = actor->GetFormID();
+    record.isPlayer = actor->IsPlayerRef();
+    record.isDead = actor->IsDead(true);
+    // Dead actors and the player are skipped by the analysis, keep their copy minimal
+    if (record.isPlayer || record.isDead)
+        return record;
+    // Position and distance
+    record.position = actor->GetPosition();
+    record.distanceToPlayer = player ? record.position.GetDistance(player->GetPosition()) : FLT_MAX;
+    // States
+    record.states = CheckActorStates(actor);
+    // Health
+    auto* health = RE::ActorValue::GetSingleton()->health;
+    if (health) {
+        record.health = actor->GetActorValue(*health);
+        record.maxHealth = actor->GetPermanentActorValue(*health);
+    }
+    // Classification inputs
+    record.isInCombat = actor->IsInCombat();
+    record.isHostile = IsActorEnemy_Internal(actor);
+    record.isCompanion = IsActorActiveCompanion_Internal(actor);
+    record.objectFormID = actor->GetObjectReference() ? actor->GetObjectReference()->GetFormID() : 0;
+    // NPC info
+    if (auto* npc = actor->GetNPC()) {
+        auto npcFeatures = FormFeatureCache::GetNpc(npc);
+        record.hasNPC = true;
+        record.baseFormID = npc->GetFormID();
+        record.isUnique = npcFeatures.isUnique;
+        record.hasLegendTemplate = npcFeatures.hasLegendTemplate;
+        record.hasLegendChance = npcFeatures.hasLegendChance;
+    }
+    if (auto displayName = actor->GetDisplayFullName()) {
+        record.hasLegendaryName = std::string_view(displayName).find("Legendary") != std::string_view::npos;
+    }
+    // Equipped weapons, one cache probe per equipped item
+    if (actor->currentProcess && actor->currentProcess->middleHigh) {
+        for (auto& equippedItem : actor->currentProcess->middleHigh->equippedItems) {
+            if (record.weaponCount >= MAX_GATHER_WEAPONS)
+                break;
+            if (FormFeatureCache::GetWeapon(equippedItem.item.object, record.weapons[record.weaponCount]))
+                record.weaponCount++;
+        }
+    }
+    // Companion only data
+    if (record.isCompanion) {
+        // Stimpak (human) or repair kit (synth gen 3 component in inventory, or non-human race)
+        if (actor->inventoryList && actor->race && !actor->IsDead(false) && !compiled.stimpakRaces.Empty() && g_raceSynth3C) {
+            record.stimpakKnown = true;
+            bool isStimpakRace = compiled.stimpakRaces.Contains(actor->race->GetFormID());
+            record.usesStimpak = isStimpakRace;
+            if (isStimpakRace) {
+                auto* index = InventoryCache::Get(actor);
+                if (index && InventoryCache::GetCount(*index, g_raceSynth3C->GetFormID()) > 0)
+                    record.usesStimpak = false;
+            }
+        }
+        // Movement loop state
+        record.stuckCounter = ActorTracking::GetActorStuckCounterFast(actor);
+        record.lost = ActorTracking::GetActorLostStatusFast(actor);
+    }
+    return record;
+}
+
+void Gather(GatherBuffer& buffer) {
+    buffer.records.clear();
+    buffer.time = std::chrono::steady_clock::now();
+    buffer.isInSettlement = CheckIsCurrentCellSettlement_Internal();
+    auto* player = RE::PlayerCharacter::GetSingleton();
+    auto actors = GetAllActors_Internal();
+    auto compiled = g_compiledConfig.load(std::memory_order_acquire);
+    buffer.records.reserve(actors.size());
+    for (auto* actor : actors) {
+        if (actor)
+            buffer.records.push_back(GatherActor(actor, player, *compiled));
+    }
+}
+
+AnalyzeParams MakeAnalyzeParams() {
+    AnalyzeParams params{};
+    params.updateInterval = Cfg().UPDATE_INTERVAL;
+    params.fallbackEnemyMaxHealth = g_enemyMaxHealthInCell.load();
+    params.weaponBonus = Cfg().THREAT_WEAPON_BONUS;
+    params.legendaryBonus = Cfg().THREAT_LEGENDARY_BONUS;
+    params.uniqueBonus = Cfg().THREAT_UNIQUE_BONUS;
+    params.healthBonus = Cfg().THREAT_HEALTH_BONUS;
+    params.alertBonus = Cfg().THREAT_ALERT_BONUS;
+    params.compiled = g_compiledConfig.load(std::memory_order_acquire);
+    return params;
+}
+}
+
+// Form feature cache
+namespace FormFeatureCache {
+FormIDMap<WeaponFeatures> g_weapons;
+FormIDMap<NpcFeatures> g_npcs;
+
+ActorPipeline::WEAPON_CLASS ClassifyWeapon(RE::WEAPON_TYPE weaponType) {
+    using ActorPipeline::WEAPON_CLASS;
+    switch (weaponType) {
+    case RE::WEAPON_TYPE::kHandToHand:
+    case RE::WEAPON_TYPE::kOneHandSword:
+    case RE::WEAPON_TYPE::kOneHandDagger:
+    case RE::WEAPON_TYPE::kOneHandAxe:
+    case RE::WEAPON_TYPE::kOneHandMace:
+    case RE::WEAPON_TYPE::kTwoHandSword:
+    case RE::WEAPON_TYPE::kTwoHandAxe:
+        return WEAPON_CLASS::MELEE;
+    case RE::WEAPON_TYPE::kGrenade:
+    case RE::WEAPON_TYPE::kMine:
+        return WEAPON_CLASS::EXPLOSIVE;
+    case RE::WEAPON_TYPE::kGun:
+    case RE::WEAPON_TYPE::kBow:
+    case RE::WEAPON_TYPE::kStaff:
+        return WEAPON_CLASS::RANGED;
+    default:
+        return WEAPON_CLASS::OTHER;
+    }
+}
+
+bool GetWeapon(RE::TESForm* form, ActorPipeline::GatherWeapon& weapon) {
+    if (!form)
+        return false;
+    std::uint32_t formID = form->GetFormID();
+    if (const auto* cached = g_weapons.Find(formID); cached && cached->form == form) {
+        if (cached->isWeapon)
+            weapon = cached->weapon;
+        return cached->isWeapon;
+    }
+    // First sighting of this form, Insert ignores the reserved FormID 0
+    WeaponFeatures features{};
+    features.form = form;
+    if (auto* weaponForm = form->As<RE::TESObjectWEAP>()) {
+        features.isWeapon = true;
+        features.weapon.formID = formID;
+        features.weapon.value = weaponForm->weaponData.value;
+        features.weapon.damage = weaponForm->weaponData.attackDamage;
+        features.weapon.weaponClass = ClassifyWeapon(weaponForm->weaponData.type.get());
+    }
+    g_weapons.Insert(formID, features);
+    if (features.isWeapon)
+        weapon = features.weapon;
+    return features.isWeapon;
+}
+
+NpcFeatures GetNpc(RE::TESNPC* npc) {
+    std::uint32_t formID = npc->GetFormID();
+    if (const auto* cached = g_npcs.Find(formID); cached && cached->npc == npc)
+        return *cached;
+    // First sighting of this NPC base
+    NpcFeatures features{};
+    features.npc = npc;
+    features.isUnique = npc->IsUnique();
+    features.hasLegendTemplate = npc->legendTemplate != nullptr;
+    features.hasLegendChance = npc->legendChance != nullptr;
+    g_npcs.Insert(formID, features);
+    return features;
+}
+
+void Clear() {
+    g_weapons.Clear();
+    g_npcs.Clear();
+}
+}
+
+// Loot catalogue
+void LootCatalogue::Clear() {
+    for (auto& bucket : buckets)
+        bucket.clear();
+    corpseGrid.Clear();
+}
+
+void LootCatalogue::Add(RE::TESObjectREFR* ref, bool candidate) {
+    if (!ref)
+        return;
+    LOOT_BUCKET bucket = LOOT_BUCKET::LOOSE;
+    if (auto* actor = ref->As<RE::Actor>()) {
+        if (!actor->IsDead(false))
+            return; // Skip alive actor objects
+        corpseGrid.Insert(ref->GetPosition(), ref->GetHandle());
+        bucket = LOOT_BUCKET::CORPSE;
+    } else if (ref->inventoryList) {
+        bucket = LOOT_BUCKET::CONTAINER;
+    }
+    if (!candidate)
+        return;
+    // Keep handles, references can be unloaded between frames
+    buckets[static_cast<std::size_t>(bucket)].push_back(ref->GetHandle());
+}
+
+void LootCatalogue::Build() {
+    corpseGrid.Build();
+}
+
+std::size_t LootCatalogue::Size() const {
+    std::size_t size = 0;
+    for (const auto& bucket : buckets)
+        size += bucket.size();
+    return size;
+}
+
+RE::ObjectRefHandle LootCatalogue::At(std::size_t index) const {
+    for (const auto& bucket : buckets) {
+        if (index < bucket.size())
+            return bucket[index];
+        index -= bucket.size();
+    }
+    return {};
+}
+
+bool LootCatalogue::HasCorpseNear(const RE::NiPoint3& position, float radius) const {
+    return corpseGrid.AnyInRadius(position, radius);
+}
+
+// Persistent reference catalogue
+namespace LootTracking {
+std::mutex g_pendingMutex;
+std::vector<std::uint32_t> g_pendingCells;
+std::vector<std::uint32_t> g_pendingRefs;
+std::unordered_map<std::uint32_t, Entry> g_entries;
+std::uint32_t g_lastPlayerCell = 0;
+SkipStats g_skipStats;
+
+void QueueCell(std::uint32_t cellFormID) {
+    if (!cellFormID)
+        return;
+    std::lock_guard<std::mutex> lock(g_pendingMutex);
+    g_pendingCells.push_back(cellFormID);
+}
+
+void QueueReference(std::uint32_t refFormID) {
+    if (!refFormID)
+        return;
+    std::lock_guard<std::mutex> lock(g_pendingMutex);
+    g_pendingRefs.push_back(refFormID);
+}
+
+void Refresh() {
+    std::vector<std::uint32_t> cells;
+    std::vector<std::uint32_t> refs;
+    {
+        std::lock_guard<std::mutex> lock(g_pendingMutex);
+        cells.swap(g_pendingCells);
+        refs.swap(g_pendingRefs);
+    }
+    // The player's cell can be entered without a load event (cached interiors, loaded saves)
+    auto* player = RE::PlayerCharacter::GetSingleton();
+    if (player && player->parentCell && player->parentCell->GetFormID() != g_lastPlayerCell) {
+        g_lastPlayerCell = player->parentCell->GetFormID();
+        cells.push_back(g_lastPlayerCell);
+    }
+    // New cells: add the references not known yet
+    for (auto cellFormID : cells) {
+        auto* cell = RE::TESForm::GetFormByID<RE::TESObjectCELL>(cellFormID);
+        if (!cell || !cell->IsAttached())
+            continue;
+        for (auto& refHandle : cell->references) {
+            if (auto* ref = refHandle.get())
+                g_entries.try_emplace(ref->GetFormID(), Entry{ref->GetHandle(), true});
+        }
+    }
+    // Changed references: (re)mark them for the next loot pass
+    for (auto refFormID : refs) {
+        auto* ref = RE::TESForm::GetFormByID<RE::TESObjectREFR>(refFormID);
+        if (ref)
+            g_entries[refFormID] = Entry{ref->GetHandle(), true};
+    }
+    // Drop references that were unloaded, deleted or whose cell was detached
+    std::erase_if(g_entries, [](const auto& item) {
+        auto ref = item.second.handle.get();
+        return !ref || ref->IsDeleted() || !ref->parentCell || !ref->parentCell->IsAttached();
+    });
+    if (DEBUGGING && (!cells.empty() || !refs.empty()))
+        REX::INFO("LootTracking: {} cells scanned, {} references changed, {} references tracked", cells.size(), refs.size(), g_entries.size());
+}
+
+void Collect(LootCatalogue& catalogue) {
+    for (const auto& [formID, entry] : g_entries) {
+        auto ref = entry.handle.get();
+        if (ref)
+            catalogue.Add(ref.get(), entry.dirty);
+    }
+}
+
+void MarkVisited(std::uint32_t refFormID) {
+    auto it = g_entries.find(refFormID);
+    // Locked references are tried again once LOOT_SKIP_LOCKED_TTL expires
+    if (it != g_entries.end() && it->second.skip != LOOT_SKIP::LOCKED)
+        it->second.dirty = false;
+}
+
+LOOT_SKIP GetSkip(std::uint32_t refFormID) {
+    auto it = g_entries.find(refFormID);
+    if (it == g_entries.end() || it->second.skip == LOOT_SKIP::NONE) {
+        g_skipStats.misses++;
+        return LOOT_SKIP::NONE;
+    }
+    auto& entry = it->second;
+    // Verdicts of older settings and expired locks are evaluated again
+    if (entry.skipGeneration != Cfg().generation || (entry.skip == LOOT_SKIP::LOCKED && std::chrono::steady_clock::now() >= entry.skipExpires)) {
+        entry.skip = LOOT_SKIP::NONE;
+        g_skipStats.misses++;
+        return LOOT_SKIP::NONE;
+    }
+    g_skipStats.hits++;
+    return entry.skip;
+}
+
+void MarkSkip(std::uint32_t refFormID, LOOT_SKIP reason) {
+    auto it = g_entries.find(refFormID);
+    if (it == g_entries.end())
+        return;
+    auto& entry = it->second;
+    entry.skip = reason;
+    entry.skipGeneration = Cfg().generation;
+    if (reason == LOOT_SKIP::LOCKED)
+        entry.skipExpires = std::chrono::steady_clock::now() + LOOT_SKIP_LOCKED_TTL;
+    g_skipStats.stored++;
+}
+
+void Clear() {
+    {
+        std::lock_guard<std::mutex> lock(g_pendingMutex);
+        g_pendingCells.clear();
+        g_pendingRefs.clear();
+    }
+    g_entries.clear();
+    g_lastPlayerCell = 0;
+    g_skipStats = {};
+}
+}
+
+// Loot planner
+namespace LootPlanner {
+void Gather(const ActorTracking::Snapshot& snapshot, const LootCatalogue& catalogue, Input& input) {
+    input.looters.clear();
+    input.targets.clear();
+    // Companions, the carry weight is read once per pass
+    auto* carryWeightAV = RE::ActorValue::GetSingleton()->carryWeight;
+    for (const auto& companionData : snapshot.companions) {
+        auto* companion = companionData.actor;
+        if (!companion)
+            continue;
+        Looter looter{};
+        looter.actor = companion;
+        looter.position = companion->GetPosition();
+        // Skip if dead or in combat and LOOT_COMBAT is false
+        looter.active = !companion->IsDead(false) && (Cfg().LOOT_COMBAT || !companion->IsInCombat());
+        if (looter.active && Cfg().LOOT_WEIGHT_LIMIT && carryWeightAV)
+            looter.capacity = companion->GetActorValue(*carryWeightAV) - (companion->equippedWeight + companion->GetWeightInContainer());
+        input.looters.push_back(looter);
+    }
+    // References in loot order
+    input.targets.reserve(catalogue.Size());
+    for (std::size_t i = 0; i < catalogue.Size(); ++i) {
+        auto handle = catalogue.At(i);
+        auto object = handle.get();
+        if (!object)
+            continue;
+        Target target{};
+        target.handle = handle;
+        target.formID = object->GetFormID();
+        target.position = object->GetPosition();
+        // Known to have nothing to loot since it last changed, only marked visited when an eligible companion is in range
+        target.lootable = LootTracking::GetSkip(target.formID) == LOOT_SKIP::NONE;
+        // Check if the object has an owner and LOOT_STEAL is false
+        if (target.lootable && !Cfg().LOOT_STEAL && object->IsCrimeToActivate()) {
+            LootTracking::MarkSkip(target.formID, LOOT_SKIP::CRIME);
+            target.lootable = false;
+        }
+        // Get the total weight of the objects items
+        if (target.lootable && Cfg().LOOT_WEIGHT_LIMIT)
+            target.weight = object->GetWeightInContainer();
+        input.targets.push_back(target);
+    }
+}
+
+Params MakeParams() {
+    Params params{};
+    params.radius = Cfg().LOOT_RADIUS;
+    params.weightLimit = Cfg().LOOT_WEIGHT_LIMIT;
+    return params;
+}
+}
+
+// Per-actor inventory index
+namespace InventoryCache {
+std::mutex g_pendingMutex;
+std::vector<std::uint32_t> g_pendingActors;
+std::unordered_map<std::uint32_t, Index> g_indexes;
+// Reused between rebuilds
+std::vector<Entry> g_entries;
+
+// Copy what the index needs from one inventory item
+Entry MakeEntry(const RE::BGSInventoryItem& item) {
+    Entry entry{};
+    if (!item.object)
+        return entry;
+    entry.formID = item.object->GetFormID();
+    entry.count = item.GetCount();
+    if (IsArmorItem_Internal(item.object)) {
+        auto* armor = item.object->As<RE::TESObjectARMO>();
+        entry.kind = ITEM_KIND::ARMOR;
+        entry.slotMask = armor->bipedModelData.bipedObjectSlots;
+        entry.value = static_cast<float>(armor->armorData.value);
+        entry.rating = static_cast<float>(armor->armorData.rating);
+        entry.weight = armor->armorData.weight;
+        // Armor pieces but not the frame itself
+        entry.powerArmor = g_kwdArmorTypePower && armor->HasKeyword(g_kwdArmorTypePower) && !(g_kwdIsPowerArmorFrame && armor->HasKeyword(g_kwdIsPowerArmorFrame));
+    } else if (IsWeaponItem_Internal(item.object)) {
+        auto* weapon = item.object->As<RE::TESObjectWEAP>();
+        entry.kind = ITEM_KIND::WEAPON;
+        entry.value = static_cast<float>(weapon->weaponData.value);
+        entry.rating = static_cast<float>(weapon->weaponData.attackDamage);
+        entry.weight = weapon->weaponData.weight;
+    }
+    return entry;
+}
+
+void Invalidate(std::uint32_t actorFormID) {
+    if (!actorFormID)
+        return;
+    std::lock_guard<std::mutex> lock(g_pendingMutex);
+    g_pendingActors.push_back(actorFormID);
+}
+
+const Index* Get(RE::Actor* actor) {
+    if (!actor || !actor->inventoryList)
+        return nullptr;
+    // Apply the queued changes
+    {
+        std::lock_guard<std::mutex> lock(g_pendingMutex);
+        for (auto actorFormID : g_pendingActors) {
+            auto it = g_indexes.find(actorFormID);
+            if (it != g_indexes.end())
+                it->second.valid = false;
+        }
+        g_pendingActors.clear();
+    }
+    auto& data = actor->inventoryList->data;
+    auto& index = g_indexes[actor->GetFormID()];
+    auto scoring = static_cast<GEAR_SCORE>(Cfg().AI_EQUIP_SCORE);
+    // A moved or resized array is a change no event was seen for
+    if (index.valid && index.data == data.data() && index.size == data.size() && index.scoring == scoring)
+        return &index;
+    g_entries.clear();
+    g_entries.reserve(data.size());
+    for (const auto& item : data)
+        g_entries.push_back(MakeEntry(item));
+    BuildIndex(g_entries, index, scoring);
+    index.valid = true;
+    index.data = data.data();
+    index.size = data.size();
+    return &index;
+}
+
+RE::BGSInventoryItem* GetItem(RE::Actor* actor, const Index& index, std::int32_t entry) {
+    if (!actor || !actor->inventoryList || entry < 0)
+        return nullptr;
+    auto& data = actor->inventoryList->data;
+    if (!index.valid || index.data != data.data() || index.size != data.size() || static_cast<std::uint32_t>(entry) >= data.size())
+        return nullptr;
+    return &data[entry];
+}
+
+void Clear() {
+    {
+        std::lock_guard<std::mutex> lock(g_pendingMutex);
+        g_pendingActors.clear();
+    }
+    g_indexes.clear();
+}
+}
+
+// Teleport raycast probes
+namespace ProbeSystem {
+Stats g_stats;
+std::unordered_map<std::uint64_t, GroundSample> g_ground;
+RE::TESObjectCELL* g_groundCell = nullptr;
+
+// Unit vectors of the scan directions
+const std::array<std::array<float, 2>, DIRECTIONS>& Directions() {
+    static const auto table = []() {
+        std::array<std::array<float, 2>, DIRECTIONS> result{};
+        const float TWO_PI = 6.28318530717958647692f;
+        for (std::size_t i = 0; i < DIRECTIONS; ++i) {
+            float angle = TWO_PI * static_cast<float>(i) / static_cast<float>(DIRECTIONS);
+            result[i] = { std::cos(angle), std::sin(angle) };
+        }
+        return result;
+    }();
+    return table;
+}
+
+// Pack grid coordinates into a map key (21 bits each)
+std::uint64_t GroundKey(std::int32_t x, std::int32_t y, std::int32_t band) {
+    const std::uint64_t mask = (1ull << 21) - 1;
+    return ((static_cast<std::uint64_t>(x) & mask) << 42) | ((static_cast<std::uint64_t>(y) & mask) << 21) | (static_cast<std::uint64_t>(band) & mask);
+}
+
+void RayBatch::Cast(RE::TESObjectCELL* cell, RE::CFilter filter) {
+    if (!cell)
+        return;
+    for (auto& ray : rays) {
+        RE::bhkPickData pickData; // Initializing PickData every ray to reset previous hit info
+        pickData.collisionFilter.filter = filter.filter;
+        pickData.SetStartEnd(ray.start, ray.end);
+        cell->Pick(pickData);
+        ray.hit = pickData.HasHit();
+        ray.fraction = ray.hit ? pickData.GetHitFraction() : 1.0f;
+    }
+    g_stats.rays += rays.size();
+}
+
+RE::NiPoint3 ProbeXY(RE::NiPoint3 pos, RE::CFilter filter, float scanDistance, float moveDistance) {
+    auto* player = RE::PlayerCharacter::GetSingleton();
+    if (!player || !player->parentCell)
+        return pos;
+    static RayBatch batch;
+    batch.Clear();
+    // Horizontal rays a little above the start so low clutter does not count
+    const RE::NiPoint3 rayStart{ pos.x, pos.y, pos.z + 50.0f };
+    for (const auto& dir : Directions())
+        batch.Add(rayStart, { pos.x + dir[0] * scanDistance, pos.y + dir[1] * scanDistance, rayStart.z });
+    batch.Cast(player->parentCell, filter);
+    std::size_t best = DIRECTIONS;
+    float bestFraction = 1.0f;
+    for (std::size_t i = 0; i < batch.Size(); ++i) {
+        if (batch[i].hit && batch[i].fraction < bestFraction) {
+            bestFraction = batch[i].fraction;
+            best = i;
+        }
+    }
+    if (best == DIRECTIONS)
+        return pos;
+    // Step away from the closest hit until CLEARANCE from it, without getting closer than CLEARANCE to what is behind
+    const auto& behind = batch[(best + DIRECTIONS / 2) % DIRECTIONS];
+    float behindDistance = behind.hit ? behind.fraction * scanDistance : scanDistance;
+    float move = std::min({ moveDistance, CLEARANCE - bestFraction * scanDistance, behindDistance - CLEARANCE });
+    if (move <= 0.0f)
+        return pos;
+    pos.x -= Directions()[best][0] * move;
+    pos.y -= Directions()[best][1] * move;
+    return pos;
+}
+
+float ProbeZ(const RE::NiPoint3& pos, RE::CFilter filter, float scanDistanceUp, float scanDistanceDown) {
+    auto* player = RE::PlayerCharacter::GetSingleton();
+    if (!player || !player->parentCell)
+        return pos.z;
+    // Samples of another cell are useless
+    if (g_groundCell != player->parentCell || g_ground.size() > GROUND_MAX_SAMPLES) {
+        g_ground.clear();
+        g_groundCell = player->parentCell;
+    }
+    const auto now = std::chrono::steady_clock::now();
+    // The node nearest to the position is its column, other nodes could lift it onto a ledge next to it
+    const auto gx = static_cast<std::int32_t>(std::floor(pos.x / GROUND_SPACING + 0.5f));
+    const auto gy = static_cast<std::int32_t>(std::floor(pos.y / GROUND_SPACING + 0.5f));
+    const auto band = static_cast<std::int32_t>(std::floor(pos.z / GROUND_BAND));
+    // The ray starts from the position's own height, never above what the query scans
+    const float top = pos.z + scanDistanceUp;
+    const float bottom = pos.z - scanDistanceDown;
+    auto [it, inserted] = g_ground.try_emplace(GroundKey(gx, gy, band));
+    auto& sample = it->second;
+    // A cached ray answers if it started at or above this one and its first hit (or its whole length) is within this one
+    bool reusable = !inserted && now - sample.time < PROBE_GROUND_TTL && sample.top >= top && (sample.hit ? sample.z <= top : sample.bottom <= bottom);
+    if (reusable) {
+        g_stats.groundCached++;
+    } else {
+        const float x = static_cast<float>(gx) * GROUND_SPACING;
+        const float y = static_cast<float>(gy) * GROUND_SPACING;
+        static RayBatch batch;
+        batch.Clear();
+        batch.Add({ x, y, top }, { x, y, bottom });
+        batch.Cast(player->parentCell, filter);
+        const auto& ray = batch[0];
+        sample = { top + (bottom - top) * ray.fraction, ray.hit, top, bottom, now };
+        g_stats.groundCast++;
+    }
+    // Return original if no ground was found
+    return sample.hit && sample.z >= bottom ? sample.z : pos.z;
+}
+
+void Clear() {
+    g_ground.clear();
+    g_groundCell = nullptr;
+}
 }
 
 // Companion Movement task management
@@ -2560,8 +2868,8 @@ void AddCompanionTask(RE::Actor* companion, float duration) {
             return;
         }
     }
-    // Add new Companion task
-    g_companionTasks.push_back({companion, duration, 0.0f});
+    // Add new Companion task with its stable flags slot
+    g_companionTasks.push_back({companion, duration, 0.0f, ActorTracking::AcquireCompanionSlot(companion)});
 }
 void ProcessCompanionTasks(float deltaTime) {
     std::lock_guard<std::mutex> lock(g_companionTasksMutex);
@@ -2581,12 +2889,22 @@ void ProcessCompanionTasks(float deltaTime) {
                     ++it;
                     continue;
                 }
+                // Resolve the flags slot once per tick (re-acquire if the slot changed owner)
+                auto* flags = ActorTracking::GetCompanionFlags(it->flagsSlot, it->companion);
+                if (!flags) {
+                    it->flagsSlot = ActorTracking::AcquireCompanionSlot(it->companion);
+                    flags = ActorTracking::GetCompanionFlags(it->flagsSlot, it->companion);
+                    if (!flags) {
+                        ++it;
+                        continue;
+                    }
+                }
                 // Checks for stuck status
                 bool pathStuck = false;
                 bool velocityStuck = false;
                 bool collisionStuck = false;
                 // Get current velocity between main loop updates
-                float velocity = ActorTracking::GetActorVelocityFast(it->companion);
+                float velocity = flags->velocity.load(std::memory_order_acquire);
                 // Check when pathing
                 if (it->companion->IsPathing() && !it->companion->currentProcess->middleHigh->currentIdle) {
                     // IsPathValid checks if the path is still valid on the NavMesh
@@ -2595,7 +2913,7 @@ void ProcessCompanionTasks(float deltaTime) {
                     }
                     // speed < threshold indicates little to no real movement
                     // Could be stuck before an obstacle
-                    if (velocity < AI_STUCK_SPEED) {
+                    if (velocity < Cfg().AI_STUCK_SPEED) {
                         velocityStuck = true;
                     }
                 }
@@ -2603,31 +2921,31 @@ void ProcessCompanionTasks(float deltaTime) {
                 // Someone or somthing runs into the companion, could be the player
                 // compCharCtrl->numCollisions > 0 indicates collisions with the player or other objects
                 auto* compCharCtrl = it->companion->currentProcess->middleHigh->charController.get();
-                if (compCharCtrl->numCollisions > AI_STUCK_COLLISIONS) {
+                if (compCharCtrl->numCollisions > Cfg().AI_STUCK_COLLISIONS) {
                     collisionStuck = true;
                 }
                 // Check if any stuck condition is met
                 if (pathStuck || velocityStuck || collisionStuck) {
-                    ActorTracking::SetActorStuckStatusFast(it->companion, true);
+                    flags->stuck.store(true, std::memory_order_release);
                     if (pathStuck) {
-                        ActorTracking::IncrementActorStuckCounterFast(it->companion);
+                        flags->stuckCounter.fetch_add(1, std::memory_order_acq_rel);
                         MovementSystem::ApplyStuckMeasures1(it->companion);
                     } else if (velocityStuck) {
-                        ActorTracking::IncrementActorStuckCounterFast(it->companion);
+                        flags->stuckCounter.fetch_add(1, std::memory_order_acq_rel);
                         MovementSystem::ApplyStuckMeasures2(it->companion);
                     } else if (collisionStuck) {
-                        ActorTracking::IncrementActorStuckCounterFast(it->companion);
+                        flags->stuckCounter.fetch_add(1, std::memory_order_acq_rel);
                         MovementSystem::ApplyStuckMeasures2(it->companion);
                     }
-                    if (ActorTracking::GetActorStuckCounterFast(it->companion) > AI_STUCK_THRESHOLD) {
-                        ActorTracking::SetActorLostStatusFast(it->companion, true);
+                    if (flags->stuckCounter.load(std::memory_order_acquire) > Cfg().AI_STUCK_THRESHOLD) {
+                        flags->lost.store(true, std::memory_order_release);
                     }
                 } else {
                     // Not stuck - remove any applied measures
                     MovementSystem::RemoveStuckMeasures(it->companion);
                     // Clear stuck status
-                    ActorTracking::SetActorStuckStatusFast(it->companion, false);
-                    ActorTracking::SetActorStuckCounterFast(it->companion, 0);
+                    flags->stuck.store(false, std::memory_order_release);
+                    flags->stuckCounter.store(0, std::memory_order_release);
                 }
             }
             ++it;
@@ -2643,7 +2961,8 @@ void RemoveCompanionTask(RE::Actor* companion) {
             // Disable companion movement measures if any
             MovementSystem::RemoveStuckMeasures(it->companion);
             // Clear stuck status
-            ActorTracking::SetActorStuckStatusFast(it->companion, false);
+            if (auto* flags = ActorTracking::GetCompanionFlags(it->flagsSlot, it->companion))
+                flags->stuck.store(false, std::memory_order_release);
             g_companionTasks.erase(it);
             return;
         }
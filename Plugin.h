@@ -2,14 +2,8 @@
 #include <Global.h>
 
 // --- STRUCTS ---
-// Structure to hold all actor states
-struct ActorStateData
-{
-    std::uint32_t lifeState;       // LIFE_STATE (0-8)
-    std::uint32_t weaponState;     // WEAPON_STATE (0-5)
-    std::uint32_t gunState;        // GUN_STATE (0-8)
-    std::uint32_t interactingState; // INTERACTING_STATE (0-3)
-};
+// All INI settings (defined in Global.h)
+struct Config;
 
 // ========================================================================================
 // ACTOR STATE CHECKING FUNCTIONS
@@ -94,60 +88,111 @@ namespace ACTOR_STATE
     constexpr std::uint32_t ANY = 0xFF;
 }
 
-// Enemy Tier Classification System
-enum class ENEMY_TIER : std::uint8_t
+// Fixed size history, the newest entry overwrites the oldest
+template <class T, std::size_t N>
+class RingBuffer
 {
-    LOW = 0,      // Basic enemies (low health, simple behavior)
-    MEDIUM = 1,   // Standard enemies (moderate threat)
-    HIGH = 2      // Dangerous enemies (bosses, legendaries, high health)
+public:
+    void Push(const T& value) {
+        items[next] = value;
+        next = (next + 1) % N;
+        count = (std::min)(count + 1, N);
+    }
+    std::size_t Size() const { return count; }
+    bool Empty() const { return count == 0; }
+    // 0 is the oldest entry
+    const T& operator[](std::size_t i) const { return items[(next + N - count + i) % N]; }
+    const T& Back() const { return items[(next + N - 1) % N]; }
+    void Clear() { next = count = 0; }
+private:
+    std::array<T, N> items{};
+    std::size_t next = 0;
+    std::size_t count = 0;
 };
 
-// Enemy combat style flags
-struct EnemyAnalysis
+// Ammunition a companion is short of for its equipped weapons
+struct AmmoDeficit
 {
-    ENEMY_TIER tier;
-    float healthPercentOfMax;  // Relative to highest enemy in cell
-    bool isRanged;
-    bool isMelee;
-    bool hasGrenades;
-    bool isUnique;
-    bool isAlerted;
-    bool isLegendary;
+    RE::Actor* actor = nullptr;
+    RE::TESAmmo* ammo = nullptr;
+    std::int32_t count = 0;                   // Rounds in the inventory
+    std::int32_t minimum = 0;                 // Highest minimum of the weapons using this ammo
 };
 
-// Actor tracking data structure
-struct TrackedActorData
+// One ammunition top-up pass over all companions
+struct AmmoTopUpStats
 {
-    RE::Actor* actor;                    // Pointer to the actor
-    ENEMY_TIER tier;                     // Threat level (for enemies)
-    bool aiUpdated;                      // Whether AI was updated
-    bool buffed;                         // Whether buffs were applied
-    float distanceToPlayer;              // Distance in units
-    RE::NiPoint3 position;               // Current position
-    std::uint32_t lifeState;             // Current LIFE_STATE
-    std::uint32_t weaponState;           // Current WEAPON_STATE
-    std::uint32_t gunState;              // Current GUN_STATE
-    std::uint32_t interactingState;      // Current INTERACTING_STATE
-    float healthPercent;                 // Current health / max health
-    float maxHealth;                     // Maximum health pool
-    bool isAlerted;                      // In combat/alert state
-    bool isRanged;                       // Uses ranged weapons
-    bool isMelee;                        // Uses melee weapons
-    bool hasGrenades;                    // Can throw grenades
-    bool isUnique;                       // Unique NPC flag
-    bool isLegendary;                    // Legendary enemy flag
-    bool usesStimpak;                    // true = stimpak, false = repair kit
-    std::chrono::steady_clock::time_point lastUpdate;     // Last scan time
-    float velocity;                      // Current velocity
-    int stuckCounter;                    // Consecutive stuck updates
-    bool lost;                           // Whether actor is lost
+    std::chrono::steady_clock::time_point time{};
+    std::uint32_t companions = 0;
+    std::uint32_t weapons = 0;                // Equipped weapons using ammo
+    std::uint32_t deficits = 0;               // Companion and ammo pairs topped up
+    std::int64_t added = 0;                   // Rounds added
+    std::chrono::steady_clock::duration runTime{};
 };
 
+// Teleport raycast probes, main thread only
+namespace ProbeSystem
+{
+    // Horizontal obstacle scan directions, evenly spaced around the circle
+    inline constexpr std::size_t DIRECTIONS = 16;
+    // Distance the position is nudged to keep from obstacles
+    inline constexpr float CLEARANCE = 40.0f;
+    // Ground height grid spacing and vertical band (a band per floor of an interior)
+    inline constexpr float GROUND_SPACING = 32.0f;
+    inline constexpr float GROUND_BAND = 64.0f;
+    // Ground samples kept before the grid is dropped
+    inline constexpr std::size_t GROUND_MAX_SAMPLES = 4096;
+    // Ray queued in a batch, hit data is filled by Cast
+    struct Ray {
+        RE::NiPoint3 start;
+        RE::NiPoint3 end;
+        bool hit;
+        float fraction;
+    };
+    // Rays collected first and cast back to back in one pass
+    class RayBatch {
+    public:
+        void Clear() { rays.clear(); }
+        std::size_t Add(const RE::NiPoint3& start, const RE::NiPoint3& end) {
+            rays.push_back({ start, end, false, 1.0f });
+            return rays.size() - 1;
+        }
+        void Cast(RE::TESObjectCELL* cell, RE::CFilter filter);
+        std::size_t Size() const { return rays.size(); }
+        const Ray& operator[](std::size_t i) const { return rays[i]; }
+    private:
+        std::vector<Ray> rays;
+    };
+    // Cached ground ray of one grid node
+    struct GroundSample {
+        float z;                             // Hit height (valid if hit)
+        bool hit;
+        float top;                           // Start and end height of the ray
+        float bottom;
+        std::chrono::steady_clock::time_point time;
+    };
+    // Ray counters for debug logging
+    struct Stats {
+        std::uint64_t teleports = 0;
+        std::uint64_t rays = 0;
+        std::uint64_t groundCached = 0;
+        std::uint64_t groundCast = 0;
+    };
+    // Nudge a position away from the closest obstacle within CLEARANCE, by at most moveDistance and only into free space
+    RE::NiPoint3 ProbeXY(RE::NiPoint3 pos, RE::CFilter filter, float scanDistance, float moveDistance);
+    // Ground Z below a position from the cached grid node nearest to it, cast again if the cached ray can't answer
+    float ProbeZ(const RE::NiPoint3& pos, RE::CFilter filter, float scanDistanceUp, float scanDistanceDown);
+    // Drop the ground grid (cell change, game load)
+    void Clear();
+    extern Stats g_stats;
+}
+
 // Companion Movement task
 struct CompanionTask {
     RE::Actor* companion;
     float timeRemaining;
     float convexRadius;
+    std::uint32_t flagsSlot;             // Stable ActorTracking flags slot of the companion
 };
 
 // Companion Movement task management
@@ -172,19 +217,42 @@ namespace MovementSystem
 // Slower loop to update companion data
 namespace ActorTracking
 {
+    // Maximum number of companions with a flags slot
+    inline constexpr std::uint32_t MAX_COMPANION_SLOTS = 32;
+    inline constexpr std::uint32_t INVALID_SLOT = UINT32_MAX;
     // Faster loop to update companion flags
+    // Slots never move, so the movement loop can keep a slot index and skip any lookup or lock
     struct CompanionFlags {
+        std::atomic<RE::Actor*> owner{nullptr};
         std::atomic<bool> stuck{false};
         std::atomic<int> stuckCounter{0};
         std::atomic<float> velocity{0.0f};
         std::atomic<bool> lost{false};
+        // Buff signature of the last buff pass (0 = never buffed)
+        std::atomic<std::uint64_t> buffSignature{0};
+        // Seqlock for the last position (odd while a write is in progress)
+        std::atomic<std::uint32_t> posSeq{0};
         std::atomic<float> lastPosX{0.0f};
         std::atomic<float> lastPosY{0.0f};
         std::atomic<float> lastPosZ{0.0f};
+        // Write x/y/z as one consistent position
+        void StorePosition(const RE::NiPoint3& pos);
+        // Read x/y/z as one consistent position (retries while a write is in progress)
+        RE::NiPoint3 LoadPosition() const;
+        // Reset all values before handing the slot to a new owner
+        void Reset();
     };
-    // Fast per-companion flags (mutex only for map structural changes)
+    // Stable per-companion flag slots (mutex only for assigning/releasing slots)
     extern std::mutex g_companionFlagsMutex;
-    extern std::unordered_map<RE::Actor*, CompanionFlags> g_companionFlags;
+    extern std::array<CompanionFlags, MAX_COMPANION_SLOTS> g_companionFlags;
+    // Find the slot owned by an actor without locking (INVALID_SLOT if none)
+    std::uint32_t FindCompanionSlot(RE::Actor* actor);
+    // Get the slot owned by an actor, assigning a free one if needed (INVALID_SLOT if full)
+    std::uint32_t AcquireCompanionSlot(RE::Actor* actor);
+    // Same as AcquireCompanionSlot for callers already holding g_companionFlagsMutex
+    std::uint32_t AcquireCompanionSlotLocked(RE::Actor* actor);
+    // Get the flags of a slot if it is still owned by the actor (nullptr otherwise)
+    CompanionFlags* GetCompanionFlags(std::uint32_t slot, RE::Actor* actor);
     void EnsureCompanionFlagEntry(RE::Actor* actor);
     void SyncCompanionFlagsWithSnapshot(const std::vector<TrackedActorData>& snapshot);
     bool GetActorStuckStatusFast(RE::Actor* actor);
@@ -198,125 +266,150 @@ namespace ActorTracking
     void SetActorVelocityFast(RE::Actor* actor, float vel);
     bool GetActorLostStatusFast(RE::Actor* actor);
     void SetActorLostStatusFast(RE::Actor* actor, bool lost);
-    // normal data tracking (mutex for entire data set)
-    extern std::mutex g_actorDataMutex;
-    extern std::vector<TrackedActorData> g_enemies;
-    extern std::vector<TrackedActorData> g_companions;
-    extern std::vector<TrackedActorData> g_neutralNPCs;
-    // CACHE: Previous frame data for comparison
-    extern std::vector<TrackedActorData> g_enemies_prev;
-    extern std::vector<TrackedActorData> g_companions_prev;
-    extern std::vector<TrackedActorData> g_neutralNPCs_prev;
-    // Helper to cache current state before update
-    inline void CacheCurrentState() {
-        std::lock_guard<std::mutex> lock(g_actorDataMutex);
-        g_enemies_prev = g_enemies;
-        g_companions_prev = g_companions;
-        g_neutralNPCs_prev = g_neutralNPCs;
-    }
-    // Replace companion data (thread-safe)
-    inline void ReplaceCompanionData(const std::vector<TrackedActorData>& newData) {
-        std::lock_guard<std::mutex> lock(g_actorDataMutex);
-        g_companions = newData;
-    }
-    // Replace enemy data (thread-safe)
-    inline void ReplaceEnemyData(const std::vector<TrackedActorData>& newData) {
-        std::lock_guard<std::mutex> lock(g_actorDataMutex);
-        g_enemies = newData;
-    }
-    // Replace neutral NPC data (thread-safe)
-    inline void ReplaceNeutralNPCData(const std::vector<TrackedActorData>& newData) {
-        std::lock_guard<std::mutex> lock(g_actorDataMutex);
-        g_neutralNPCs = newData;
-    }
-    // Get all companion data (thread-safe)
-    inline std::vector<TrackedActorData> GetCompanionData() {
-        std::lock_guard<std::mutex> lock(g_actorDataMutex);
-        return g_companions;  // Returns a copy
-    }
-    // Get a COPY of companion data (thread-safe)
-    inline std::optional<TrackedActorData> GetCompanionData(RE::Actor* actor) {
-        std::lock_guard<std::mutex> lock(g_actorDataMutex);
-        for (const auto& data : g_companions) {
-            if (data.actor == actor) {
-                return data;  // Returns a copy
-            }
-        }
-        return std::nullopt;
-    }
-    // Get previous companion data
-    inline std::optional<TrackedActorData> GetPreviousCompanionData(RE::Actor* actor) {
-        std::lock_guard<std::mutex> lock(g_actorDataMutex);
-        for (const auto& data : g_companions_prev) {
-            if (data.actor == actor) {
-                return data;
-            }
-        }
-        return std::nullopt;
-    }
-    // Helper to get enemy data (thread-safe)
-    inline std::vector<TrackedActorData> GetEnemyData() {
-        std::lock_guard<std::mutex> lock(g_actorDataMutex);
-        return g_enemies;  // Returns a copy
-    }
-    // Helper to get enemy data (thread-safe)
-    inline std::optional<TrackedActorData> GetEnemyData(RE::Actor* actor) {
-        std::lock_guard<std::mutex> lock(g_actorDataMutex);
-        for (const auto& data : g_enemies) {
-            if (data.actor == actor) {
-                return data;  // Returns a copy
-            }
-        }
-        return std::nullopt;
-    }
-    // Helper to get neutral NPC data (thread-safe)
-    inline std::vector<TrackedActorData> GetNeutralNPCData() {
-        std::lock_guard<std::mutex> lock(g_actorDataMutex);
-        return g_neutralNPCs;  // Returns a copy
-    }
-    // Helper get enemies actors
-    inline std::vector<RE::Actor*> GetEnemyActors() {
-        std::lock_guard<std::mutex> lock(g_actorDataMutex);
-        std::vector<RE::Actor*> actors;
-        for (const auto& data : g_enemies) {
-            if (data.actor) {
-                actors.push_back(data.actor);
-            }
-        }
-        return actors;
-    }
-    // Helper get companion actors
-    inline std::vector<RE::Actor*> GetCompanionActors() {
-        std::lock_guard<std::mutex> lock(g_actorDataMutex);
-        std::vector<RE::Actor*> actors;
-        for (const auto& data : g_companions) {
-            if (data.actor) {
-                actors.push_back(data.actor);
-            }
-        }
-        return actors;
-    }
-    // Helper get neutral NPC actors
-    inline std::vector<RE::Actor*> GetNeutralNPCActors() {
-        std::lock_guard<std::mutex> lock(g_actorDataMutex);
-        std::vector<RE::Actor*> actors;
-        for (const auto& data : g_neutralNPCs) {
-            if (data.actor) {
-                actors.push_back(data.actor);
-            }
-        }
-        return actors;
-    }
-    // Helper to clear stale data
-    inline void ClearAll() {
-        std::lock_guard<std::mutex> lock(g_actorDataMutex);
-        g_enemies.clear();
-        g_companions.clear();
-        g_neutralNPCs.clear();
-        g_enemies_prev.clear();
-        g_companions_prev.clear();
-        g_neutralNPCs_prev.clear();
-    }
+}
+
+// Two phase actor scan, the gather side (the engine free analysis is in Core.h)
+namespace ActorPipeline
+{
+    // Main thread: copy one actor
+    GatherRecord GatherActor(RE::Actor* actor, RE::PlayerCharacter* player, const CompiledConfig& compiled);
+    // Main thread: copy all actors around the player
+    void Gather(GatherBuffer& buffer);
+    // Capture the current settings for an analysis
+    AnalyzeParams MakeAnalyzeParams();
+}
+
+// Threat inputs that never change for a base form, cached by FormID until the next game load (main thread only)
+namespace FormFeatureCache
+{
+    // Cached equipped item, non-weapons are cached too so every item costs one probe
+    struct WeaponFeatures {
+        const RE::TESForm* form;             // Guards against a reused FormID
+        bool isWeapon;
+        ActorPipeline::GatherWeapon weapon;  // Valid if isWeapon
+    };
+    // Cached NPC base
+    struct NpcFeatures {
+        const RE::TESNPC* npc;               // Guards against a reused FormID
+        bool isUnique;
+        bool hasLegendTemplate;
+        bool hasLegendChance;
+    };
+    // Threat class of a weapon type
+    ActorPipeline::WEAPON_CLASS ClassifyWeapon(RE::WEAPON_TYPE weaponType);
+    // Weapon data of an equipped item (false if it is not a weapon)
+    bool GetWeapon(RE::TESForm* form, ActorPipeline::GatherWeapon& weapon);
+    // Unique and legendary bits of an NPC base
+    NpcFeatures GetNpc(RE::TESNPC* npc);
+    // Drop all entries (game load)
+    void Clear();
+}
+
+// Loot candidate buckets, in loot order
+enum class LOOT_BUCKET : std::uint8_t {
+    CORPSE,
+    CONTAINER,
+    LOOSE,
+    COUNT
+};
+
+// Why the loot pass skips a reference until it changes
+enum class LOOT_SKIP : std::uint8_t {
+    NONE,
+    CRIME,              // Owned by someone else and LOOT_STEAL is off
+    PLAYER_OWNED,
+    POWER_ARMOR,        // Power armor frame
+    LOCKED,             // Expires after LOOT_SKIP_LOCKED_TTL
+    EMPTY,
+    NOTHING_TO_LOOT,    // No item passes the loot filter
+    NOT_LOOTABLE        // Loose item that is not a weapon
+};
+
+// Per tick catalogue of the loot candidates, filled from the persistent reference catalogue
+// Corpses are spatially indexed so the loose weapon check is a lookup instead of another cell walk
+class LootCatalogue {
+public:
+    // Drop all references
+    void Clear();
+    // Sort a reference into its bucket (alive actors are skipped), corpses are indexed even when not a candidate
+    void Add(RE::TESObjectREFR* ref, bool candidate = true);
+    // Index the corpses, call after the last Add
+    void Build();
+    // Number of references over all buckets
+    std::size_t Size() const;
+    std::size_t Size(LOOT_BUCKET bucket) const { return buckets[static_cast<std::size_t>(bucket)].size(); }
+    // Reference by flat index over the buckets in loot order
+    RE::ObjectRefHandle At(std::size_t index) const;
+    // Check if a corpse lies within radius of a position
+    bool HasCorpseNear(const RE::NiPoint3& position, float radius) const;
+private:
+    std::array<std::vector<RE::ObjectRefHandle>, static_cast<std::size_t>(LOOT_BUCKET::COUNT)> buckets;
+    SpatialGrid<RE::ObjectRefHandle> corpseGrid{256.0f};
+};
+
+// Persistent catalogue of the references in the loaded cells, updated incrementally from events
+// Event sinks only queue form IDs, the catalogue itself is only touched on the main thread
+namespace LootTracking
+{
+    struct Entry {
+        RE::ObjectRefHandle handle;
+        bool dirty = true;      // Changed since the loot pass last evaluated it
+        // Negative verdict of an earlier pass, reset with the entry when the reference changes
+        LOOT_SKIP skip = LOOT_SKIP::NONE;
+        std::uint64_t skipGeneration = 0;                    // Config generation of the verdict
+        std::chrono::steady_clock::time_point skipExpires{}; // LOCKED only
+    };
+    // Skip memo counters since the session started
+    struct SkipStats {
+        std::uint64_t hits = 0;
+        std::uint64_t misses = 0;
+        std::uint64_t stored = 0;
+    };
+    extern std::mutex g_pendingMutex;
+    extern std::vector<std::uint32_t> g_pendingCells;
+    extern std::vector<std::uint32_t> g_pendingRefs;
+    extern std::unordered_map<std::uint32_t, Entry> g_entries;
+    extern std::uint32_t g_lastPlayerCell;
+    extern SkipStats g_skipStats;
+    // Any thread: queue a loaded cell for a scan
+    void QueueCell(std::uint32_t cellFormID);
+    // Any thread: queue a reference that appeared or whose contents changed
+    void QueueReference(std::uint32_t refFormID);
+    // Main thread: apply the queued changes and drop references of detached cells
+    void Refresh();
+    // Main thread: add the changed references as candidates, all corpses are indexed
+    void Collect(LootCatalogue& catalogue);
+    // Main thread: an eligible companion evaluated this reference, locked references stay pending until the lock expires
+    void MarkVisited(std::uint32_t refFormID);
+    // Main thread: remembered reason to skip a reference (NONE if it has to be evaluated)
+    LOOT_SKIP GetSkip(std::uint32_t refFormID);
+    // Main thread: remember that a reference has nothing to loot until it changes
+    void MarkSkip(std::uint32_t refFormID, LOOT_SKIP reason);
+    // Forget all references (new session)
+    void Clear();
+}
+
+// Loot planning, the gather side (the pure planner is in Core.h)
+namespace LootPlanner
+{
+    // Main thread: copy the companions of a snapshot and the references of a catalogue
+    void Gather(const ActorTracking::Snapshot& snapshot, const LootCatalogue& catalogue, Input& input);
+    // Capture the current settings for a plan
+    Params MakeParams();
+}
+
+// Per-actor index of the inventory, the cache side (the pure index is in Core.h)
+// Container events only queue form IDs, the index itself is only touched on the main thread
+namespace InventoryCache
+{
+    // Any thread: the inventory of this actor changed
+    void Invalidate(std::uint32_t actorFormID);
+    // Main thread: index of an actor's inventory, rebuilt if it changed (nullptr without inventory)
+    const Index* Get(RE::Actor* actor);
+    // Main thread: inventory item of an index entry (nullptr if the inventory changed since)
+    RE::BGSInventoryItem* GetItem(RE::Actor* actor, const Index& index, std::int32_t entry);
+    // Forget all indexes (new session)
+    void Clear();
 }
 
 // -- EVENTS ---
@@ -343,25 +436,67 @@ private:
     CompanionKillEventSink& operator=(CompanionKillEventSink&&) = delete;
 };
 
+// Event handler feeding the reference catalogue (cell loads, container changes and deaths)
+class LootCatalogueEventSink :
+    public RE::BSTEventSink<RE::TESCellFullyLoadedEvent>,
+    public RE::BSTEventSink<RE::TESContainerChangedEvent>,
+    public RE::BSTEventSink<RE::TESDeathEvent>
+{
+public:
+    virtual RE::BSEventNotifyControl ProcessEvent(
+        const RE::TESCellFullyLoadedEvent& a_event,
+        RE::BSTEventSource<RE::TESCellFullyLoadedEvent>* a_eventSource) override;
+    virtual RE::BSEventNotifyControl ProcessEvent(
+        const RE::TESContainerChangedEvent& a_event,
+        RE::BSTEventSource<RE::TESContainerChangedEvent>* a_eventSource) override;
+    virtual RE::BSEventNotifyControl ProcessEvent(
+        const RE::TESDeathEvent& a_event,
+        RE::BSTEventSource<RE::TESDeathEvent>* a_eventSource) override;
+
+    static LootCatalogueEventSink* GetSingleton()
+    {
+        static LootCatalogueEventSink singleton;
+        return &singleton;
+    }
+private:
+    LootCatalogueEventSink() = default;
+    ~LootCatalogueEventSink() = default;
+    LootCatalogueEventSink(const LootCatalogueEventSink&) = delete;
+    LootCatalogueEventSink(LootCatalogueEventSink&&) = delete;
+    LootCatalogueEventSink& operator=(const LootCatalogueEventSink&) = delete;
+    LootCatalogueEventSink& operator=(LootCatalogueEventSink&&) = delete;
+};
+
 // --- FUNCTIONS ---
 
 void ActionCompanions_Internal();
+void ActionCompanions_Internal(const TrackedActorData& companionData);
 RE::BGSInventoryItem* ActorAddInventoryItem_Internal(RE::Actor *actor, RE::TESForm *itemForm, std::int32_t count);
 void ActorRemoveInventoryItem_Internal(RE::Actor* actor, RE::TESForm* itemForm, std::int32_t count);
 void ApplyAIAggression_Internal();
+void ApplyAIAggression_Internal(const TrackedActorData& companionData);
 void ApplyPerksToCompanions_Internal();
+void ApplyPerksToCompanions_Internal(const TrackedActorData& companionData);
 void ApplyKeywordsToCompanions_Internal();
+void ApplyKeywordsToCompanions_Internal(const TrackedActorData& companionData);
 void BuffCompanions_Internal();
+void BuffCompanions_Internal(const TrackedActorData& companionData);
+std::uint64_t BuffSignature_Internal(RE::Actor* actor, const BuffTable& table);
+void BuildBuffTable_Internal();
+void CompileConfig_Internal();
 bool CheckActorHasItem_Internal(RE::Actor* actor, RE::TESForm* itemForm);
 ActorStateData CheckActorStates_Internal(RE::Actor* actor);
 bool CheckActorStatesMatch_Internal(RE::Actor* actor, std::uint32_t lifeStateFilter = 0xFF, std::uint32_t weaponStateFilter = 0xFF, std::uint32_t gunStateFilter = 0xFF, std::uint32_t interactingStateFilter = 0xFF);
 bool CheckIsCurrentCellSettlement_Internal();
-TrackedActorData CreateTrackedData_Internal(RE::Actor* actor, ENEMY_TIER tier = ENEMY_TIER::LOW);
 void CompanionsSetMortality_Internal();
 EnemyAnalysis EnemyActorAnalyze_Internal(RE::Actor* actor);
-std::map<ENEMY_TIER, int> EnemyActorAnalyzeThreatLevel_Internal(std::vector<TrackedActorData> enemyData);
+std::map<ENEMY_TIER, int> EnemyActorAnalyzeThreatLevel_Internal(const ActorTracking::Snapshot& snapshot);
 void EquipCompanions_Internal();
+void EquipCompanions_Internal(const TrackedActorData& companionData);
 void EquipAmmunition_Internal();
+void EquipAmmunition_Internal(const std::vector<TrackedActorData>& companions);
+void AmmoCollectDeficits_Internal(const TrackedActorData& companionData, std::vector<AmmoDeficit>& deficits, AmmoTopUpStats& stats);
+std::int32_t AmmoMinimum_Internal(RE::TESObjectWEAP* weapon);
 void EquipInventoryItem_Internal(RE::Actor* aNPC, RE::BGSInventoryItem* aInvItem);
 float GetActorAngleToActor(const RE::Actor* src, const RE::Actor* dst);
 float GetActorDistanceToObject_Internal(RE::Actor* actor, RE::TESObjectREFR* object);
@@ -369,8 +504,6 @@ float GetActorDistanceToPlayer_Internal(RE::Actor* actor);
 std::vector<RE::TESObjectREFR*> GetAllReferencesInCurrentCell_Internal();
 std::vector<RE::Actor*> GetAllActors_Internal();
 RE::BGSInventoryItem::Stack* GetInventoryItemStackData_Internal(RE::BGSInventoryItem* invItem);
-RE::NiPoint3 GetPointXY_Internal(RE::NiPoint3 a_pos, RE::CFilter a_filter, float a_stepRadians, float a_scanDistance, float a_moveDistance);
-float GetPointZ_Internal(RE::NiPoint3 a_pos, RE::CFilter a_filter, float a_scanDistanceUp, float a_scanDistanceDown);
 std::uint32_t GetSlotMaskFromIndex_Internal(std::int32_t aiSlotIndex);
 void HealActorDowned_Internal(RE::Actor *actor);
 void HealActorLimbs_Internal(RE::Actor* actor);
@@ -387,39 +520,98 @@ bool IsArmorItem_Internal(RE::TESForm* itemForm);
 bool IsArmorPowerFrame_Internal(RE::TESObjectREFR* armor);
 bool IsInventoryMenuOpen_Internal();
 bool IsWeaponItem_Internal(RE::TESForm* itemForm);
-RE::TESObjectREFR::RemoveItemData LootBuildRemoveItemData_Internal(RE::BGSInventoryItem *aInventoryItem, RE::TESObjectREFR *aContainer, std::int32_t aCount);
+RE::TESObjectREFR::RemoveItemData LootBuildRemoveItemData_Internal(RE::TESBoundObject *aObject, RE::TESObjectREFR *aContainer, std::int32_t aCount);
 std::int32_t LootItems_Internal();
-bool LootItemsWeaponLooseNearCorpse_Internal(RE::TESObjectREFR* source, RE::Actor* companion);
-bool LootItemsFromReference_Internal(RE::TESObjectREFR* source, RE::Actor* companion);
-bool LootItemFilter_Internal(RE::TESForm* a_FormRef);
-bool LootItemFilter_Internal(RE::TESForm* aForm);
+void LootBuildCatalogue_Internal(LootCatalogue& catalogue);
+bool LootExecuteTransfer_Internal(const LootPlanner::Input& input, const LootPlanner::Transfer& transfer, const LootCatalogue& catalogue, std::vector<LootPlanner::ItemTransfer>& items);
+void LootMarkVisited_Internal(const LootPlanner::Input& input, const LootPlanner::Plan& plan);
+bool LootItemsWeaponLooseNearCorpse_Internal(RE::TESObjectREFR* source, RE::Actor* companion, const LootCatalogue& catalogue);
+bool LootItemsFromReference_Internal(RE::TESObjectREFR* source, RE::Actor* companion, const LootCatalogue& catalogue, std::vector<LootPlanner::ItemTransfer>& items);
+bool LootItemFilter_Internal(RE::TESForm* aForm, const CompiledConfig& compiled);
+bool LootItemEvaluate_Internal(RE::TESForm* aForm, const CompiledConfig& compiled);
+RE::BGSKeywordForm* LootItemKeywords_Internal(RE::TESForm* aForm);
 void SetCompanionChatter_Internal(RE::Actor* comp);
 void SetCompanionCombatAI_Internal(RE::Actor* comp, RE::TESCombatStyle* combatStyle);
 void Update_Internal();
-std::int32_t UpdateGlobalActorArrays_Internal();
+std::int32_t UpdateGlobalActorArrays_Internal(const ActorPipeline::GatherBuffer& buffer);
+void UpdateAnalyze_Internal(const ActorPipeline::GatherBuffer& buffer);
 
 // --- HOOKS ---
 
-// This is our simple repeating timer to run periodic updates
-class CCB_RepeatingTimer {
+// Main thread subsystems, each has at most one pending job (highest priority first)
+enum class MAIN_JOB : std::uint8_t
+{
+    GATHER = 0,     // Actor scan feeding the next epoch
+    ACTION,         // Revive, stimpak, flee, combat target
+    AGGRESSION,
+    EQUIP,
+    BUFF,
+    PERK,
+    KEYWORD,
+    LOOT,
+    COUNT
+};
+
+// Coalescing, time-budgeted queue for work that has to run on the main thread
+// A subsystem never has more than one job pending, a newer submit replaces the stale one
+// Jobs run in slices: a job returns false while it has more work and resumes on a later frame
+class CCB_MainThreadQueue {
 public:
-    CCB_RepeatingTimer() : running(false) {}
-    // Start the timer with interval in seconds
-    void Start(int intervalSeconds, std::function<void()> callback) {
-        running = true;
-        std::thread([=]() mutable {
-            while (running) {
-                std::this_thread::sleep_for(std::chrono::seconds(intervalSeconds));
-                if (running) callback();
-            }
-        }).detach();
-    }
-    void Stop() { running = false; }
-    bool IsRunning() const { return running.load(); }
+    using Clock = std::chrono::steady_clock;
+    // A job slice, returns true when the job is finished
+    using Job = std::function<bool()>;
+    // Per subsystem slice timings
+    struct SliceStats {
+        std::uint64_t slices = 0;             // Slices run
+        Clock::duration maxTime{};            // Worst slice duration
+        Clock::duration totalTime{};          // Sum of slice durations
+    };
+    // Queue statistics
+    struct QueueStats {
+        std::uint64_t submitted = 0;          // Jobs submitted
+        std::uint64_t coalesced = 0;          // Submits merged into an already pending job
+        std::uint64_t executed = 0;           // Jobs started on the main thread
+        std::uint64_t frames = 0;             // Frames (drain tasks) that ran slices
+        std::uint64_t overBudget = 0;         // Frames that used up the budget with work left
+        std::uint32_t depth = 0;              // Jobs currently pending or in progress
+        Clock::duration oldestAge{};          // Age of the oldest pending job
+        Clock::duration maxWait{};            // Worst submit-to-start delay
+        Clock::duration totalWait{};          // Sum of submit-to-start delays
+        std::array<SliceStats, static_cast<std::size_t>(MAIN_JOB::COUNT)> slices{};
+    };
+    CCB_MainThreadQueue() = default;
+    CCB_MainThreadQueue(const CCB_MainThreadQueue&) = delete;
+    CCB_MainThreadQueue& operator=(const CCB_MainThreadQueue&) = delete;
+    // Submit a job for a subsystem, returns false if it replaced a pending job (a started job restarts with the new one)
+    bool Submit(MAIN_JOB subsystem, std::uint64_t epoch, Job callback);
+    // Check if a subsystem has a job waiting to run or in progress
+    bool IsPending(MAIN_JOB subsystem);
+    // Drop all pending jobs (i.e. on game load)
+    void Clear();
+    // Get a copy of the queue statistics
+    QueueStats GetStats();
 private:
-    std::atomic<bool> running;
+    struct Slot {
+        bool pending = false;                 // Waiting to run or in progress
+        bool started = false;                 // At least one slice has run
+        std::uint64_t epoch = 0;              // Snapshot epoch the job was submitted for
+        ConfigPtr config;                     // Config generation of the submitter, kept alive until the job finished
+        Clock::time_point queued{};           // First submit since the slot was last finished
+        std::shared_ptr<Job> callback;        // Shared so a slice can run without the lock
+    };
+    // Runs on the main thread, runs slices by priority until the frame budget is used up
+    void Drain();
+    // Queue a drain task for the next frame (caller must have set drainScheduled)
+    void ScheduleDrain();
+    std::mutex mutex;
+    std::array<Slot, static_cast<std::size_t>(MAIN_JOB::COUNT)> slots;
+    bool drainScheduled = false;
+    QueueStats stats;
 };
 
+// Build a job that handles one companion of the snapshot per slice
+CCB_MainThreadQueue::Job MakeCompanionSliceJob(ActorTracking::SnapshotPtr snapshot, std::function<void(const TrackedActorData&)> perCompanion);
+
 // --- PAPYRUS ---
 
 bool RegisterPapyrusFunctions(RE::BSScript::IVirtualMachine* vm);
\ No newline at end of file
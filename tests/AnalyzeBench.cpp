@@ -0,0 +1,24 @@
+#include <Bench.h>
+#include <Synthetic.h>
+
+// Worker side of one update: classify and score a synthetic gather buffer
+BENCH(Analyze_SyntheticBuffer) {
+    auto params = Synthetic::DefaultParams();
+    for (std::size_t count : {10u, 100u, 1000u}) {
+        Synthetic::World world;
+        Synthetic::FillWorld(world, count, 1234);
+        // Previous epoch of the same actors so the companion lookups hit
+        ActorTracking::Snapshot prev;
+        auto first = ActorPipeline::Analyze(world.buffer, prev, params);
+        prev.companions = std::move(first.companions);
+        prev.enemies = std::move(first.enemies);
+        prev.neutralNPCs = std::move(first.neutralNPCs);
+        prev.BuildIndex();
+        char label[64];
+        std::snprintf(label, sizeof(label), "Analyze, %zu actors", count);
+        Bench::Measure(label, Bench::Scale(std::max<std::size_t>(2000000 / count, 50), 5), [&]() {
+            auto result = ActorPipeline::Analyze(world.buffer, prev, params);
+            Bench::DoNotOptimize(result.enemies.data());
+        });
+    }
+}
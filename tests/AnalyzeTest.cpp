@@ -0,0 +1,180 @@
+#include <Synthetic.h>
+#include <Test.h>
+
+using namespace ActorPipeline;
+
+namespace
+{
+    // Live NPC record of an actor
+    GatherRecord Record(RE::Actor& actor) {
+        GatherRecord record{};
+        record.actor = &actor;
+        record.formID = actor.GetFormID();
+        record.baseFormID = actor.GetFormID() + 0x1000000;
+        record.hasNPC = true;
+        record.health = 100.0f;
+        record.maxHealth = 100.0f;
+        return record;
+    }
+
+    GatherWeapon Weapon(std::uint32_t value, float damage, WEAPON_CLASS weaponClass) {
+        return GatherWeapon{0x1234, value, damage, weaponClass};
+    }
+}
+
+TEST(Analyze_Classification) {
+    std::vector<RE::Actor> actors;
+    for (std::uint32_t i = 1; i <= 7; ++i)
+        actors.emplace_back(i * 0x10);
+    GatherBuffer buffer;
+    auto player = Record(actors[0]);
+    player.isPlayer = true;
+    auto dead = Record(actors[1]);
+    dead.isDead = true;
+    dead.isHostile = true;
+    auto companion = Record(actors[2]);
+    companion.isCompanion = true;
+    auto enemy = Record(actors[3]);
+    enemy.isHostile = true;
+    auto neutral = Record(actors[4]);
+    auto excluded = Record(actors[5]);
+    excluded.isHostile = true;
+    auto noActor = Record(actors[6]);
+    noActor.actor = nullptr;
+    buffer.records = {player, dead, companion, enemy, neutral, excluded, noActor};
+    auto params = Synthetic::DefaultParams();
+    auto compiled = std::make_shared<CompiledConfig>();
+    compiled->excludedActors.Insert(excluded.baseFormID, 1);
+    params.compiled = compiled;
+    ActorTracking::Snapshot prev;
+    auto result = Analyze(buffer, prev, params);
+    REQUIRE(result.companions.size() == 1);
+    REQUIRE(result.enemies.size() == 1);
+    REQUIRE(result.neutralNPCs.size() == 1);
+    CHECK(result.companions[0].actor == &actors[2]);
+    CHECK(result.enemies[0].actor == &actors[3]);
+    CHECK(result.neutralNPCs[0].actor == &actors[4]);
+    CHECK(IsExcluded(excluded, params));
+    CHECK(!IsExcluded(enemy, params));
+}
+
+// Companions take the per-epoch state over from the previous snapshot
+TEST(Analyze_CompanionUsesPreviousEpoch) {
+    RE::Actor actor(0x42);
+    ActorTracking::Snapshot prev;
+    TrackedActorData before{};
+    before.actor = &actor;
+    before.formID = actor.GetFormID();
+    before.position = RE::NiPoint3(0.0f, 0.0f, 0.0f);
+    before.aiUpdated = true;
+    before.usesStimpak = true;
+    prev.companions.push_back(before);
+    prev.BuildIndex();
+    GatherBuffer buffer;
+    auto record = Record(actor);
+    record.isCompanion = true;
+    record.position = RE::NiPoint3(300.0f, 0.0f, 0.0f);
+    record.stuckCounter = 4;
+    record.lost = true;
+    buffer.records.push_back(record);
+    auto params = Synthetic::DefaultParams();
+    params.updateInterval = 3.0f;
+    auto result = Analyze(buffer, prev, params);
+    REQUIRE(result.companions.size() == 1);
+    const auto& data = result.companions[0];
+    CHECK(data.aiUpdated);
+    // Not gathered this time, kept from the previous epoch
+    CHECK(data.usesStimpak);
+    CHECK_NEAR(data.velocity, 100.0f, 1e-3);
+    CHECK(data.stuckCounter == 4);
+    CHECK(data.lost);
+    // Gathered values win
+    buffer.records[0].stimpakKnown = true;
+    buffer.records[0].usesStimpak = false;
+    CHECK(!Analyze(buffer, prev, params).companions[0].usesStimpak);
+}
+
+TEST(Analyze_EnemyMaxHealth) {
+    std::vector<RE::Actor> actors{RE::Actor(1), RE::Actor(2), RE::Actor(3)};
+    GatherBuffer buffer;
+    for (std::size_t i = 0; i < actors.size(); ++i) {
+        auto record = Record(actors[i]);
+        record.isHostile = i != 2;
+        record.maxHealth = 100.0f * static_cast<float>(i + 1);
+        buffer.records.push_back(record);
+    }
+    ActorTracking::Snapshot prev;
+    auto result = Analyze(buffer, prev, Synthetic::DefaultParams());
+    // The neutral NPC (300) does not count
+    CHECK_NEAR(result.enemyMaxHealth, 200.0f, 1e-3);
+    buffer.records.resize(0);
+    CHECK(Analyze(buffer, prev, Synthetic::DefaultParams()).enemyMaxHealth == 0.0f);
+}
+
+TEST(Analyze_DescribeEnemy) {
+    RE::Actor actor(7);
+    auto record = Record(actor);
+    record.weaponCount = 2;
+    record.weapons[0] = Weapon(10, 10.0f, WEAPON_CLASS::MELEE);
+    record.weapons[1] = Weapon(10, 10.0f, WEAPON_CLASS::EXPLOSIVE);
+    record.hasLegendChance = true;
+    record.isInCombat = true;
+    record.health = 50.0f;
+    auto analysis = DescribeEnemy(record, 200.0f);
+    CHECK(analysis.isMelee);
+    CHECK(analysis.isRanged);
+    CHECK(analysis.hasGrenades);
+    CHECK(analysis.isLegendary);
+    CHECK(analysis.isAlerted);
+    CHECK_NEAR(analysis.healthPercentOfMax, 0.25f, 1e-6);
+    // Without an NPC base nothing is known
+    record.hasNPC = false;
+    auto unknown = DescribeEnemy(record, 200.0f);
+    CHECK(!unknown.isMelee && !unknown.isLegendary);
+}
+
+TEST(Analyze_ScoreEnemyTiers) {
+    RE::Actor actor(9);
+    auto params = Synthetic::DefaultParams();
+    // 3 (value) + 1 (damage) + 1 (ranged) + 3 (legendary name) + 3 (health) = 11
+    auto strong = Record(actor);
+    strong.weaponCount = 1;
+    strong.weapons[0] = Weapon(1200, 120.0f, WEAPON_CLASS::RANGED);
+    strong.hasLegendaryName = true;
+    CHECK(ScoreEnemy(strong, 100.0f, params).tier == ENEMY_TIER::HIGH);
+    // 1 (value) + 1 (ranged) + 3 (health) = 5
+    auto medium = Record(actor);
+    medium.weaponCount = 1;
+    medium.weapons[0] = Weapon(300, 20.0f, WEAPON_CLASS::RANGED);
+    CHECK(ScoreEnemy(medium, 100.0f, params).tier == ENEMY_TIER::MEDIUM);
+    // Health 20% of the strongest enemy, no weapon
+    auto weak = Record(actor);
+    weak.health = 20.0f;
+    CHECK(ScoreEnemy(weak, 100.0f, params).tier == ENEMY_TIER::LOW);
+    // Weights scale the points
+    params.weaponBonus = 0.0f;
+    params.legendaryBonus = 0.0f;
+    CHECK(ScoreEnemy(strong, 100.0f, params).tier == ENEMY_TIER::LOW);
+}
+
+// The batched tiers of Analyze match scoring each enemy on its own
+TEST(Analyze_BatchMatchesSingleScoring) {
+    Synthetic::World world;
+    Synthetic::FillWorld(world, 500, 77);
+    ActorTracking::Snapshot prev;
+    auto params = Synthetic::DefaultParams();
+    auto result = Analyze(world.buffer, prev, params);
+    CHECK(!result.enemies.empty());
+    std::size_t mismatches = 0;
+    std::size_t next = 0;
+    for (const auto& record : world.buffer.records) {
+        if (!record.isHostile || record.isCompanion || record.isDead)
+            continue;
+        REQUIRE(next < result.enemies.size());
+        const auto& data = result.enemies[next++];
+        if (data.actor != record.actor || data.tier != ScoreEnemy(record, result.enemyMaxHealth, params).tier)
+            mismatches++;
+    }
+    CHECK(next == result.enemies.size());
+    CHECK(mismatches == 0);
+}
@@ -0,0 +1,53 @@
+#pragma once
+#include <PCH.h>
+
+// Minimal benchmark registry for the host benchmarks
+// ccb_bench runs everything at full size, ccb_bench --quick is the ctest smoke run with small sizes
+namespace Bench
+{
+    using Clock = std::chrono::steady_clock;
+    using Function = void (*)();
+    struct Case {
+        const char* name;
+        Function function;
+    };
+    // All registered benchmarks, in registration order
+    std::vector<Case>& Registry();
+    // Register a benchmark, used by the BENCH macro
+    bool Register(const char* name, Function function);
+    // True for the smoke run
+    bool Quick();
+    // Iteration or element count, reduced for the smoke run
+    inline std::size_t Scale(std::size_t full, std::size_t quick) { return Quick() ? quick : full; }
+    // Keep a value alive so the measured work is not optimized away
+    template <class T>
+    inline void DoNotOptimize(const T& value) {
+#if defined(__GNUC__)
+        asm volatile("" : : "r,m"(value) : "memory");
+#else
+        static volatile const void* sink;
+        sink = &value;
+#endif
+    }
+    // Time iterations calls of fn, prints and returns nanoseconds per call
+    template <class F>
+    double Measure(const char* label, std::size_t iterations, F&& fn) {
+        // Warm up caches and branch predictors
+        for (std::size_t i = 0; i < (std::min<std::size_t>)(iterations, 16); ++i)
+            fn();
+        auto start = Clock::now();
+        for (std::size_t i = 0; i < iterations; ++i)
+            fn();
+        double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / static_cast<double>(iterations ? iterations : 1);
+        std::printf("  %-48s %12.1f ns/op\n", label, ns);
+        return ns;
+    }
+    // CPU time used by the process so far
+    double ProcessCpuSeconds();
+}
+
+// Define and register a benchmark
+#define BENCH(name)                                                    \
+    static void name();                                                \
+    static const bool name##_registered = Bench::Register(#name, name); \
+    static void name()
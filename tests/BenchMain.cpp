@@ -0,0 +1,46 @@
+#include <Bench.h>
+
+#include <ctime>
+
+namespace Bench
+{
+    // Set by --quick
+    static bool g_quick = false;
+
+    std::vector<Case>& Registry() {
+        static std::vector<Case> cases;
+        return cases;
+    }
+
+    bool Register(const char* name, Function function) {
+        Registry().push_back({name, function});
+        return true;
+    }
+
+    bool Quick() {
+        return g_quick;
+    }
+
+    double ProcessCpuSeconds() {
+        return static_cast<double>(std::clock()) / CLOCKS_PER_SEC;
+    }
+}
+
+// Run all benchmarks, or only those whose name contains the filter argument
+int main(int argc, char** argv) {
+    std::string_view filter;
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg = argv[i];
+        if (arg == "--quick")
+            Bench::g_quick = true;
+        else
+            filter = arg;
+    }
+    for (const auto& bench : Bench::Registry()) {
+        if (!filter.empty() && std::string_view(bench.name).find(filter) == std::string_view::npos)
+            continue;
+        std::printf("%s\n", bench.name);
+        bench.function();
+    }
+    return 0;
+}
@@ -0,0 +1,39 @@
+#include <Bench.h>
+#include <Synthetic.h>
+
+// Buff pass over 10 companions with the 18 buffs of the default settings: re-checked every tick vs signature skip
+// Also prints the actor value reads per tick, the signature skip only reads after a level-up or equip change
+BENCH(BuffEngine_SteadyState) {
+    constexpr std::size_t companionCount = 10;
+    std::vector<RE::ActorValueInfo> actorValues;
+    for (std::uint32_t i = 0; i < 18; ++i)
+        actorValues.emplace_back(i + 1);
+    BuffTable table;
+    table.generation = 1;
+    for (auto& actorValue : actorValues)
+        table.entries.push_back({&actorValue, 50.0f, RE::ACTOR_VALUE_MODIFIER::kPermanent, "bench"});
+    // Already buffed companions, one value array each indexed by the FormID of the actor value
+    std::vector<std::array<float, 19>> values(companionCount);
+    for (auto& companion : values)
+        companion.fill(60.0f);
+    std::size_t reads = 0;
+    auto pass = [&](std::vector<std::atomic<std::uint64_t>>* stored, std::size_t tick) {
+        for (std::size_t c = 0; c < companionCount; ++c) {
+            auto& companion = values[c];
+            // One companion levels up every 100 ticks
+            auto signature = BuffEngine::Signature(table.generation, static_cast<std::uint16_t>(10 + (c == 0 ? tick / 100 : 0)), 20.0f);
+            BuffEngine::Apply(table, signature, stored ? &(*stored)[c] : nullptr,
+                [&](const RE::ActorValueInfo& actorValue) { reads++; return companion[actorValue.GetFormID()]; },
+                [&](RE::ACTOR_VALUE_MODIFIER, const RE::ActorValueInfo& actorValue, float delta) { companion[actorValue.GetFormID()] += delta; });
+        }
+    };
+    std::size_t iterations = Bench::Scale(200000, 2000);
+    std::size_t tick = 0;
+    Bench::Measure("re-check every tick, 10 companions (tick)", iterations, [&]() { pass(nullptr, tick++); });
+    std::printf("  %-48s %12.2f reads/tick\n", "re-check every tick", static_cast<double>(reads) / static_cast<double>(tick));
+    std::vector<std::atomic<std::uint64_t>> stored(companionCount);
+    reads = 0;
+    tick = 0;
+    Bench::Measure("signature skip, 10 companions (tick)", iterations, [&]() { pass(&stored, tick++); });
+    std::printf("  %-48s %12.2f reads/tick\n", "signature skip", static_cast<double>(reads) / static_cast<double>(tick));
+}
@@ -0,0 +1,85 @@
+#include <Synthetic.h>
+#include <Test.h>
+
+namespace
+{
+    // Actor values of one companion with counters of the engine calls
+    struct FakeActor {
+        std::unordered_map<std::uint32_t, float> values;
+        std::size_t reads = 0;
+        std::size_t mods = 0;
+        auto Read() {
+            return [this](const RE::ActorValueInfo& actorValue) {
+                reads++;
+                return values[actorValue.GetFormID()];
+            };
+        }
+        auto Modify() {
+            return [this](RE::ACTOR_VALUE_MODIFIER, const RE::ActorValueInfo& actorValue, float delta) {
+                mods++;
+                values[actorValue.GetFormID()] += delta;
+            };
+        }
+    };
+}
+
+// Values below the floor are raised exactly to it, values above are left alone
+TEST(BuffEngine_RaisesToFloor) {
+    std::vector<RE::ActorValueInfo> actorValues{RE::ActorValueInfo(1), RE::ActorValueInfo(2), RE::ActorValueInfo(3)};
+    BuffTable table;
+    table.generation = 1;
+    for (std::size_t i = 0; i < actorValues.size(); ++i)
+        table.entries.push_back({&actorValues[i], 10.0f * static_cast<float>(i + 1), RE::ACTOR_VALUE_MODIFIER::kPermanent, "test"});
+    FakeActor actor;
+    actor.values = {{1, 4.0f}, {2, 25.0f}, {3, 30.0f}};
+    CHECK(BuffEngine::Apply(table, 1, nullptr, actor.Read(), actor.Modify()));
+    CHECK(actor.values[1] == 10.0f);
+    CHECK(actor.values[2] == 25.0f);
+    CHECK(actor.values[3] == 30.0f);
+    CHECK(actor.reads == 3);
+    CHECK(actor.mods == 1);
+}
+
+// An unchanged signature skips the companion without any read, a changed one re-checks every value
+TEST(BuffEngine_SignatureSkipsSteadyState) {
+    RE::ActorValueInfo actorValue(1);
+    BuffTable table;
+    table.generation = 1;
+    table.entries.push_back({&actorValue, 50.0f, RE::ACTOR_VALUE_MODIFIER::kPermanent, "test"});
+    FakeActor actor;
+    std::atomic<std::uint64_t> stored{0};
+    auto signature = BuffEngine::Signature(table.generation, 10, 12.5f);
+    CHECK(BuffEngine::Apply(table, signature, &stored, actor.Read(), actor.Modify()));
+    CHECK(stored.load() == signature);
+    for (int tick = 0; tick < 100; ++tick)
+        CHECK(!BuffEngine::Apply(table, signature, &stored, actor.Read(), actor.Modify()));
+    CHECK(actor.reads == 1);
+    // Level-up
+    CHECK(BuffEngine::Apply(table, BuffEngine::Signature(table.generation, 11, 12.5f), &stored, actor.Read(), actor.Modify()));
+    CHECK(actor.reads == 2);
+}
+
+// Every input of the signature changes it
+TEST(BuffEngine_SignatureInputs) {
+    auto base = BuffEngine::Signature(3, 20, 40.0f);
+    CHECK(base != 0);
+    CHECK(BuffEngine::Signature(4, 20, 40.0f) != base);
+    CHECK(BuffEngine::Signature(3, 21, 40.0f) != base);
+    CHECK(BuffEngine::Signature(3, 20, 40.5f) != base);
+    CHECK(BuffEngine::Signature(3, 20, 40.0f) == base);
+}
+
+// A table is only republished when a row changes
+TEST(BuffEngine_SameEntries) {
+    RE::ActorValueInfo a(1);
+    RE::ActorValueInfo b(2);
+    std::vector<BuffEntry> entries{{&a, 1.0f, RE::ACTOR_VALUE_MODIFIER::kPermanent, "a"}, {&b, 2.0f, RE::ACTOR_VALUE_MODIFIER::kPermanent, "b"}};
+    auto other = entries;
+    other[1].name = "renamed";
+    CHECK(BuffEngine::SameEntries(entries, other));
+    other[1].floor = 3.0f;
+    CHECK(!BuffEngine::SameEntries(entries, other));
+    other.pop_back();
+    CHECK(!BuffEngine::SameEntries(entries, other));
+    CHECK(BuffEngine::SameEntries({}, {}));
+}
@@ -0,0 +1,38 @@
+#include <Bench.h>
+#include <Config.h>
+
+// Parse of the shipped INI: single pass parser vs the old per line lower case copy with a prefix test per key
+BENCH(Config_ParseShippedIni) {
+    std::string text;
+    if (!ReadConfigText(CCB_ROOT_DIR "/CCBCL.ini", text)) {
+        std::printf("  CCBCL.ini not found\n");
+        return;
+    }
+    auto schema = GetConfigSchema();
+    std::size_t iterations = Bench::Scale(20000, 200);
+    Bench::Measure("single pass parser (INI)", iterations, [&]() {
+        Config config;
+        ClearConfigLists(config);
+        auto warnings = ParseConfigText(text, config);
+        Bench::DoNotOptimize(config.LOOT_RADIUS);
+        Bench::DoNotOptimize(warnings.size());
+    });
+    Bench::Measure("lower case line + prefix scan (INI)", iterations, [&]() {
+        std::size_t matched = 0;
+        std::string_view rest = text;
+        while (!rest.empty()) {
+            auto lineEnd = rest.find('\n');
+            std::string line(rest.substr(0, lineEnd));
+            rest.remove_prefix(lineEnd == std::string_view::npos ? rest.size() : lineEnd + 1);
+            std::string lowerLine = line;
+            std::transform(lowerLine.begin(), lowerLine.end(), lowerLine.begin(), [](char c) { return static_cast<char>(std::tolower(static_cast<unsigned char>(c))); });
+            for (const auto& key : schema) {
+                if (lowerLine.find(key.name) == 0) {
+                    matched++;
+                    break;
+                }
+            }
+        }
+        Bench::DoNotOptimize(matched);
+    });
+}
@@ -0,0 +1,118 @@
+#include <Config.h>
+#include <Test.h>
+
+namespace
+{
+    // Check if a field of two configs differs
+    bool Differs(const ConfigKey& key, const Config& a, const Config& b) {
+        switch (key.type) {
+        case CONFIG_TYPE::BOOL:
+            return a.*key.boolField != b.*key.boolField;
+        case CONFIG_TYPE::INT:
+            return a.*key.intField != b.*key.intField;
+        case CONFIG_TYPE::FLOAT:
+            return a.*key.floatField != b.*key.floatField;
+        case CONFIG_TYPE::FORMID:
+            return a.*key.formIDField != b.*key.formIDField;
+        case CONFIG_TYPE::FORMID_LIST:
+            return a.*key.listField != b.*key.listField;
+        }
+        return true;
+    }
+}
+
+// Keys are matched exactly and case-insensitively, a longer key is not a prefix match
+TEST(Config_ExactKeys) {
+    Config config;
+    config.AI_USE_STIMPAK = false;
+    auto warnings = ParseConfigText("[AI]\r\n; comment\r\n  Ai_Use_Stimpak_Unlimited = TRUE ; inline comment\r\n\r\nno value line\r\n", config);
+    CHECK(warnings.empty());
+    CHECK(config.AI_USE_STIMPAK_UNLIMITED);
+    CHECK(!config.AI_USE_STIMPAK);
+    warnings = ParseConfigText("AI_USE_STIMPAK=1\nAI_USE_STIMPAKS=0", config);
+    CHECK(config.AI_USE_STIMPAK);
+    REQUIRE(warnings.size() == 1);
+    CHECK(warnings[0] == "Unknown key: AI_USE_STIMPAKS");
+    // Last line without a line ending
+    ParseConfigText("LOOT_RADIUS=250.5", config);
+    CHECK(config.LOOT_RADIUS == 250.5f);
+}
+
+// Values that don't parse or are out of range keep the previous value and add a warning
+TEST(Config_RangesAndErrors) {
+    Config config;
+    auto warnings = ParseConfigText("UPDATE_INTERVAL=0\nUPDATE_INTERVAL=abc\nINI_RELOAD_INTERVAL=-1\nINI_RELOAD_INTERVAL=4\n", config);
+    CHECK(config.UPDATE_INTERVAL == Config().UPDATE_INTERVAL);
+    CHECK(config.INI_RELOAD_INTERVAL == 4);
+    REQUIRE(warnings.size() == 3);
+    CHECK(warnings[0] == "Invalid Update Interval value: 0. Must be positive.");
+    CHECK(warnings[1] == "Error parsing Update Interval value: abc.");
+    CHECK(warnings[2] == "Invalid INI Reload Interval value: -1. Must be non-negative.");
+}
+
+// FormIDs with and without 0x, repeated keys append to their list
+TEST(Config_FormIDs) {
+    Config config;
+    ClearConfigLists(config);
+    CHECK(config.RACE_STIMPAK_ID.empty());
+    auto warnings = ParseConfigText("ITEM_STIMPAK_ID=0x0001A2b3\nRACE_STIMPAK_ID=00013746\nRACE_STIMPAK_ID=000EAFB6\nRACE_STIMPAK_ID=zz\n", config);
+    CHECK(config.ITEM_STIMPAK_ID == 0x0001A2B3);
+    CHECK((config.RACE_STIMPAK_ID == std::vector<std::uint32_t>{0x00013746, 0x000EAFB6}));
+    REQUIRE(warnings.size() == 1);
+    CHECK(warnings[0] == "Error parsing Stimpak Race ID: zz.");
+    std::uint32_t formID = 0;
+    CHECK(!ParseConfigFormID("", formID));
+    CHECK(!ParseConfigFormID("123456789", formID));
+    CHECK(ParseConfigFormID("0XFF", formID) && formID == 0xFF);
+}
+
+TEST(Config_Schema) {
+    auto schema = GetConfigSchema();
+    REQUIRE(!schema.empty());
+    for (std::size_t i = 1; i < schema.size(); ++i)
+        CHECK(schema[i - 1].name < schema[i].name);
+    for (const auto& key : schema)
+        CHECK(FindConfigKey(key.name) == &key);
+    CHECK(FindConfigKey("AI_USE_STIMPAK") == nullptr);
+    CHECK(FindConfigKey("ai_use_stimpa") == nullptr);
+}
+
+// The shipped INI parses without warnings, its data section matches the built-in FormIDs
+TEST(Config_ShippedIni) {
+    std::string text;
+    REQUIRE(ReadConfigText(CCB_ROOT_DIR "/CCBCL.ini", text));
+    Config config;
+    ClearConfigLists(config);
+    auto warnings = ParseConfigText(text, config);
+    for (const auto& warning : warnings)
+        std::printf("    %s\n", warning.c_str());
+    CHECK(warnings.empty());
+    Config defaults;
+    for (const auto& key : GetConfigSchema()) {
+        if (key.type == CONFIG_TYPE::FORMID && Differs(key, config, defaults)) {
+            std::printf("    %.*s differs from the default\n", static_cast<int>(key.name.size()), key.name.data());
+            Test::Fail(__FILE__, __LINE__, "shipped INI matches the default FormIDs");
+        }
+    }
+    CHECK(config.RACE_STIMPAK_ID == defaults.RACE_STIMPAK_ID);
+    // Settings the shipped INI changes from the defaults
+    CHECK(config.LOOT_RADIUS != defaults.LOOT_RADIUS);
+}
+
+TEST(Config_FileStamp) {
+    auto path = std::filesystem::temp_directory_path() / "ccb_config_stamp_test.ini";
+    {
+        std::ofstream out(path, std::ios::binary);
+        out << "LOOT_RADIUS=100\n";
+    }
+    ConfigFileStamp stamp;
+    REQUIRE(StatConfigFile(path.string(), stamp));
+    CHECK(stamp.size == 16);
+    std::string text;
+    REQUIRE(ReadConfigText(path.string(), text));
+    CHECK(HashConfigText(text) != HashConfigText("LOOT_RADIUS=101\n"));
+    CHECK(HashConfigText(text) == HashConfigText("LOOT_RADIUS=100\n"));
+    std::filesystem::remove(path);
+    CHECK(!StatConfigFile(path.string(), stamp));
+    CHECK(!ReadConfigText(path.string(), text));
+}
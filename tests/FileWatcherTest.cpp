@@ -0,0 +1,133 @@
+#include <Config.h>
+#include <Core.h>
+#include <Test.h>
+
+namespace
+{
+    using WAIT = CCB_FileWatchBackend::WAIT;
+
+    // Scripted backend: returns the queued results, then blocks until interrupted
+    class FakeBackend final : public CCB_FileWatchBackend {
+    public:
+        explicit FakeBackend(std::vector<WAIT> script) : results(std::move(script)) {}
+        bool Open(const std::string&) override { return true; }
+        WAIT Wait(std::chrono::milliseconds) override {
+            std::unique_lock<std::mutex> lock(mutex);
+            if (next < results.size())
+                return results[next++];
+            wakeUp.wait(lock, [this]() { return stopped; });
+            return WAIT::STOPPED;
+        }
+        void Interrupt() override {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopped = true;
+            wakeUp.notify_all();
+        }
+    private:
+        std::mutex mutex;
+        std::condition_variable wakeUp;
+        std::vector<WAIT> results;
+        std::size_t next = 0;
+        bool stopped = false;
+    };
+
+    // Write a whole file at once
+    void WriteFile(const std::filesystem::path& path, std::string_view text) {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(text.data(), static_cast<std::streamsize>(text.size()));
+    }
+
+    // Wait until a condition holds or the timeout passed
+    template <class F>
+    bool WaitFor(std::chrono::milliseconds timeout, F&& condition) {
+        auto end = std::chrono::steady_clock::now() + timeout;
+        while (!condition()) {
+            if (std::chrono::steady_clock::now() >= end)
+                return false;
+            std::this_thread::sleep_for(1ms);
+        }
+        return true;
+    }
+}
+
+// A burst of notifications turns into one callback once the debounce times out
+TEST(FileWatcher_DebounceBurst) {
+    std::atomic<int> calls{0};
+    CCB_FileWatcher watcher;
+    std::vector<WAIT> script{WAIT::CHANGE, WAIT::CHANGE, WAIT::CHANGE, WAIT::TIMEOUT, WAIT::CHANGE, WAIT::TIMEOUT};
+    REQUIRE(watcher.Start(std::make_unique<FakeBackend>(script), "dir", 10ms, [&calls]() { calls++; }));
+    CHECK(WaitFor(2000ms, [&calls]() { return calls.load() == 2; }));
+    CHECK(watcher.IsRunning());
+    watcher.Stop();
+    CHECK(!watcher.IsRunning());
+    CHECK(calls.load() == 2);
+}
+
+// A stop or a failure during the debounce drops the pending callback and ends the watcher
+TEST(FileWatcher_StopAndFailure) {
+    std::atomic<int> calls{0};
+    CCB_FileWatcher watcher;
+    REQUIRE(watcher.Start(std::make_unique<FakeBackend>(std::vector<WAIT>{WAIT::CHANGE, WAIT::FAILED}), "dir", 10ms, [&calls]() { calls++; }));
+    CHECK(WaitFor(2000ms, [&watcher]() { return !watcher.IsRunning(); }));
+    CHECK(calls.load() == 0);
+    // Restarts after an error
+    REQUIRE(watcher.Start(std::make_unique<FakeBackend>(std::vector<WAIT>{}), "dir", 10ms, [&calls]() { calls++; }));
+    CHECK(!watcher.Start(std::make_unique<FakeBackend>(std::vector<WAIT>{}), "dir", 10ms, [&calls]() { calls++; }));
+    watcher.Stop();
+    CHECK(calls.load() == 0);
+    CHECK(!watcher.Start(nullptr, "dir", 10ms, [&calls]() { calls++; }));
+}
+
+// INI edit to parsed config through the platform backend, as the plugin reloads it
+// Touching the INI without changing it and writing other files in the directory don't reload
+TEST(FileWatcher_ConfigReloadLatency) {
+    if (!MakeFileWatchBackend()) {
+        std::printf("    no file watch backend on this platform\n");
+        return;
+    }
+    auto directory = std::filesystem::temp_directory_path() / "ccb_watch_test";
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directories(directory);
+    auto iniPath = (directory / "CCBCL.ini").string();
+    WriteFile(iniPath, "LOOT_RADIUS=600\n");
+    ConfigFileStamp stamp;
+    std::string text;
+    REQUIRE(ReadConfigFileIfChanged(iniPath, stamp, text));
+    std::mutex mutex;
+    Config config;
+    std::atomic<int> reloads{0};
+    std::atomic<int> callbacks{0};
+    std::chrono::steady_clock::time_point reloaded{};
+    CCB_FileWatcher watcher;
+    REQUIRE(watcher.Start(directory.string(), 50ms, [&]() {
+        callbacks++;
+        std::lock_guard<std::mutex> lock(mutex);
+        std::string changed;
+        if (!ReadConfigFileIfChanged(iniPath, stamp, changed))
+            return;
+        ParseConfigText(changed, config);
+        reloaded = std::chrono::steady_clock::now();
+        reloads++;
+    }));
+    auto written = std::chrono::steady_clock::now();
+    WriteFile(iniPath, "LOOT_RADIUS=1234.5\n");
+    REQUIRE(WaitFor(5000ms, [&reloads]() { return reloads.load() == 1; }));
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        CHECK(config.LOOT_RADIUS == 1234.5f);
+        auto latency = std::chrono::duration<double, std::milli>(reloaded - written).count();
+        std::printf("    edit to reload: %.1f ms (50 ms debounce)\n", latency);
+        // The debounce is the floor, the rest is notification and parse time
+        CHECK(latency >= 50.0);
+        CHECK(latency < 2000.0);
+    }
+    // Same content again and an unrelated file: notifications arrive but nothing is reloaded
+    int before = callbacks.load();
+    WriteFile(iniPath, "LOOT_RADIUS=1234.5\n");
+    WriteFile(directory / "other.txt", "x");
+    CHECK(WaitFor(5000ms, [&callbacks, before]() { return callbacks.load() > before; }));
+    std::this_thread::sleep_for(200ms);
+    CHECK(reloads.load() == 1);
+    watcher.Stop();
+    std::filesystem::remove_all(directory);
+}
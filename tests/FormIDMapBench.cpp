@@ -0,0 +1,60 @@
+#include <Bench.h>
+#include <Core.h>
+
+namespace
+{
+    // Synthetic epoch of count companions with scattered FormIDs
+    std::shared_ptr<const ActorTracking::Snapshot> MakeEpoch(std::vector<RE::Actor>& actors) {
+        auto snapshot = std::make_shared<ActorTracking::Snapshot>();
+        for (auto& actor : actors) {
+            TrackedActorData data{};
+            data.actor = &actor;
+            data.formID = actor.GetFormID();
+            snapshot->companions.push_back(data);
+        }
+        snapshot->BuildIndex();
+        return snapshot;
+    }
+}
+
+// Per-actor lookups of one update (every companion against the previous epoch): FormID index vs linear scan
+BENCH(FormIDMap_PreviousEpochLookup) {
+    for (std::size_t count : {10u, 100u, 1000u}) {
+        std::vector<RE::Actor> actors;
+        std::uint32_t formID = 0x0001F00D;
+        for (std::size_t i = 0; i < count; ++i) {
+            formID = formID * 2654435761u + 0x1000;
+            actors.emplace_back(formID | 1u);
+        }
+        auto prev = MakeEpoch(actors);
+        std::size_t iterations = Bench::Scale(std::max<std::size_t>(20000000 / (count * count), 20), 5);
+        char label[64];
+        std::snprintf(label, sizeof(label), "index, %zu actors (whole update)", count);
+        Bench::Measure(label, iterations, [&]() {
+            std::size_t found = 0;
+            for (auto& actor : actors)
+                found += prev->FindCompanion(&actor) != nullptr;
+            Bench::DoNotOptimize(found);
+        });
+        std::snprintf(label, sizeof(label), "linear scan, %zu actors (whole update)", count);
+        Bench::Measure(label, iterations, [&]() {
+            std::size_t found = 0;
+            for (auto& actor : actors) {
+                for (const auto& data : prev->companions) {
+                    if (data.actor == &actor) {
+                        found++;
+                        break;
+                    }
+                }
+            }
+            Bench::DoNotOptimize(found);
+        });
+        std::snprintf(label, sizeof(label), "BuildIndex, %zu actors", count);
+        Bench::Measure(label, Bench::Scale(std::max<std::size_t>(200000 / count, 10), 3), [&]() {
+            ActorTracking::Snapshot snapshot;
+            snapshot.companions = prev->companions;
+            snapshot.BuildIndex();
+            Bench::DoNotOptimize(snapshot.companionIndex.Size());
+        });
+    }
+}
@@ -0,0 +1,87 @@
+#include <Core.h>
+#include <Test.h>
+
+TEST(FormIDMap_InsertFindOverwrite) {
+    FormIDMap<std::uint32_t> map;
+    CHECK(map.Empty());
+    CHECK(map.Find(0x10) == nullptr);
+    CHECK(map.Insert(0x10, 1));
+    CHECK(map.Insert(0x20, 2));
+    CHECK(map.Size() == 2);
+    REQUIRE(map.Find(0x10) != nullptr);
+    CHECK(*map.Find(0x10) == 1);
+    CHECK(*map.Find(0x20) == 2);
+    CHECK(!map.Contains(0x30));
+    // Overwrite keeps the size
+    CHECK(map.Insert(0x10, 5));
+    CHECK(map.Size() == 2);
+    CHECK(*map.Find(0x10) == 5);
+    // Mutable access
+    *map.Find(0x20) = 7;
+    CHECK(*map.Find(0x20) == 7);
+}
+
+TEST(FormIDMap_ReservedKey) {
+    FormIDMap<int> map;
+    CHECK(!map.Insert(0, 1));
+    CHECK(map.Find(0) == nullptr);
+    CHECK(map.Empty());
+}
+
+// Growing past the load factor keeps every entry reachable, including colliding sequential FormIDs
+TEST(FormIDMap_RehashKeepsEntries) {
+    FormIDMap<std::uint32_t> map;
+    constexpr std::uint32_t count = 5000;
+    for (std::uint32_t i = 1; i <= count; ++i)
+        map.Insert(0x01000000 + i, i);
+    CHECK(map.Size() == count);
+    bool allFound = true;
+    for (std::uint32_t i = 1; i <= count; ++i) {
+        const auto* value = map.Find(0x01000000 + i);
+        allFound = allFound && value && *value == i;
+    }
+    CHECK(allFound);
+    CHECK(map.Find(0x01000000) == nullptr);
+    CHECK(map.Find(0x01000000 + count + 1) == nullptr);
+}
+
+// Agrees with std::unordered_map on a random workload
+TEST(FormIDMap_MatchesUnorderedMap) {
+    FormIDMap<std::uint32_t> map;
+    std::unordered_map<std::uint32_t, std::uint32_t> reference;
+    std::uint32_t seed = 12345;
+    auto next = [&seed]() {
+        seed = seed * 1664525u + 1013904223u;
+        return seed;
+    };
+    map.Reserve(100);
+    for (int i = 0; i < 20000; ++i) {
+        std::uint32_t key = next() % 4096;
+        std::uint32_t value = next();
+        bool inserted = map.Insert(key, value);
+        CHECK(inserted == (key != 0));
+        if (key != 0)
+            reference[key] = value;
+    }
+    CHECK(map.Size() == reference.size());
+    bool same = true;
+    for (std::uint32_t key = 0; key < 4096; ++key) {
+        auto it = reference.find(key);
+        const auto* value = map.Find(key);
+        same = same && (it == reference.end() ? value == nullptr : (value && *value == it->second));
+    }
+    CHECK(same);
+}
+
+TEST(FormIDMap_ClearAndReuse) {
+    FormIDMap<std::uint32_t> map;
+    map.Reserve(64);
+    for (std::uint32_t i = 1; i <= 40; ++i)
+        map.Insert(i, i);
+    map.Clear();
+    CHECK(map.Empty());
+    CHECK(map.Find(5) == nullptr);
+    map.Insert(5, 9);
+    CHECK(map.Size() == 1);
+    CHECK(*map.Find(5) == 9);
+}
@@ -0,0 +1,61 @@
+#include <Bench.h>
+#include <Synthetic.h>
+
+// Best gear of a 1k item inventory: one sweep (BuildIndex) vs the old loop over the whole inventory per slot plus one for weapons
+// BuildIndex also fills the counts, the last run adds the same counts to the old loops
+BENCH(InventoryIndex_GearSelection) {
+    using namespace InventoryCache;
+    for (std::size_t count : {100u, 1000u}) {
+        auto entries = Synthetic::MakeInventory(count, 17);
+        std::size_t iterations = Bench::Scale(std::max<std::size_t>(20000000 / count, 100), 10);
+        char label[80];
+        std::snprintf(label, sizeof(label), "single sweep BuildIndex, %zu items", count);
+        Index index;
+        Bench::Measure(label, iterations, [&]() {
+            BuildIndex(entries, index, GEAR_SCORE::VALUE);
+            Bench::DoNotOptimize(index.bestArmor);
+        });
+        // The old selection: one loop per slot and one for weapons, ranked by value
+        auto perSlotLoops = [&entries]() {
+            std::array<std::int32_t, ARMOR_SLOT_ORDER.size()> bestArmor{};
+            for (std::size_t slot = 0; slot < ARMOR_SLOT_ORDER.size(); ++slot) {
+                std::uint32_t slotMask = 1u << (ARMOR_SLOT_ORDER[slot] - 30);
+                float bestValue = 0.0f;
+                bestArmor[slot] = -1;
+                for (std::uint32_t i = 0; i < entries.size(); ++i) {
+                    const auto& entry = entries[i];
+                    if (entry.kind == ITEM_KIND::ARMOR && (entry.slotMask & slotMask) != 0 && entry.value > bestValue) {
+                        bestValue = entry.value;
+                        bestArmor[slot] = static_cast<std::int32_t>(i);
+                    }
+                }
+            }
+            std::int32_t bestWeapon = -1;
+            float bestValue = 0.0f;
+            for (std::uint32_t i = 0; i < entries.size(); ++i) {
+                if (entries[i].kind == ITEM_KIND::WEAPON && entries[i].value > bestValue) {
+                    bestValue = entries[i].value;
+                    bestWeapon = static_cast<std::int32_t>(i);
+                }
+            }
+            Bench::DoNotOptimize(bestArmor);
+            Bench::DoNotOptimize(bestWeapon);
+        };
+        std::snprintf(label, sizeof(label), "loop per slot + weapons, %zu items", count);
+        Bench::Measure(label, iterations, perSlotLoops);
+        std::snprintf(label, sizeof(label), "loop per slot + weapons + counts, %zu items", count);
+        FormIDMap<ItemCount> counts;
+        Bench::Measure(label, iterations, [&]() {
+            perSlotLoops();
+            counts.Clear();
+            counts.Reserve(entries.size());
+            for (std::uint32_t i = 0; i < entries.size(); ++i) {
+                if (auto* itemCount = counts.Find(entries[i].formID))
+                    itemCount->count += entries[i].count;
+                else
+                    counts.Insert(entries[i].formID, ItemCount{entries[i].count, i});
+            }
+            Bench::DoNotOptimize(counts.Size());
+        });
+    }
+}
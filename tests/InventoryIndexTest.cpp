@@ -0,0 +1,152 @@
+#include <Synthetic.h>
+#include <Test.h>
+
+using namespace InventoryCache;
+
+namespace
+{
+    // Biped bit of an armor slot
+    constexpr std::uint32_t Slot(int slot) {
+        return 1u << (slot - 30);
+    }
+
+    Entry Armor(std::uint32_t formID, std::uint32_t slotMask, float value, float rating = 0.0f, float weight = 1.0f) {
+        Entry entry{};
+        entry.formID = formID;
+        entry.kind = ITEM_KIND::ARMOR;
+        entry.slotMask = slotMask;
+        entry.value = value;
+        entry.rating = rating;
+        entry.weight = weight;
+        entry.count = 1;
+        return entry;
+    }
+
+    Entry Weapon(std::uint32_t formID, float value, float damage, float weight) {
+        Entry entry{};
+        entry.formID = formID;
+        entry.kind = ITEM_KIND::WEAPON;
+        entry.value = value;
+        entry.rating = damage;
+        entry.weight = weight;
+        entry.count = 1;
+        return entry;
+    }
+
+    Entry Item(std::uint32_t formID, std::int32_t count) {
+        Entry entry{};
+        entry.formID = formID;
+        entry.count = count;
+        return entry;
+    }
+}
+
+TEST(InventoryIndex_SlotTables) {
+    CHECK(ARMOR_SLOT_OF_BIT[33 - 30] == 0);
+    CHECK(ARMOR_SLOT_OF_BIT[30 - 30] == 1);
+    CHECK(ARMOR_SLOT_OF_BIT[45 - 30] == 6);
+    CHECK(ARMOR_SLOT_OF_BIT[31 - 30] == -1);
+    CHECK(ARMOR_SLOT_MASK == (Slot(30) | Slot(33) | Slot(41) | Slot(42) | Slot(43) | Slot(44) | Slot(45)));
+}
+
+// Stacks of the same form add up and point at the first entry, empty entries are skipped
+TEST(InventoryIndex_Counts) {
+    std::vector<Entry> entries{Item(0x0A, 3), Item(0, 5), Item(0x0B, 1), Item(0x0A, 2)};
+    Index index;
+    BuildIndex(entries, index, GEAR_SCORE::VALUE);
+    CHECK(GetCount(index, 0x0A) == 5);
+    CHECK(GetCount(index, 0x0B) == 1);
+    CHECK(GetCount(index, 0x0C) == 0);
+    REQUIRE(index.counts.Find(0x0A) != nullptr);
+    CHECK(index.counts.Find(0x0A)->entry == 0);
+    CHECK(index.bestWeapon == -1);
+    for (auto best : index.bestArmor)
+        CHECK(best == -1);
+    // A rebuild starts from scratch
+    entries = {Item(0x0B, 4)};
+    BuildIndex(entries, index, GEAR_SCORE::VALUE);
+    CHECK(GetCount(index, 0x0A) == 0);
+    CHECK(GetCount(index, 0x0B) == 4);
+}
+
+// The scoring mode picks the best weapon, the first entry wins ties
+TEST(InventoryIndex_BestWeapon) {
+    std::vector<Entry> entries{Weapon(1, 100.0f, 20.0f, 10.0f), Weapon(2, 50.0f, 30.0f, 30.0f), Weapon(3, 100.0f, 10.0f, 2.0f)};
+    Index index;
+    BuildIndex(entries, index, GEAR_SCORE::VALUE);
+    CHECK(index.bestWeapon == 0);
+    CHECK(index.scoring == GEAR_SCORE::VALUE);
+    BuildIndex(entries, index, GEAR_SCORE::RATING);
+    CHECK(index.bestWeapon == 1);
+    BuildIndex(entries, index, GEAR_SCORE::RATING_PER_WEIGHT);
+    CHECK(index.bestWeapon == 2);
+    // Weightless items are ranked by their rating
+    CHECK(ScoreGear(Weapon(4, 1.0f, 12.0f, 0.0f), GEAR_SCORE::RATING_PER_WEIGHT) == 12.0f);
+}
+
+// Best armor per slot, power armor pieces and all armor entries are indexed
+TEST(InventoryIndex_ArmorAndPowerArmor) {
+    auto piece = Armor(5, Slot(41), 10.0f);
+    piece.powerArmor = true;
+    std::vector<Entry> entries{Armor(1, Slot(33), 10.0f), Armor(2, Slot(33), 40.0f), Armor(3, Slot(30), 5.0f), piece, Weapon(9, 1.0f, 1.0f, 1.0f), Armor(6, Slot(31), 99.0f)};
+    Index index;
+    BuildIndex(entries, index, GEAR_SCORE::VALUE);
+    CHECK(index.bestArmor[0] == 1);
+    CHECK(index.bestArmor[1] == 2);
+    CHECK(index.bestArmor[2] == 3);
+    CHECK(index.bestArmor[3] == -1);
+    CHECK((index.powerArmorPieces == std::vector<std::uint32_t>{3}));
+    // Armor in slots the companions don't equip is still an armor entry
+    CHECK((index.armorEntries == std::vector<std::uint32_t>{0, 1, 2, 3, 5}));
+}
+
+// A multi-slot item chosen for an earlier slot covers the later slot, which stays empty
+TEST(InventoryIndex_MultiSlotClaimsSlots) {
+    std::vector<Entry> entries{Armor(1, Slot(33) | Slot(41), 100.0f), Armor(2, Slot(41), 50.0f), Armor(3, Slot(33), 20.0f)};
+    Index index;
+    BuildIndex(entries, index, GEAR_SCORE::VALUE);
+    CHECK(index.bestArmor[0] == 0);
+    CHECK(index.bestArmor[2] == -1);
+}
+
+// The best item of a later slot overlaps an earlier choice, the best one that doesn't overlap is taken
+TEST(InventoryIndex_MultiSlotFallback) {
+    std::vector<Entry> entries{Armor(1, Slot(33), 100.0f), Armor(2, Slot(33) | Slot(41), 80.0f), Armor(3, Slot(41), 10.0f), Armor(4, Slot(41) | Slot(42), 30.0f)};
+    Index index;
+    BuildIndex(entries, index, GEAR_SCORE::VALUE);
+    CHECK(index.bestArmor[0] == 0);
+    // Entry 1 is best for 41 but covers the body, entry 3 also covers 42
+    CHECK(index.bestArmor[2] == 3);
+    CHECK(index.bestArmor[3] == -1);
+    // Nothing left that fits
+    entries = {Armor(1, Slot(33), 100.0f), Armor(2, Slot(33) | Slot(41), 80.0f)};
+    BuildIndex(entries, index, GEAR_SCORE::VALUE);
+    CHECK(index.bestArmor[0] == 0);
+    CHECK(index.bestArmor[2] == -1);
+}
+
+// On random inventories the chosen armor never overlaps and every chosen item covers its slot
+TEST(InventoryIndex_NoOverlapOnSyntheticInventories) {
+    std::size_t overlaps = 0;
+    std::size_t chosen = 0;
+    for (std::uint32_t seed = 1; seed <= 50; ++seed) {
+        auto entries = Synthetic::MakeInventory(200, seed);
+        for (auto scoring : {GEAR_SCORE::VALUE, GEAR_SCORE::RATING, GEAR_SCORE::RATING_PER_WEIGHT}) {
+            Index index;
+            BuildIndex(entries, index, scoring);
+            std::uint32_t taken = 0;
+            for (std::size_t slot = 0; slot < ARMOR_SLOT_ORDER.size(); ++slot) {
+                auto best = index.bestArmor[slot];
+                if (best < 0)
+                    continue;
+                chosen++;
+                const auto& entry = entries[best];
+                if ((entry.slotMask & Slot(ARMOR_SLOT_ORDER[slot])) == 0 || (entry.slotMask & taken) != 0)
+                    overlaps++;
+                taken |= entry.slotMask;
+            }
+        }
+    }
+    CHECK(chosen > 0);
+    CHECK(overlaps == 0);
+}
@@ -0,0 +1,72 @@
+#include <Bench.h>
+#include <Synthetic.h>
+
+namespace
+{
+    enum class KIND : std::uint8_t {
+        CORPSE,
+        CONTAINER,
+        LOOSE_WEAPON,
+        OTHER
+    };
+    // Plain stand-in of a cell reference
+    struct Reference {
+        RE::NiPoint3 position;
+        KIND kind;
+    };
+
+    // Dense interior: references packed into a 3000 x 3000 unit area
+    std::vector<Reference> MakeCell(std::size_t count, std::uint32_t seed) {
+        Synthetic::Random random{seed};
+        std::vector<Reference> cell;
+        for (std::size_t i = 0; i < count; ++i) {
+            std::uint32_t roll = random.Next() % 10;
+            KIND kind = roll == 0 ? KIND::CORPSE : roll < 4 ? KIND::LOOSE_WEAPON : roll < 6 ? KIND::CONTAINER : KIND::OTHER;
+            cell.push_back({RE::NiPoint3(random.Uniform(-1500.0f, 1500.0f), random.Uniform(-1500.0f, 1500.0f), random.Uniform(0.0f, 300.0f)), kind});
+        }
+        return cell;
+    }
+}
+
+// Corpse check of every loose weapon in one loot tick: old cell walk per weapon vs the catalogue corpse grid
+// The old cost grows with references squared, the catalogue with references
+BENCH(LootCatalogue_CorpseNearScaling) {
+    constexpr float corpseRadius = 100.0f;
+    std::vector<std::size_t> counts = Bench::Quick() ? std::vector<std::size_t>{100, 1000} : std::vector<std::size_t>{100, 300, 1000, 3000, 10000};
+    for (std::size_t count : counts) {
+        auto cell = MakeCell(count, 21);
+        std::size_t iterations = Bench::Scale(std::max<std::size_t>(50000000 / (count * count), 3), 2);
+        char label[80];
+        std::snprintf(label, sizeof(label), "cell walk per weapon, %zu refs (tick)", count);
+        Bench::Measure(label, iterations, [&]() {
+            std::size_t nearCorpse = 0;
+            for (const auto& weapon : cell) {
+                if (weapon.kind != KIND::LOOSE_WEAPON)
+                    continue;
+                for (const auto& ref : cell) {
+                    if (ref.kind == KIND::CORPSE && ref.position.GetDistance(weapon.position) <= corpseRadius) {
+                        nearCorpse++;
+                        break;
+                    }
+                }
+            }
+            Bench::DoNotOptimize(nearCorpse);
+        });
+        std::snprintf(label, sizeof(label), "catalogue + corpse grid, %zu refs (tick)", count);
+        Bench::Measure(label, Bench::Scale(std::max<std::size_t>(5000000 / count, 3), 2), [&]() {
+            // One walk buckets the references and indexes the corpses, as LootCatalogue::Add and Build
+            std::array<std::vector<std::uint32_t>, 4> buckets;
+            SpatialGrid<std::uint32_t> corpseGrid(256.0f);
+            for (std::uint32_t i = 0; i < cell.size(); ++i) {
+                buckets[static_cast<std::size_t>(cell[i].kind)].push_back(i);
+                if (cell[i].kind == KIND::CORPSE)
+                    corpseGrid.Insert(cell[i].position, i);
+            }
+            corpseGrid.Build();
+            std::size_t nearCorpse = 0;
+            for (std::uint32_t i : buckets[static_cast<std::size_t>(KIND::LOOSE_WEAPON)])
+                nearCorpse += corpseGrid.AnyInRadius(cell[i].position, corpseRadius);
+            Bench::DoNotOptimize(nearCorpse);
+        });
+    }
+}
@@ -0,0 +1,87 @@
+#include <Bench.h>
+#include <Synthetic.h>
+
+namespace
+{
+    // Plain stand-in of a base form
+    struct Form {
+        std::uint32_t formID;
+        std::uint8_t formType;
+        std::int32_t value;
+        std::vector<std::uint32_t> keywords;
+    };
+
+    // Junk, ammo and aid always, weapons and armor by value, the rest never
+    CompiledConfig MakeCompiled() {
+        CompiledConfig compiled;
+        compiled.generation = 1;
+        compiled.lootEnabled = true;
+        compiled.lootRules[0] = LOOT_RULE::ALWAYS;
+        compiled.lootRules[1] = LOOT_RULE::ALWAYS;
+        compiled.lootRules[2] = LOOT_RULE::ALWAYS;
+        compiled.lootRules[3] = LOOT_RULE::VALUE;
+        compiled.lootRules[4] = LOOT_RULE::VALUE;
+        compiled.lootMinValue = 50;
+        compiled.lootMaxValue = 1000;
+        for (std::uint32_t i = 0; i < 8; ++i) {
+            compiled.lootKeywordAllow.Insert(0x00500000 + i, 1);
+            compiled.lootKeywordDeny.Insert(0x00500100 + i, 1);
+        }
+        return compiled;
+    }
+
+    // Base forms with a few keywords each, some of them in the allow and deny lists
+    std::vector<Form> MakeForms(std::size_t count, std::uint32_t seed) {
+        Synthetic::Random random{seed};
+        std::vector<Form> forms;
+        for (std::size_t i = 0; i < count; ++i) {
+            Form form{0x00400000 + static_cast<std::uint32_t>(i), static_cast<std::uint8_t>(random.Next() % 6), static_cast<std::int32_t>(random.Next() % 1500), {}};
+            for (std::uint32_t k = random.Next() % 5; k > 0; --k)
+                form.keywords.push_back(random.Chance(0.05f) ? 0x00500000 + (random.Next() % 0x200) : 0x00600000 + (random.Next() & 0xFFF));
+            forms.push_back(std::move(form));
+        }
+        return forms;
+    }
+
+    bool Decide(const Form& form, const CompiledConfig& compiled) {
+        return LootFilter::Evaluate(form.formType, form.value, static_cast<std::uint32_t>(form.keywords.size()), [&form](std::uint32_t i) { return form.keywords[i]; }, compiled);
+    }
+}
+
+// One loot tick over a synthetic 10k item world (items of 1000 base forms in the loaded containers)
+// Evaluating every item vs the verdict cache, cold (first tick after a config change) and warm
+BENCH(LootFilter_DecisionTable) {
+    auto compiled = MakeCompiled();
+    auto forms = MakeForms(1000, 3);
+    Synthetic::Random random{4};
+    std::vector<const Form*> items;
+    for (std::size_t i = 0; i < 10000; ++i)
+        items.push_back(&forms[random.Next() % forms.size()]);
+    std::size_t iterations = Bench::Scale(1000, 5);
+    Bench::Measure("evaluate every item, 10k items (tick)", iterations, [&]() {
+        std::size_t looted = 0;
+        for (const auto* form : items)
+            looted += Decide(*form, compiled);
+        Bench::DoNotOptimize(looted);
+    });
+    auto cached = [&compiled, &items](LootFilter::VerdictCache& cache) {
+        cache.Sync(compiled);
+        std::size_t looted = 0;
+        for (const auto* form : items) {
+            if (const bool* loot = cache.Find(form->formID, form)) {
+                looted += *loot;
+                continue;
+            }
+            bool loot = Decide(*form, compiled);
+            cache.Insert(form->formID, form, loot);
+            looted += loot;
+        }
+        Bench::DoNotOptimize(looted);
+    };
+    Bench::Measure("verdict cache cold, 10k items (tick)", iterations, [&]() {
+        LootFilter::VerdictCache cache;
+        cached(cache);
+    });
+    LootFilter::VerdictCache cache;
+    Bench::Measure("verdict cache warm, 10k items (tick)", iterations, [&]() { cached(cache); });
+}
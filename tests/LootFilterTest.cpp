@@ -0,0 +1,86 @@
+#include <Synthetic.h>
+#include <Test.h>
+
+using namespace LootFilter;
+
+namespace
+{
+    // Form types of the test, any index of the 256 entry table
+    constexpr std::uint8_t JUNK = 1;
+    constexpr std::uint8_t GEAR = 2;
+    constexpr std::uint8_t OTHER = 3;
+
+    CompiledConfig MakeCompiled() {
+        CompiledConfig compiled;
+        compiled.lootEnabled = true;
+        compiled.lootRules[JUNK] = LOOT_RULE::ALWAYS;
+        compiled.lootRules[GEAR] = LOOT_RULE::VALUE;
+        compiled.lootMinValue = 10;
+        compiled.lootMaxValue = 100;
+        return compiled;
+    }
+
+    bool Decide(std::uint8_t formType, std::int32_t value, std::vector<std::uint32_t> keywords, const CompiledConfig& compiled) {
+        return Evaluate(formType, value, static_cast<std::uint32_t>(keywords.size()), [&keywords](std::uint32_t i) { return keywords[i]; }, compiled);
+    }
+}
+
+TEST(LootFilter_FormTypeRules) {
+    auto compiled = MakeCompiled();
+    CHECK(Decide(JUNK, 0, {}, compiled));
+    CHECK(!Decide(OTHER, 50, {}, compiled));
+    // Value bounds are inclusive, items without a value are never looted
+    CHECK(Decide(GEAR, 10, {}, compiled));
+    CHECK(Decide(GEAR, 100, {}, compiled));
+    CHECK(!Decide(GEAR, 9, {}, compiled));
+    CHECK(!Decide(GEAR, 101, {}, compiled));
+    compiled.lootMinValue = 0;
+    CHECK(!Decide(GEAR, 0, {}, compiled));
+    // Nothing without LOOT_ENABLED
+    compiled.lootEnabled = false;
+    CHECK(!Decide(JUNK, 0, {}, compiled));
+}
+
+// Denied keywords win, allowed keywords loot whatever the form type table says
+TEST(LootFilter_Keywords) {
+    auto compiled = MakeCompiled();
+    compiled.lootKeywordAllow.Insert(0x100, 1);
+    compiled.lootKeywordDeny.Insert(0x200, 1);
+    CHECK(Decide(OTHER, 0, {0x100}, compiled));
+    CHECK(Decide(GEAR, 500, {0x300, 0x100}, compiled));
+    CHECK(!Decide(JUNK, 0, {0x200}, compiled));
+    CHECK(!Decide(OTHER, 0, {0x100, 0x200}, compiled));
+    CHECK(!Decide(OTHER, 0, {0x200, 0x100}, compiled));
+    // Missing keywords are skipped, other keywords fall back to the table
+    CHECK(Decide(OTHER, 0, {0, 0x100}, compiled));
+    CHECK(Decide(JUNK, 0, {0x300}, compiled));
+    CHECK(!Decide(OTHER, 0, {0x300}, compiled));
+}
+
+// Verdicts are dropped when the config changes and ignored when the FormID names another form
+TEST(LootFilter_VerdictCache) {
+    auto compiled = MakeCompiled();
+    compiled.generation = 1;
+    int formA = 0;
+    int formB = 0;
+    VerdictCache cache;
+    cache.Sync(compiled);
+    CHECK(cache.Find(0x10, &formA) == nullptr);
+    cache.Insert(0x10, &formA, true);
+    REQUIRE(cache.Find(0x10, &formA) != nullptr);
+    CHECK(*cache.Find(0x10, &formA));
+    CHECK(cache.Find(0x10, &formB) == nullptr);
+    // The same config keeps them
+    cache.Sync(compiled);
+    CHECK(cache.Size() == 1);
+    // The forms resolving or a new generation drops them
+    compiled.formsResolved = true;
+    cache.Sync(compiled);
+    CHECK(cache.Size() == 0);
+    cache.Insert(0x10, &formB, false);
+    REQUIRE(cache.Find(0x10, &formB) != nullptr);
+    CHECK(!*cache.Find(0x10, &formB));
+    compiled.generation = 2;
+    cache.Sync(compiled);
+    CHECK(cache.Find(0x10, &formB) == nullptr);
+}
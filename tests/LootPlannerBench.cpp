@@ -0,0 +1,65 @@
+#include <Bench.h>
+#include <Synthetic.h>
+
+using namespace LootPlanner;
+
+namespace
+{
+    // Companions and settlers spread over a loaded exterior area with references around them
+    Input MakeInput(std::size_t looters, std::size_t targets, std::uint32_t seed) {
+        Synthetic::Random random{seed};
+        Input input;
+        for (std::size_t i = 0; i < looters; ++i)
+            input.looters.push_back(Looter{nullptr, RE::NiPoint3(random.Uniform(-4000.0f, 4000.0f), random.Uniform(-4000.0f, 4000.0f), 0.0f), 200.0f, random.Chance(0.9f)});
+        for (std::uint32_t i = 0; i < targets; ++i)
+            input.targets.push_back(Target{RE::ObjectRefHandle(i), i, RE::NiPoint3(random.Uniform(-4000.0f, 4000.0f), random.Uniform(-4000.0f, 4000.0f), 0.0f), random.Uniform(0.0f, 5.0f), random.Chance(0.8f)});
+        return input;
+    }
+}
+
+// One loot pass: Build (scan below GRID_MIN_LOOTERS, grid above) vs checking every looter for every reference
+BENCH(LootPlanner_BuildScaling) {
+    constexpr Params params{500.0f, true};
+    std::vector<std::size_t> looterCounts = Bench::Quick() ? std::vector<std::size_t>{6, 200} : std::vector<std::size_t>{6, 60, 200};
+    for (std::size_t looters : looterCounts) {
+        for (std::size_t targets : {100u, 1000u, 10000u}) {
+            auto input = MakeInput(looters, targets, 8);
+            std::size_t iterations = Bench::Scale(std::max<std::size_t>(20000000 / (targets * looters), 20), 3);
+            char label[80];
+            std::snprintf(label, sizeof(label), "Build, %zu looters %zu refs", looters, targets);
+            Plan plan;
+            Bench::Measure(label, iterations, [&]() {
+                Build(input, params, plan);
+                Bench::DoNotOptimize(plan.transfers.data());
+            });
+            std::snprintf(label, sizeof(label), "brute force, %zu looters %zu refs", looters, targets);
+            Bench::Measure(label, iterations, [&]() {
+                plan.transfers.clear();
+                plan.ruledOut.clear();
+                plan.committed.assign(input.looters.size(), 0.0f);
+                float radiusSq = params.radius * params.radius;
+                for (std::uint32_t t = 0; t < input.targets.size(); ++t) {
+                    const auto& target = input.targets[t];
+                    std::uint32_t closest = NO_LOOTER;
+                    float closestDistanceSq = radiusSq;
+                    for (std::uint32_t l = 0; l < input.looters.size(); ++l) {
+                        float distanceSq = DistanceSquared(input.looters[l].position, target.position);
+                        if (distanceSq < closestDistanceSq && IsEligible(input.looters[l], plan.committed[l], target, params)) {
+                            closestDistanceSq = distanceSq;
+                            closest = l;
+                        }
+                    }
+                    if (closest == NO_LOOTER)
+                        continue;
+                    if (!target.lootable) {
+                        plan.ruledOut.push_back(t);
+                        continue;
+                    }
+                    plan.committed[closest] += target.weight;
+                    plan.transfers.push_back({t, closest});
+                }
+                Bench::DoNotOptimize(plan.transfers.data());
+            });
+        }
+    }
+}
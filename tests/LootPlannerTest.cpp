@@ -0,0 +1,147 @@
+#include <Synthetic.h>
+#include <Test.h>
+
+using namespace LootPlanner;
+
+namespace
+{
+    Looter MakeLooter(float x, bool active = true, float capacity = 100.0f) {
+        return Looter{nullptr, RE::NiPoint3(x, 0.0f, 0.0f), capacity, active};
+    }
+
+    Target MakeTarget(std::uint32_t formID, float x, bool lootable = true, float weight = 0.0f) {
+        return Target{RE::ObjectRefHandle(formID), formID, RE::NiPoint3(x, 0.0f, 0.0f), weight, lootable};
+    }
+
+    constexpr Params params{500.0f, true};
+}
+
+// Companions in combat (LOOT_COMBAT off) leave the references in range pending, nothing is planned or ruled out
+TEST(LootPlanner_InactiveLooterLeavesPending) {
+    Input input;
+    input.looters = {MakeLooter(0.0f, false)};
+    input.targets = {MakeTarget(1, 100.0f), MakeTarget(2, 100.0f, false)};
+    Plan plan;
+    Build(input, params, plan);
+    CHECK(plan.transfers.empty());
+    CHECK(plan.ruledOut.empty());
+    // Once out of combat the same references are evaluated
+    input.looters[0].active = true;
+    Build(input, params, plan);
+    REQUIRE(plan.transfers.size() == 1);
+    CHECK(plan.transfers[0].target == 0);
+    CHECK((plan.ruledOut == std::vector<std::uint32_t>{1}));
+}
+
+// Over-weight companions can't evaluate anything, not even references already ruled out
+TEST(LootPlanner_OverWeightLooterLeavesPending) {
+    Input input;
+    input.looters = {MakeLooter(0.0f, true, -5.0f)};
+    input.targets = {MakeTarget(1, 100.0f, true, 1.0f), MakeTarget(2, 100.0f, false)};
+    Plan plan;
+    Build(input, params, plan);
+    CHECK(plan.transfers.empty());
+    CHECK(plan.ruledOut.empty());
+    // Without the weight limit the capacity is ignored
+    Build(input, Params{500.0f, false}, plan);
+    CHECK(plan.transfers.size() == 1);
+    CHECK(plan.ruledOut.size() == 1);
+}
+
+// Out of range references stay pending, also with an eligible companion elsewhere
+TEST(LootPlanner_OutOfRange) {
+    Input input;
+    input.looters = {MakeLooter(0.0f)};
+    input.targets = {MakeTarget(1, 500.0f), MakeTarget(2, -900.0f, false)};
+    Plan plan;
+    Build(input, params, plan);
+    CHECK(plan.transfers.empty());
+    CHECK(plan.ruledOut.empty());
+}
+
+// The closest eligible companion wins, weight assigned in the pass counts against its capacity
+TEST(LootPlanner_ClosestEligibleLooter) {
+    Input input;
+    input.looters = {MakeLooter(0.0f, true, 10.0f), MakeLooter(200.0f, false), MakeLooter(-250.0f, true, 100.0f)};
+    input.targets = {MakeTarget(1, 150.0f, true, 6.0f), MakeTarget(2, 150.0f, true, 6.0f), MakeTarget(3, -125.0f, true, 1.0f)};
+    Plan plan;
+    Build(input, params, plan);
+    REQUIRE(plan.transfers.size() == 3);
+    // Looter 1 is closest but in combat
+    CHECK(plan.transfers[0].looter == 0);
+    // Looter 0 is full after the first target, the next eligible one takes it
+    CHECK(plan.transfers[1].looter == 2);
+    // Same distance to both, the first in the snapshot wins
+    CHECK(plan.transfers[2].looter == 0);
+    CHECK_NEAR(plan.committed[0], 7.0f, 1e-6);
+    CHECK_NEAR(plan.committed[2], 6.0f, 1e-6);
+}
+
+// Every transfer and ruled out reference has an eligible companion in radius, every other reference has none
+// Below and above GRID_MIN_LOOTERS, scanned and indexed looters
+TEST(LootPlanner_MatchesBruteForce) {
+    for (std::size_t looterCount : {std::size_t{12}, GRID_MIN_LOOTERS * 3}) {
+        Synthetic::Random random{31};
+        Input input;
+        for (std::size_t i = 0; i < looterCount; ++i)
+            input.looters.push_back(Looter{nullptr, RE::NiPoint3(random.Uniform(-3000.0f, 3000.0f), random.Uniform(-3000.0f, 3000.0f), 0.0f), random.Uniform(-20.0f, 200.0f), random.Chance(0.7f)});
+        for (std::uint32_t i = 0; i < 2000; ++i)
+            input.targets.push_back(Target{RE::ObjectRefHandle(i), i, RE::NiPoint3(random.Uniform(-3500.0f, 3500.0f), random.Uniform(-3500.0f, 3500.0f), 0.0f), random.Uniform(0.0f, 15.0f), random.Chance(0.8f)});
+        Plan plan;
+        Build(input, params, plan);
+        // Replay the pass with a plain loop over all looters
+        std::vector<float> committed(input.looters.size(), 0.0f);
+        std::vector<Transfer> transfers;
+        std::vector<std::uint32_t> ruledOut;
+        for (std::uint32_t t = 0; t < input.targets.size(); ++t) {
+            const auto& target = input.targets[t];
+            std::uint32_t closest = NO_LOOTER;
+            float closestDistanceSq = params.radius * params.radius;
+            for (std::uint32_t l = 0; l < input.looters.size(); ++l) {
+                float distanceSq = DistanceSquared(input.looters[l].position, target.position);
+                if (distanceSq < closestDistanceSq && IsEligible(input.looters[l], committed[l], target, params)) {
+                    closestDistanceSq = distanceSq;
+                    closest = l;
+                }
+            }
+            if (closest == NO_LOOTER)
+                continue;
+            if (!target.lootable) {
+                ruledOut.push_back(t);
+                continue;
+            }
+            committed[closest] += target.weight;
+            transfers.push_back({t, closest});
+        }
+        REQUIRE(plan.transfers.size() == transfers.size());
+        std::size_t mismatches = 0;
+        for (std::size_t i = 0; i < transfers.size(); ++i) {
+            if (plan.transfers[i].target != transfers[i].target || plan.transfers[i].looter != transfers[i].looter)
+                mismatches++;
+        }
+        CHECK(mismatches == 0);
+        CHECK(plan.ruledOut == ruledOut);
+        CHECK(!transfers.empty() && !ruledOut.empty());
+    }
+}
+
+// A plan reused across passes gives the same result as a fresh one, also after the radius changed
+TEST(LootPlanner_ReusedPlan) {
+    Input input;
+    input.looters = {MakeLooter(0.0f), MakeLooter(900.0f)};
+    // Enough looters far away to index them in the grid
+    while (input.looters.size() < GRID_MIN_LOOTERS)
+        input.looters.push_back(MakeLooter(100000.0f));
+    input.targets = {MakeTarget(1, 150.0f), MakeTarget(2, 700.0f), MakeTarget(3, -450.0f, false)};
+    Plan reused;
+    for (float radius : {500.0f, 500.0f, 200.0f, 1000.0f}) {
+        Plan fresh;
+        Build(input, Params{radius, false}, fresh);
+        Build(input, Params{radius, false}, reused);
+        CHECK(reused.grid.CellSize() == radius);
+        REQUIRE(reused.transfers.size() == fresh.transfers.size());
+        for (std::size_t i = 0; i < fresh.transfers.size(); ++i)
+            CHECK(reused.transfers[i].target == fresh.transfers[i].target && reused.transfers[i].looter == fresh.transfers[i].looter);
+        CHECK(reused.ruledOut == fresh.ruledOut);
+    }
+}
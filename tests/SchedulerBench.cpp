@@ -0,0 +1,49 @@
+#include <Bench.h>
+#include <Core.h>
+
+using namespace std::chrono_literals;
+
+namespace
+{
+    // Run jobs no-op jobs at interval for duration, print wake-up jitter and process CPU use
+    void RunJitter(const char* label, CCB_Scheduler::Clock::duration interval, std::size_t jobs, CCB_Scheduler::Clock::duration duration) {
+        CCB_Scheduler scheduler;
+        scheduler.Start();
+        std::vector<CCB_Scheduler::JobId> ids;
+        for (std::size_t i = 0; i < jobs; ++i)
+            ids.push_back(scheduler.AddJob("Bench", interval, []() {}));
+        double cpuStart = Bench::ProcessCpuSeconds();
+        auto wallStart = CCB_Scheduler::Clock::now();
+        std::this_thread::sleep_for(duration);
+        double cpu = Bench::ProcessCpuSeconds() - cpuStart;
+        double wall = std::chrono::duration<double>(CCB_Scheduler::Clock::now() - wallStart).count();
+        std::uint64_t ticks = 0;
+        std::uint64_t skipped = 0;
+        CCB_Scheduler::Clock::duration maxLateness{};
+        CCB_Scheduler::Clock::duration totalLateness{};
+        for (auto id : ids) {
+            auto stats = scheduler.GetStats(id);
+            if (!stats)
+                continue;
+            ticks += stats->ticks;
+            skipped += stats->skipped;
+            maxLateness = (std::max)(maxLateness, stats->maxLateness);
+            totalLateness += stats->totalLateness;
+        }
+        scheduler.Stop();
+        using us = std::chrono::duration<double, std::micro>;
+        std::printf("  %-28s ticks=%-6llu skipped=%-3llu jitter avg=%8.1f us max=%8.1f us  cpu=%6.3f%% of one core\n", label,
+            static_cast<unsigned long long>(ticks), static_cast<unsigned long long>(skipped),
+            ticks ? us(totalLateness).count() / static_cast<double>(ticks) : 0.0, us(maxLateness).count(),
+            wall > 0.0 ? 100.0 * cpu / wall : 0.0);
+    }
+}
+
+// Tick jitter and CPU cost of the shared worker at the movement (10 Hz) and a 100 Hz rate
+BENCH(Scheduler_Jitter) {
+    auto duration = Bench::Quick() ? CCB_Scheduler::Clock::duration(300ms) : CCB_Scheduler::Clock::duration(5s);
+    RunJitter("10 Hz, 1 job", 100ms, 1, duration);
+    RunJitter("100 Hz, 1 job", 10ms, 1, duration);
+    RunJitter("10 Hz, 8 jobs", 100ms, 8, duration);
+    RunJitter("100 Hz, 8 jobs", 10ms, 8, duration);
+}
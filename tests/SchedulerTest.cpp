@@ -0,0 +1,195 @@
+#include <Core.h>
+#include <Test.h>
+
+using namespace std::chrono_literals;
+
+namespace
+{
+    // Wait until pred is true or the timeout passed
+    template <class P>
+    bool WaitFor(P&& pred, std::chrono::milliseconds timeout) {
+        auto end = std::chrono::steady_clock::now() + timeout;
+        while (!pred()) {
+            if (std::chrono::steady_clock::now() > end)
+                return false;
+            std::this_thread::sleep_for(1ms);
+        }
+        return true;
+    }
+}
+
+TEST(Scheduler_SecondsToDuration) {
+    CHECK(SecondsToDuration(0.1f) > 99ms && SecondsToDuration(0.1f) < 101ms);
+    CHECK(SecondsToDuration(2.5f) > 2499ms && SecondsToDuration(2.5f) < 2501ms);
+    CHECK(SecondsToDuration(0.0f) == CCB_Scheduler::Clock::duration::zero());
+}
+
+TEST(Scheduler_RejectsInvalidJobs) {
+    CCB_Scheduler scheduler;
+    // Not running, a post would never run
+    CHECK(scheduler.Post("Post", []() {}) == CCB_Scheduler::INVALID_JOB);
+    scheduler.Start();
+    CHECK(scheduler.AddJob("Zero", 0ms, []() {}) == CCB_Scheduler::INVALID_JOB);
+    CHECK(scheduler.AddJob("Empty", 10ms, nullptr) == CCB_Scheduler::INVALID_JOB);
+    CHECK(!scheduler.GetStats(1234).has_value());
+    scheduler.Stop();
+}
+
+// A sub-second interval must tick, the old whole second timer truncated 0.1 to 0 and spun
+TEST(Scheduler_SubSecondInterval) {
+    CCB_Scheduler scheduler;
+    scheduler.Start();
+    std::atomic<int> ticks{0};
+    auto id = scheduler.AddJob("Tick", SecondsToDuration(0.01f), [&ticks]() { ticks++; });
+    CHECK(id != CCB_Scheduler::INVALID_JOB);
+    CHECK(WaitFor([&ticks]() { return ticks >= 5; }, 2000ms));
+    auto stats = scheduler.GetStats(id);
+    REQUIRE(stats.has_value());
+    CHECK(stats->ticks >= 4);
+    scheduler.Stop();
+}
+
+// Deadlines are absolute: a callback using most of its interval does not push the next ticks back
+TEST(Scheduler_NoDriftWithSlowCallback) {
+    constexpr auto interval = 20ms;
+    constexpr int count = 20;
+    CCB_Scheduler scheduler;
+    scheduler.Start();
+    std::vector<CCB_Scheduler::Clock::time_point> times;
+    std::mutex timesMutex;
+    auto start = CCB_Scheduler::Clock::now();
+    scheduler.AddJob("Slow", interval, [&]() {
+        {
+            std::lock_guard<std::mutex> lock(timesMutex);
+            times.push_back(CCB_Scheduler::Clock::now());
+        }
+        std::this_thread::sleep_for(12ms);
+    });
+    CHECK(WaitFor([&]() {
+        std::lock_guard<std::mutex> lock(timesMutex);
+        return times.size() >= static_cast<std::size_t>(count);
+    }, 5000ms));
+    scheduler.Stop();
+    std::lock_guard<std::mutex> lock(timesMutex);
+    REQUIRE(times.size() >= static_cast<std::size_t>(count));
+    // Relative rescheduling would need count * (20 + 12) ms, absolute deadlines stay near count * 20 ms
+    auto elapsed = times[count - 1] - start;
+    CHECK(elapsed < interval * count + 100ms);
+    CHECK(elapsed >= interval * count - 1ms);
+}
+
+// A job that fell behind skips the missed deadlines instead of running them back to back
+TEST(Scheduler_SkipsMissedTicks) {
+    constexpr auto interval = 10ms;
+    CCB_Scheduler scheduler;
+    scheduler.Start();
+    std::atomic<int> ticks{0};
+    auto id = scheduler.AddJob("Stall", interval, [&ticks]() {
+        if (ticks++ == 0)
+            std::this_thread::sleep_for(55ms);
+    });
+    CHECK(WaitFor([&ticks]() { return ticks >= 3; }, 2000ms));
+    auto stats = scheduler.GetStats(id);
+    scheduler.Stop();
+    REQUIRE(stats.has_value());
+    CHECK(stats->skipped >= 3);
+}
+
+TEST(Scheduler_PostRunsOnce) {
+    CCB_Scheduler scheduler;
+    scheduler.Start();
+    std::atomic<int> runs{0};
+    auto id = scheduler.Post("Once", [&runs]() { runs++; });
+    CHECK(id != CCB_Scheduler::INVALID_JOB);
+    CHECK(WaitFor([&runs]() { return runs == 1; }, 1000ms));
+    std::this_thread::sleep_for(30ms);
+    CHECK(runs == 1);
+    // One-shot jobs leave the list once run
+    CHECK(!scheduler.GetStats(id).has_value());
+    scheduler.Stop();
+}
+
+TEST(Scheduler_RemoveJobStopsTicks) {
+    CCB_Scheduler scheduler;
+    scheduler.Start();
+    std::atomic<int> ticks{0};
+    auto id = scheduler.AddJob("Tick", 5ms, [&ticks]() { ticks++; });
+    CHECK(WaitFor([&ticks]() { return ticks >= 2; }, 1000ms));
+    scheduler.RemoveJob(id);
+    // A callback already running may still finish
+    std::this_thread::sleep_for(10ms);
+    int after = ticks;
+    std::this_thread::sleep_for(40ms);
+    CHECK(ticks == after);
+    scheduler.Stop();
+}
+
+TEST(Scheduler_SetIntervalRebases) {
+    CCB_Scheduler scheduler;
+    scheduler.Start();
+    std::atomic<int> ticks{0};
+    auto id = scheduler.AddJob("Slow", 10s, [&ticks]() { ticks++; });
+    scheduler.SetInterval(id, 5ms);
+    CHECK(WaitFor([&ticks]() { return ticks >= 3; }, 1000ms));
+    scheduler.Stop();
+}
+
+// Restarting (game load) joins the old worker and drops the jobs
+TEST(Scheduler_RestartDropsJobs) {
+    CCB_Scheduler scheduler;
+    std::atomic<int> ticks{0};
+    for (int i = 0; i < 3; ++i) {
+        scheduler.Stop();
+        CHECK(!scheduler.IsRunning());
+        scheduler.Start();
+        CHECK(scheduler.IsRunning());
+        scheduler.AddJob("Tick", 5ms, [&ticks]() { ticks++; });
+    }
+    CHECK(WaitFor([&ticks]() { return ticks >= 2; }, 1000ms));
+    scheduler.Stop();
+    int after = ticks;
+    std::this_thread::sleep_for(20ms);
+    CHECK(ticks == after);
+}
+
+// A job stopping its own scheduler can't restart it, only one worker runs the jobs added after a restart
+TEST(Scheduler_StopFromJob) {
+    CCB_Scheduler scheduler;
+    scheduler.Start();
+    std::atomic<int> stopperRuns{0};
+    std::atomic<bool> restarted{false};
+    std::atomic<int> siblingRuns{0};
+    scheduler.AddJob("Stopper", 5ms, [&]() {
+        stopperRuns++;
+        scheduler.Stop();
+        scheduler.Start();
+        restarted = scheduler.IsRunning();
+    });
+    // Same interval, often in the same batch as the stopper, dropped with it
+    scheduler.AddJob("Sibling", 5ms, [&siblingRuns]() { siblingRuns++; });
+    CHECK(WaitFor([&stopperRuns]() { return stopperRuns > 0; }, 2000ms));
+    CHECK(WaitFor([&scheduler]() { return !scheduler.IsRunning(); }, 2000ms));
+    std::this_thread::sleep_for(30ms);
+    CHECK(stopperRuns == 1);
+    CHECK(!restarted);
+    int siblingBefore = siblingRuns;
+    std::this_thread::sleep_for(30ms);
+    CHECK(siblingRuns == siblingBefore);
+    // Restarted from outside, the old loop is joined first and one worker runs the new job
+    scheduler.Start();
+    CHECK(scheduler.IsRunning());
+    std::atomic<int> concurrent{0};
+    std::atomic<int> maxConcurrent{0};
+    std::atomic<int> ticks{0};
+    scheduler.AddJob("Tick", 2ms, [&]() {
+        int now = ++concurrent;
+        maxConcurrent = std::max(maxConcurrent.load(), now);
+        std::this_thread::sleep_for(1ms);
+        concurrent--;
+        ticks++;
+    });
+    CHECK(WaitFor([&ticks]() { return ticks >= 10; }, 2000ms));
+    CHECK(maxConcurrent == 1);
+    CHECK(stopperRuns == 1);
+    scheduler.Stop();
+}
@@ -0,0 +1,98 @@
+#include <Bench.h>
+#include <Core.h>
+
+using namespace std::chrono_literals;
+
+namespace
+{
+    // Tracked data of count synthetic companions
+    std::vector<TrackedActorData> MakeCompanions(std::vector<RE::Actor>& actors) {
+        std::vector<TrackedActorData> companions;
+        for (auto& actor : actors) {
+            TrackedActorData data{};
+            data.actor = &actor;
+            data.formID = actor.GetFormID();
+            companions.push_back(data);
+        }
+        return companions;
+    }
+
+    // Old reader path: copy the list under the mutex, then scan it
+    struct LockedLists {
+        std::mutex mutex;
+        std::vector<TrackedActorData> companions;
+    };
+
+    // Run one writer publishing every interval against readers doing lookups, prints lookups per second per reader
+    template <class Publish, class Read>
+    void RunContention(const char* label, std::size_t readers, std::chrono::milliseconds duration, Publish&& publish, Read&& read) {
+        std::atomic<bool> done{false};
+        std::atomic<std::uint64_t> lookups{0};
+        std::uint64_t publishes = 0;
+        std::vector<std::thread> threads;
+        for (std::size_t r = 0; r < readers; ++r) {
+            threads.emplace_back([&, r]() {
+                std::uint64_t local = 0;
+                std::size_t i = r;
+                while (!done) {
+                    Bench::DoNotOptimize(read(i++));
+                    local++;
+                }
+                lookups += local;
+            });
+        }
+        auto end = Bench::Clock::now() + duration;
+        while (Bench::Clock::now() < end) {
+            publish();
+            publishes++;
+            // The update job publishes a few times per second, 1 ms is already far above that
+            std::this_thread::sleep_for(1ms);
+        }
+        done = true;
+        for (auto& thread : threads)
+            thread.join();
+        double seconds = std::chrono::duration<double>(duration).count();
+        std::printf("  %-34s readers=%zu publishes=%-6llu %12.0f lookups/s per reader\n", label, readers,
+            static_cast<unsigned long long>(publishes), static_cast<double>(lookups.load()) / seconds / static_cast<double>(readers));
+    }
+}
+
+// One writer against N readers: RCU snapshot with the FormID index vs the old mutex, copy and linear scan
+BENCH(Snapshot_Contention) {
+    constexpr std::size_t actorCount = 32;
+    std::vector<RE::Actor> actors;
+    for (std::uint32_t i = 0; i < actorCount; ++i)
+        actors.emplace_back(0x1000 + i * 7);
+    auto companions = MakeCompanions(actors);
+    auto duration = Bench::Quick() ? 100ms : 1000ms;
+    std::vector<std::size_t> readerCounts = Bench::Quick() ? std::vector<std::size_t>{1, 2} : std::vector<std::size_t>{1, 2, 4, 8};
+    for (std::size_t readers : readerCounts) {
+        ActorTracking::ClearAll();
+        RunContention("snapshot (shared_ptr swap)", readers, duration,
+            [&]() { ActorTracking::PublishSnapshot(companions, {}, {}); },
+            [&](std::size_t i) {
+                auto snapshot = ActorTracking::GetSnapshot();
+                return snapshot->FindCompanion(&actors[i % actorCount]);
+            });
+        LockedLists locked;
+        RunContention("mutex + copy + scan (old)", readers, duration,
+            [&]() {
+                std::lock_guard<std::mutex> lock(locked.mutex);
+                locked.companions = companions;
+            },
+            [&](std::size_t i) {
+                std::vector<TrackedActorData> copy;
+                {
+                    std::lock_guard<std::mutex> lock(locked.mutex);
+                    copy = locked.companions;
+                }
+                RE::Actor* actor = &actors[i % actorCount];
+                for (const auto& data : copy) {
+                    if (data.actor == actor)
+                        return data.formID;
+                }
+                return 0u;
+            });
+    }
+    ActorTracking::ClearAll();
+}
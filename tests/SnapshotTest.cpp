@@ -0,0 +1,115 @@
+#include <Core.h>
+#include <Test.h>
+
+namespace
+{
+    // Tracked data of a synthetic actor
+    TrackedActorData Track(RE::Actor& actor, ENEMY_TIER tier = ENEMY_TIER::LOW) {
+        TrackedActorData data{};
+        data.actor = &actor;
+        data.formID = actor.GetFormID();
+        data.tier = tier;
+        return data;
+    }
+}
+
+TEST(Snapshot_PublishAdvancesEpoch) {
+    ActorTracking::ClearAll();
+    RE::Actor a(0x100);
+    RE::Actor b(0x200);
+    auto first = ActorTracking::GetSnapshot();
+    CHECK(first->epoch == 0);
+    ActorTracking::PublishSnapshot({Track(a)}, {}, {});
+    auto second = ActorTracking::GetSnapshot();
+    CHECK(second->epoch == 1);
+    CHECK(ActorTracking::GetPreviousSnapshot() == first);
+    ActorTracking::PublishSnapshot({Track(a), Track(b)}, {}, {});
+    CHECK(ActorTracking::GetSnapshot()->epoch == 2);
+    CHECK(ActorTracking::GetPreviousSnapshot() == second);
+    // A reader holding an old epoch keeps it alive and unchanged
+    CHECK(second->companions.size() == 1);
+    CHECK(second->FindCompanion(&b) == nullptr);
+    CHECK(ActorTracking::GetSnapshot()->FindCompanion(&b) != nullptr);
+    ActorTracking::ClearAll();
+    CHECK(ActorTracking::GetSnapshot()->epoch == 0);
+    CHECK(ActorTracking::GetSnapshot()->companions.empty());
+}
+
+TEST(Snapshot_FindByActorAndFormID) {
+    ActorTracking::ClearAll();
+    RE::Actor companion(0x1234);
+    RE::Actor enemy(0x5678);
+    RE::Actor neutral(0x9ABC);
+    RE::Actor unknown(0xDEF0);
+    ActorTracking::PublishSnapshot({Track(companion)}, {Track(enemy, ENEMY_TIER::HIGH)}, {Track(neutral)});
+    auto snapshot = ActorTracking::GetSnapshot();
+    const auto* found = snapshot->FindCompanion(&companion);
+    REQUIRE(found != nullptr);
+    CHECK(found->actor == &companion);
+    CHECK(snapshot->FindCompanion(0x1234, &companion) == found);
+    CHECK(snapshot->FindEnemy(&enemy) != nullptr);
+    CHECK(snapshot->FindNeutralNPC(&neutral) != nullptr);
+    // Lists are indexed separately
+    CHECK(snapshot->FindEnemy(&companion) == nullptr);
+    CHECK(snapshot->FindCompanion(&unknown) == nullptr);
+    CHECK(snapshot->FindCompanion(nullptr) == nullptr);
+    // A reused FormID on a different actor object is not a match
+    RE::Actor reused(0x1234);
+    CHECK(snapshot->FindCompanion(&reused) == nullptr);
+    ActorTracking::ClearAll();
+}
+
+TEST(Snapshot_EnemyTierCounts) {
+    ActorTracking::ClearAll();
+    std::vector<RE::Actor> actors;
+    for (std::uint32_t i = 1; i <= 6; ++i)
+        actors.emplace_back(i);
+    std::vector<TrackedActorData> enemies;
+    const ENEMY_TIER tiers[] = {ENEMY_TIER::LOW, ENEMY_TIER::HIGH, ENEMY_TIER::MEDIUM, ENEMY_TIER::HIGH, ENEMY_TIER::HIGH, ENEMY_TIER::LOW};
+    for (std::size_t i = 0; i < actors.size(); ++i)
+        enemies.push_back(Track(actors[i], tiers[i]));
+    ActorTracking::PublishSnapshot({}, std::move(enemies), {});
+    auto snapshot = ActorTracking::GetSnapshot();
+    CHECK(snapshot->enemyTierCounts[0] == 2);
+    CHECK(snapshot->enemyTierCounts[1] == 1);
+    CHECK(snapshot->enemyTierCounts[2] == 3);
+    ActorTracking::ClearAll();
+}
+
+// Readers racing the writer always see a complete epoch (list and index of the same publish)
+TEST(Snapshot_ReadersSeeConsistentEpochs) {
+    ActorTracking::ClearAll();
+    std::vector<RE::Actor> actors;
+    for (std::uint32_t i = 1; i <= 64; ++i)
+        actors.emplace_back(i);
+    std::atomic<bool> done{false};
+    std::atomic<int> torn{0};
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 3; ++r) {
+        readers.emplace_back([&]() {
+            while (!done) {
+                auto snapshot = ActorTracking::GetSnapshot();
+                // Epoch n holds the first n % 64 actors
+                std::size_t expected = snapshot->epoch % 64;
+                if (snapshot->companions.size() != expected || snapshot->companionIndex.Size() != expected)
+                    torn++;
+                for (std::size_t i = 0; i < expected; ++i) {
+                    if (snapshot->FindCompanion(&actors[i]) != &snapshot->companions[i])
+                        torn++;
+                }
+            }
+        });
+    }
+    for (std::uint64_t epoch = 1; epoch <= 2000; ++epoch) {
+        std::vector<TrackedActorData> companions;
+        for (std::size_t i = 0; i < epoch % 64; ++i)
+            companions.push_back(Track(actors[i]));
+        ActorTracking::PublishSnapshot(std::move(companions), {}, {});
+    }
+    done = true;
+    for (auto& reader : readers)
+        reader.join();
+    CHECK(torn == 0);
+    CHECK(ActorTracking::GetSnapshot()->epoch == 2000);
+    ActorTracking::ClearAll();
+}
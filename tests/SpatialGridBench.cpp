@@ -0,0 +1,56 @@
+#include <Bench.h>
+#include <Synthetic.h>
+
+namespace
+{
+    std::vector<RE::NiPoint3> MakePoints(std::size_t count, float halfSize, std::uint32_t seed) {
+        Synthetic::Random random{seed};
+        std::vector<RE::NiPoint3> points;
+        for (std::size_t i = 0; i < count; ++i)
+            points.emplace_back(random.Uniform(-halfSize, halfSize), random.Uniform(-halfSize, halfSize), random.Uniform(-300.0f, 300.0f));
+        return points;
+    }
+}
+
+// Radius queries over 50/500/5000 points in a loaded exterior area: grid vs the old sqrt distance loop
+BENCH(SpatialGrid_RadiusQuery) {
+    constexpr float halfSize = 6000.0f;
+    for (std::size_t count : {50u, 500u, 5000u}) {
+        auto points = MakePoints(count, halfSize, 5);
+        auto centers = MakePoints(256, halfSize, 6);
+        char label[80];
+        std::snprintf(label, sizeof(label), "grid build, %zu points", count);
+        Bench::Measure(label, Bench::Scale(std::max<std::size_t>(5000000 / count, 20), 3), [&]() {
+            SpatialGrid<std::uint32_t> grid;
+            grid.Reserve(points.size());
+            for (std::uint32_t i = 0; i < points.size(); ++i)
+                grid.Insert(points[i], i);
+            grid.Build();
+            Bench::DoNotOptimize(grid.Size());
+        });
+        SpatialGrid<std::uint32_t> grid;
+        for (std::uint32_t i = 0; i < points.size(); ++i)
+            grid.Insert(points[i], i);
+        grid.Build();
+        for (float radius : {100.0f, 1000.0f, 4000.0f}) {
+            std::size_t q = 0;
+            std::size_t iterations = Bench::Scale(std::max<std::size_t>(20000000 / count, 1000), 20);
+            std::snprintf(label, sizeof(label), "grid query r=%.0f, %zu points", radius, count);
+            Bench::Measure(label, iterations, [&]() {
+                std::uint32_t found = 0;
+                grid.ForEachInRadius(centers[q++ & 255], radius, [&found](std::uint32_t, float) { found++; });
+                Bench::DoNotOptimize(found);
+            });
+            std::snprintf(label, sizeof(label), "brute force r=%.0f, %zu points", radius, count);
+            Bench::Measure(label, iterations, [&]() {
+                const auto& center = centers[q++ & 255];
+                std::uint32_t found = 0;
+                for (const auto& point : points) {
+                    if (point.GetDistance(center) <= radius)
+                        found++;
+                }
+                Bench::DoNotOptimize(found);
+            });
+        }
+    }
+}
@@ -0,0 +1,95 @@
+#include <Synthetic.h>
+#include <Test.h>
+
+namespace
+{
+    // Random points in a square of the given half size
+    std::vector<RE::NiPoint3> MakePoints(std::size_t count, float halfSize, std::uint32_t seed) {
+        Synthetic::Random random{seed};
+        std::vector<RE::NiPoint3> points;
+        for (std::size_t i = 0; i < count; ++i)
+            points.emplace_back(random.Uniform(-halfSize, halfSize), random.Uniform(-halfSize, halfSize), random.Uniform(-300.0f, 300.0f));
+        return points;
+    }
+
+    // Indexes within radius, sorted
+    std::vector<std::uint32_t> BruteForce(const std::vector<RE::NiPoint3>& points, const RE::NiPoint3& center, float radius) {
+        std::vector<std::uint32_t> found;
+        for (std::uint32_t i = 0; i < points.size(); ++i) {
+            if (DistanceSquared(points[i], center) <= radius * radius)
+                found.push_back(i);
+        }
+        return found;
+    }
+
+    std::vector<std::uint32_t> Query(const SpatialGrid<std::uint32_t>& grid, const RE::NiPoint3& center, float radius) {
+        std::vector<std::uint32_t> found;
+        grid.ForEachInRadius(center, radius, [&found](std::uint32_t i, float) { found.push_back(i); });
+        std::sort(found.begin(), found.end());
+        return found;
+    }
+}
+
+TEST(SpatialGrid_DistanceSquared) {
+    CHECK(DistanceSquared(RE::NiPoint3(1.0f, 2.0f, 3.0f), RE::NiPoint3(4.0f, 6.0f, 3.0f)) == 25.0f);
+    CHECK(DistanceSquared(RE::NiPoint3(), RE::NiPoint3()) == 0.0f);
+}
+
+// Same result as a brute force loop for radii smaller and larger than a cell, across negative coordinates
+TEST(SpatialGrid_MatchesBruteForce) {
+    auto points = MakePoints(3000, 5000.0f, 11);
+    Synthetic::Random random{99};
+    for (float cellSize : {64.0f, 512.0f, 4096.0f}) {
+        SpatialGrid<std::uint32_t> grid(cellSize);
+        grid.Reserve(points.size());
+        for (std::uint32_t i = 0; i < points.size(); ++i)
+            grid.Insert(points[i], i);
+        grid.Build();
+        CHECK(grid.Size() == points.size());
+        std::size_t mismatches = 0;
+        for (int q = 0; q < 200; ++q) {
+            RE::NiPoint3 center(random.Uniform(-5500.0f, 5500.0f), random.Uniform(-5500.0f, 5500.0f), 0.0f);
+            float radius = random.Uniform(0.0f, 2500.0f);
+            if (Query(grid, center, radius) != BruteForce(points, center, radius))
+                mismatches++;
+            if (grid.AnyInRadius(center, radius) != !BruteForce(points, center, radius).empty())
+                mismatches++;
+        }
+        CHECK(mismatches == 0);
+    }
+}
+
+// The distance check is 3D, entries on a cell border and exactly on the radius are found
+TEST(SpatialGrid_EdgesAndHeight) {
+    SpatialGrid<std::uint32_t> grid(100.0f);
+    grid.Insert(RE::NiPoint3(100.0f, 0.0f, 0.0f), 1);
+    grid.Insert(RE::NiPoint3(-0.5f, 0.0f, 0.0f), 2);
+    grid.Insert(RE::NiPoint3(0.0f, 0.0f, 500.0f), 3);
+    grid.Build();
+    auto found = Query(grid, RE::NiPoint3(0.0f, 0.0f, 0.0f), 100.0f);
+    CHECK((found == std::vector<std::uint32_t>{1, 2}));
+    // Reported distance is squared
+    grid.ForEachInRadius(RE::NiPoint3(0.0f, 0.0f, 0.0f), 100.0f, [](std::uint32_t i, float distanceSq) {
+        if (i == 1)
+            CHECK(distanceSq == 10000.0f);
+    });
+    CHECK(grid.AnyInRadius(RE::NiPoint3(0.0f, 0.0f, 450.0f), 60.0f));
+    CHECK(!grid.AnyInRadius(RE::NiPoint3(0.0f, 0.0f, 0.0f), -1.0f));
+}
+
+TEST(SpatialGrid_BuildAndClear) {
+    SpatialGrid<std::uint32_t> grid(256.0f);
+    CHECK(grid.Empty());
+    CHECK(!grid.AnyInRadius(RE::NiPoint3(), 1000.0f));
+    grid.Insert(RE::NiPoint3(10.0f, 10.0f, 0.0f), 1);
+    // Not queryable until built
+    CHECK(!grid.AnyInRadius(RE::NiPoint3(), 1000.0f));
+    grid.Build();
+    CHECK(grid.AnyInRadius(RE::NiPoint3(), 1000.0f));
+    grid.Clear();
+    CHECK(grid.Empty());
+    CHECK(!grid.AnyInRadius(RE::NiPoint3(), 1000.0f));
+    grid.Insert(RE::NiPoint3(-10.0f, -10.0f, 0.0f), 2);
+    grid.Build();
+    CHECK((Query(grid, RE::NiPoint3(), 100.0f) == std::vector<std::uint32_t>{2}));
+}
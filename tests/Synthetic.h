@@ -0,0 +1,112 @@
+#pragma once
+#include <Core.h>
+
+// Deterministic synthetic inputs shared by the host tests and benchmarks
+namespace Synthetic
+{
+    // Small LCG, the same seed always gives the same world
+    struct Random {
+        std::uint32_t state;
+        std::uint32_t Next() {
+            state = state * 1664525u + 1013904223u;
+            return state >> 8;
+        }
+        float Uniform(float low, float high) { return low + (high - low) * static_cast<float>(Next() & 0xFFFF) / 65535.0f; }
+        bool Chance(float probability) { return Uniform(0.0f, 1.0f) < probability; }
+    };
+
+    // Actors and the gather buffer pointing at them
+    struct World {
+        std::vector<RE::Actor> actors;
+        ActorPipeline::GatherBuffer buffer;
+    };
+
+    // Default threat weights with an empty compiled config
+    inline ActorPipeline::AnalyzeParams DefaultParams() {
+        ActorPipeline::AnalyzeParams params{};
+        params.updateInterval = 3.0f;
+        params.fallbackEnemyMaxHealth = 1.0f;
+        params.weaponBonus = 1.0f;
+        params.legendaryBonus = 1.0f;
+        params.uniqueBonus = 1.0f;
+        params.healthBonus = 1.0f;
+        params.alertBonus = 1.0f;
+        params.compiled = std::make_shared<const CompiledConfig>();
+        return params;
+    }
+
+    // Random weapon of any class
+    inline ActorPipeline::GatherWeapon MakeWeapon(Random& random) {
+        ActorPipeline::GatherWeapon weapon{};
+        weapon.formID = 0x00100000 + (random.Next() & 0xFFFF);
+        weapon.value = random.Next() % 1400;
+        weapon.damage = random.Uniform(5.0f, 160.0f);
+        weapon.weaponClass = static_cast<ActorPipeline::WEAPON_CLASS>(random.Next() % 4);
+        return weapon;
+    }
+
+    // World of count live actors around the player: a few companions, mostly enemies and some neutral NPCs
+    inline void FillWorld(World& world, std::size_t count, std::uint32_t seed) {
+        Random random{seed};
+        world.actors.clear();
+        world.actors.reserve(count);
+        world.buffer.records.clear();
+        world.buffer.time = std::chrono::steady_clock::time_point(std::chrono::seconds(100));
+        for (std::size_t i = 0; i < count; ++i) {
+            world.actors.emplace_back(static_cast<std::uint32_t>(0x00010000 + i * 13));
+            ActorPipeline::GatherRecord record{};
+            record.actor = &world.actors.back();
+            record.formID = world.actors.back().GetFormID();
+            record.baseFormID = 0x00200000 + (random.Next() & 0xFFF);
+            record.objectFormID = record.baseFormID;
+            record.position = RE::NiPoint3(random.Uniform(-4000.0f, 4000.0f), random.Uniform(-4000.0f, 4000.0f), random.Uniform(-200.0f, 200.0f));
+            record.distanceToPlayer = record.position.GetDistance(RE::NiPoint3());
+            record.maxHealth = random.Uniform(50.0f, 1500.0f);
+            record.health = record.maxHealth * random.Uniform(0.1f, 1.0f);
+            record.hasNPC = random.Chance(0.95f);
+            record.isCompanion = i % 16 == 0;
+            record.isHostile = !record.isCompanion && random.Chance(0.7f);
+            record.isInCombat = random.Chance(0.5f);
+            record.isUnique = random.Chance(0.1f);
+            record.hasLegendTemplate = random.Chance(0.05f);
+            record.hasLegendaryName = random.Chance(0.05f);
+            record.stimpakKnown = record.isCompanion;
+            record.usesStimpak = random.Chance(0.8f);
+            record.weaponCount = random.Next() % (ActorPipeline::MAX_GATHER_WEAPONS + 1);
+            for (std::uint32_t w = 0; w < record.weaponCount; ++w)
+                record.weapons[w] = MakeWeapon(random);
+            world.buffer.records.push_back(record);
+        }
+    }
+
+    // Inventory of count entries: mostly misc items and ammo, some armor (a few multi-slot) and weapons
+    inline std::vector<InventoryCache::Entry> MakeInventory(std::size_t count, std::uint32_t seed) {
+        Random random{seed};
+        std::vector<InventoryCache::Entry> entries;
+        entries.reserve(count);
+        for (std::size_t i = 0; i < count; ++i) {
+            InventoryCache::Entry entry{};
+            entry.formID = 0x00300000 + static_cast<std::uint32_t>(i);
+            entry.count = 1 + static_cast<std::int32_t>(random.Next() % 20);
+            entry.value = random.Uniform(1.0f, 500.0f);
+            entry.weight = random.Uniform(0.0f, 20.0f);
+            std::uint32_t roll = random.Next() % 10;
+            if (roll < 3) {
+                entry.kind = InventoryCache::ITEM_KIND::ARMOR;
+                entry.rating = random.Uniform(1.0f, 60.0f);
+                // One of the equipped slots, sometimes an outfit covering two of them or an unequipped slot
+                entry.slotMask = 1u << (InventoryCache::ARMOR_SLOT_ORDER[random.Next() % InventoryCache::ARMOR_SLOT_ORDER.size()] - 30);
+                if (random.Chance(0.15f))
+                    entry.slotMask |= 1u << (InventoryCache::ARMOR_SLOT_ORDER[random.Next() % InventoryCache::ARMOR_SLOT_ORDER.size()] - 30);
+                if (random.Chance(0.1f))
+                    entry.slotMask = 1u << (random.Next() % 32);
+                entry.powerArmor = random.Chance(0.05f);
+            } else if (roll < 4) {
+                entry.kind = InventoryCache::ITEM_KIND::WEAPON;
+                entry.rating = random.Uniform(5.0f, 160.0f);
+            }
+            entries.push_back(entry);
+        }
+        return entries;
+    }
+}
@@ -0,0 +1,43 @@
+#pragma once
+#include <PCH.h>
+
+// Minimal test registry for the host tests (no framework, the tree has no third party test dependency)
+namespace Test
+{
+    using Function = void (*)();
+    struct Case {
+        const char* name;
+        Function function;
+    };
+    // All registered tests, in registration order
+    std::vector<Case>& Registry();
+    // Register a test, used by the TEST macro
+    bool Register(const char* name, Function function);
+    // Record a failed check of the running test
+    void Fail(const char* file, int line, const char* expression);
+}
+
+// Define and register a test case
+#define TEST(name)                                                   \
+    static void name();                                              \
+    static const bool name##_registered = Test::Register(#name, name); \
+    static void name()
+
+// Record a failure and keep going
+#define CHECK(expression)                                            \
+    do {                                                             \
+        if (!(expression))                                           \
+            Test::Fail(__FILE__, __LINE__, #expression);             \
+    } while (false)
+
+// Record a failure and leave the test
+#define REQUIRE(expression)                                          \
+    do {                                                             \
+        if (!(expression)) {                                         \
+            Test::Fail(__FILE__, __LINE__, #expression);             \
+            return;                                                  \
+        }                                                            \
+    } while (false)
+
+// Float comparison with an absolute tolerance
+#define CHECK_NEAR(a, b, tolerance) CHECK(std::fabs(static_cast<double>(a) - static_cast<double>(b)) <= (tolerance))
@@ -0,0 +1,41 @@
+#include <Test.h>
+
+namespace Test
+{
+    // Failures of the running test
+    static int g_failures = 0;
+
+    std::vector<Case>& Registry() {
+        static std::vector<Case> cases;
+        return cases;
+    }
+
+    bool Register(const char* name, Function function) {
+        Registry().push_back({name, function});
+        return true;
+    }
+
+    void Fail(const char* file, int line, const char* expression) {
+        std::printf("  %s:%d: CHECK(%s) failed\n", file, line, expression);
+        g_failures++;
+    }
+}
+
+// Run all tests, or only those whose name contains the first argument
+int main(int argc, char** argv) {
+    std::string_view filter = argc > 1 ? argv[1] : "";
+    int failed = 0;
+    int run = 0;
+    for (const auto& test : Test::Registry()) {
+        if (!filter.empty() && std::string_view(test.name).find(filter) == std::string_view::npos)
+            continue;
+        Test::g_failures = 0;
+        test.function();
+        run++;
+        std::printf("[%s] %s\n", Test::g_failures ? "FAIL" : " OK ", test.name);
+        if (Test::g_failures)
+            failed++;
+    }
+    std::printf("%d tests, %d failed\n", run, failed);
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,30 @@
+#include <Bench.h>
+#include <Synthetic.h>
+
+// Tier scoring of 10/100/1000 enemies: the batched kernel vs scoring one lane at a time
+BENCH(ThreatKernel_ScoreThreats) {
+    auto params = Synthetic::DefaultParams();
+    for (std::size_t count : {10u, 100u, 1000u}) {
+        Synthetic::World world;
+        Synthetic::FillWorld(world, count * 2, 4321);
+        ActorPipeline::ThreatFeatures features;
+        features.Reset(count);
+        for (const auto& record : world.buffer.records) {
+            if (features.count < count)
+                features.Add(record, 1500.0f);
+        }
+        std::size_t iterations = Bench::Scale(std::max<std::size_t>(20000000 / count, 1000), 20);
+        char label[64];
+        std::snprintf(label, sizeof(label), "ScoreThreats, %zu enemies", count);
+        Bench::Measure(label, iterations, [&]() {
+            ActorPipeline::ScoreThreats(features, params);
+            Bench::DoNotOptimize(features.tiers.data());
+        });
+        std::snprintf(label, sizeof(label), "ScoreThreatLane per lane, %zu enemies", count);
+        Bench::Measure(label, iterations, [&]() {
+            for (std::size_t lane = 0; lane < features.count; ++lane)
+                features.tiers[lane] = ActorPipeline::ScoreThreatLane(features, lane, params);
+            Bench::DoNotOptimize(features.tiers.data());
+        });
+    }
+}
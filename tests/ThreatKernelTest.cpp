@@ -0,0 +1,94 @@
+#include <Synthetic.h>
+#include <Test.h>
+
+using namespace ActorPipeline;
+
+namespace
+{
+    // Features of the first count hostile records of a synthetic world
+    void FillFeatures(ThreatFeatures& features, const Synthetic::World& world, std::size_t count) {
+        features.Reset(count);
+        for (const auto& record : world.buffer.records) {
+            if (features.count == count)
+                break;
+            if (record.isHostile)
+                features.Add(record, 1500.0f);
+        }
+    }
+
+    // Lanes where the kernel disagrees with scoring the lane on its own
+    std::size_t Mismatches(ThreatFeatures& features, const AnalyzeParams& params) {
+        ScoreThreats(features, params);
+        std::size_t mismatches = 0;
+        for (std::size_t lane = 0; lane < features.count; ++lane) {
+            if (features.tiers[lane] != ScoreThreatLane(features, lane, params))
+                mismatches++;
+        }
+        return mismatches;
+    }
+}
+
+// Lane counts that fill whole SIMD groups and ones that leave a partial group
+TEST(ThreatKernel_MatchesLaneScoring) {
+    Synthetic::World world;
+    Synthetic::FillWorld(world, 2000, 31);
+    auto params = Synthetic::DefaultParams();
+    ThreatFeatures features;
+    for (std::size_t count : {0u, 1u, 3u, 4u, 5u, 17u, 1000u}) {
+        FillFeatures(features, world, count);
+        REQUIRE(features.count == count);
+        CHECK(Mismatches(features, params) == 0);
+        // Padding lanes of the last group stay LOW
+        for (std::size_t lane = count; lane < features.tiers.size(); ++lane)
+            CHECK(features.tiers[lane] == ENEMY_TIER::LOW);
+    }
+}
+
+// Fractional weights make the per step truncation matter
+TEST(ThreatKernel_FractionalWeights) {
+    Synthetic::World world;
+    Synthetic::FillWorld(world, 2000, 32);
+    ThreatFeatures features;
+    FillFeatures(features, world, 1000);
+    auto params = Synthetic::DefaultParams();
+    for (float weight : {0.0f, 0.4f, 0.75f, 1.5f, 2.25f}) {
+        params.weaponBonus = weight;
+        params.legendaryBonus = 2.0f - weight;
+        params.healthBonus = weight * 0.5f;
+        params.uniqueBonus = 1.0f + weight;
+        params.alertBonus = weight;
+        CHECK(Mismatches(features, params) == 0);
+    }
+}
+
+// Values exactly on the value, damage and health thresholds, and lanes without an NPC base
+TEST(ThreatKernel_Thresholds) {
+    const float values[] = {0.0f, 249.0f, 250.0f, 499.0f, 500.0f, 999.0f, 1000.0f};
+    const float damages[] = {100.0f, 100.5f};
+    const float healths[] = {0.3f, 0.31f, 0.5f, 0.51f, 0.8f, 0.81f};
+    ThreatFeatures features;
+    std::size_t lanes = std::size(values) * std::size(damages) * std::size(healths) * 16;
+    features.Reset(lanes);
+    RE::Actor actor(1);
+    for (float value : values) {
+        for (float damage : damages) {
+            for (float health : healths) {
+                for (std::uint32_t flags = 0; flags < 16; ++flags) {
+                    GatherRecord record{};
+                    record.actor = &actor;
+                    record.hasNPC = flags & THREAT_FLAG::HAS_NPC;
+                    record.hasLegendaryName = flags & THREAT_FLAG::LEGENDARY_NAME;
+                    record.isUnique = flags & THREAT_FLAG::UNIQUE;
+                    record.isInCombat = flags & THREAT_FLAG::ALERTED;
+                    record.health = health;
+                    record.maxHealth = 1.0f;
+                    record.weaponCount = 1;
+                    record.weapons[0] = GatherWeapon{0x1234, static_cast<std::uint32_t>(value), damage, WEAPON_CLASS::RANGED};
+                    features.Add(record, 1.0f);
+                }
+            }
+        }
+    }
+    REQUIRE(features.count == lanes);
+    CHECK(Mismatches(features, Synthetic::DefaultParams()) == 0);
+}
@@ -0,0 +1,114 @@
+#pragma once
+// Host stand-in for the plugin PCH.h, found first on the include path of the test build
+// Only the standard headers and the few engine types the engine free code stores or compares
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+// --- Linux ---
+#if defined(__linux__)
+#include <cerrno>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+// Version
+using namespace std::literals;
+
+// --- SIMD ---
+// SSE2 is part of x64, other targets use the scalar kernels
+#if defined(_M_X64) || defined(__SSE2__)
+#define CCB_SSE2 1
+#include <emmintrin.h>
+#else
+#define CCB_SSE2 0
+#endif
+
+// --- Engine stand-ins ---
+// Just the members the engine free code uses, with the same names as CommonLibF4
+namespace RE
+{
+    class NiPoint3
+    {
+    public:
+        constexpr NiPoint3() noexcept = default;
+        constexpr NiPoint3(float a_x, float a_y, float a_z) noexcept : x(a_x), y(a_y), z(a_z) {}
+        NiPoint3 operator+(const NiPoint3& a_rhs) const noexcept { return NiPoint3(x + a_rhs.x, y + a_rhs.y, z + a_rhs.z); }
+        NiPoint3 operator-(const NiPoint3& a_rhs) const noexcept { return NiPoint3(x - a_rhs.x, y - a_rhs.y, z - a_rhs.z); }
+        NiPoint3 operator*(float a_scalar) const noexcept { return NiPoint3(x * a_scalar, y * a_scalar, z * a_scalar); }
+        float GetDistance(const NiPoint3& a_pt) const noexcept {
+            const float dx = a_pt.x - x;
+            const float dy = a_pt.y - y;
+            const float dz = a_pt.z - z;
+            return std::sqrt(dx * dx + dy * dy + dz * dz);
+        }
+        float x = 0.0f;
+        float y = 0.0f;
+        float z = 0.0f;
+    };
+    // Only stored as pointers
+    class BGSKeyword;
+    class BGSPerk;
+    class TESBoundObject;
+    // Actor value modifiers, same values as the engine
+    enum class ACTOR_VALUE_MODIFIER : std::int32_t
+    {
+        kPermanent = 0,
+        kTemporary = 1,
+        kDamage = 2
+    };
+    // Opaque actor value, the tests create them with a FormID
+    class ActorValueInfo
+    {
+    public:
+        explicit ActorValueInfo(std::uint32_t a_formID = 0) noexcept : formID(a_formID) {}
+        std::uint32_t GetFormID() const noexcept { return formID; }
+    private:
+        std::uint32_t formID;
+    };
+    // Opaque reference handle, only copied around by the planner
+    class ObjectRefHandle
+    {
+    public:
+        ObjectRefHandle() noexcept = default;
+        explicit ObjectRefHandle(std::uint32_t a_handle) noexcept : handle(a_handle) {}
+        std::uint32_t native_handle() const noexcept { return handle; }
+    private:
+        std::uint32_t handle = 0;
+    };
+    // Opaque actor handle, the tests create them with a FormID
+    class Actor
+    {
+    public:
+        explicit Actor(std::uint32_t a_formID = 0) noexcept : formID(a_formID) {}
+        std::uint32_t GetFormID() const noexcept { return formID; }
+    private:
+        std::uint32_t formID;
+    };
+}